@@ -0,0 +1,5 @@
+DELETE FROM `rbac_permissions` WHERE `id`=810;
+INSERT INTO `rbac_permissions` (`id`, `name`) VALUES (810, 'Command: debug lfgqueue');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=810;
+INSERT INTO `rbac_linked_permissions` (`id`, `linkedId`) VALUES (196, 810);
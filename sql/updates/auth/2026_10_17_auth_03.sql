@@ -0,0 +1,5 @@
+DELETE FROM `rbac_permissions` WHERE `id`=811;
+INSERT INTO `rbac_permissions` (`id`, `name`) VALUES (811, 'Command: debug procs');
+
+DELETE FROM `rbac_linked_permissions` WHERE `linkedId`=811;
+INSERT INTO `rbac_linked_permissions` (`id`, `linkedId`) VALUES (196, 811);
@@ -11,6 +11,7 @@
 #include "G3D/AABox.h"
 
 #include "Define.h"
+#include "RayPacket.h"
 
 #include <stdexcept>
 #include <vector>
@@ -103,6 +104,22 @@ class BIH
             delete[] dat.indices;
         }
         uint32 primCount() const { return objects.size(); }
+        const G3D::AABox& getBounds() const { return bounds; }
+
+        /** Moves the clip planes to where the primitives are now, keeping the hierarchy.
+            getBounds returns false for primitives that are gone, they take up no space.
+            Much cheaper than build(), but the farther the primitives move from where they
+            were built the more of the tree a ray has to visit.
+        */
+        template<class BoundsFunc, class PrimArray>
+        void refit(const PrimArray &primitives, BoundsFunc &getBounds)
+        {
+            AABound box;
+            refitNode(0, primitives, getBounds, box);
+            // nothing left, no ray gets past the clip planes anyway
+            if (box.lo.x <= box.hi.x)
+                bounds = G3D::AABox(box.lo, box.hi);
+        }
 
         template<typename RayCallback>
         void intersectRay(const G3D::Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst=false) const
@@ -243,6 +260,121 @@ class BIH
             }
         }
 
+        /** Traces the lanes of a packet together, for occlusion tests only.
+            The callback returns which of the given lanes an object blocks, those are
+            removed from lanes. Returns once every lane is blocked or the tree is done.
+        */
+        template<typename PacketCallback>
+        void intersectPacket(const RayPacket &packet, uint32 &lanes, PacketCallback& intersectCallback) const
+        {
+            using namespace RayLanes;
+
+            Float4 intervalMin, intervalMax;
+            uint32 mask = packet.clipBox(bounds, lanes, intervalMin, intervalMax);
+            if (!mask)
+                return;
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true) {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = tn & (1 << 29);
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, the left child ends at the first plane and the right one starts at the second
+                            Float4 org = load(packet.org[axis]);
+                            Float4 invDir = load(packet.invDir[axis]);
+                            Mask4 negative = less(invDir, splat(0.f));
+                            Float4 tl = mul(sub(splat(intBitsToFloat(tree[node + 1])), org), invDir);
+                            Float4 tr = mul(sub(splat(intBitsToFloat(tree[node + 2])), org), invDir);
+                            Float4 leftMin = select(negative, max(tl, intervalMin), intervalMin);
+                            Float4 leftMax = select(negative, intervalMax, min(tl, intervalMax));
+                            Float4 rightMin = select(negative, intervalMin, max(tr, intervalMin));
+                            Float4 rightMax = select(negative, min(tr, intervalMax), intervalMax);
+                            uint32 leftMask = mask & bits(lessEqual(leftMin, leftMax));
+                            uint32 rightMask = mask & bits(lessEqual(rightMin, rightMax));
+                            // all lanes pass between clip zones
+                            if (!leftMask && !rightMask)
+                                break;
+                            if (rightMask)
+                            {
+                                // lanes pass through the right node only
+                                if (!leftMask)
+                                {
+                                    node = offset + 3;
+                                    mask = rightMask;
+                                    intervalMin = rightMin;
+                                    intervalMax = rightMax;
+                                    continue;
+                                }
+                                // push back right node
+                                stack[stackPos].node = offset + 3;
+                                stack[stackPos].mask = rightMask;
+                                stack[stackPos].tnear = rightMin;
+                                stack[stackPos].tfar = rightMax;
+                                stackPos++;
+                            }
+                            node = offset;
+                            mask = leftMask;
+                            intervalMin = leftMin;
+                            intervalMax = leftMax;
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = tree[node + 1];
+                            while (n > 0) {
+                                lanes &= ~intersectCallback(packet, objects[offset], mask);
+                                if (!lanes)
+                                    return;
+                                mask &= lanes;
+                                if (!mask)
+                                    break;
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis>2)
+                            return; // should not happen
+                        clipSlab(load(packet.org[axis]), load(packet.invDir[axis]), intBitsToFloat(tree[node + 1]), intBitsToFloat(tree[node + 2]), intervalMin, intervalMax);
+                        node = offset;
+                        mask &= bits(lessEqual(intervalMin, intervalMax));
+                        if (!mask)
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return;
+                    // move back up the stack, lanes blocked meanwhile are dropped
+                    stackPos--;
+                    mask = stack[stackPos].mask & lanes;
+                    if (!mask)
+                        continue;
+                    node = stack[stackPos].node;
+                    intervalMin = stack[stackPos].tnear;
+                    intervalMax = stack[stackPos].tfar;
+                    break;
+                } while (true);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const G3D::Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -342,6 +474,13 @@ class BIH
             float tnear;
             float tfar;
         };
+        struct PacketStackNode
+        {
+            uint32 node;
+            uint32 mask;
+            RayLanes::Float4 tnear;
+            RayLanes::Float4 tfar;
+        };
 
         class BuildStats
         {
@@ -381,6 +520,48 @@ class BIH
             tempTree[nodeIndex + 1] = right - left + 1;
         }
 
+        template<class BoundsFunc, class PrimArray>
+        void refitNode(uint32 node, const PrimArray &primitives, BoundsFunc &getBounds, AABound &box)
+        {
+            uint32 tn = tree[node];
+            uint32 axis = (tn & (3 << 30)) >> 30;
+            bool BVH2 = tn & (1 << 29);
+            uint32 offset = tn & ~(7 << 29);
+
+            // empty, planes clipping to it are never crossed
+            box.lo = G3D::Vector3(G3D::inf(), G3D::inf(), G3D::inf());
+            box.hi = -box.lo;
+
+            if (BVH2)
+            {
+                refitNode(offset, primitives, getBounds, box);
+                tree[node + 1] = floatToRawIntBits(box.lo[axis]);
+                tree[node + 2] = floatToRawIntBits(box.hi[axis]);
+            }
+            else if (axis < 3)
+            {
+                // the left child ends at the first plane and the right one starts at the second
+                AABound right;
+                refitNode(offset, primitives, getBounds, box);
+                refitNode(offset + 3, primitives, getBounds, right);
+                tree[node + 1] = floatToRawIntBits(box.hi[axis]);
+                tree[node + 2] = floatToRawIntBits(right.lo[axis]);
+                box.lo = box.lo.min(right.lo);
+                box.hi = box.hi.max(right.hi);
+            }
+            else
+            {
+                G3D::AABox primBound;
+                for (uint32 i = 0; i < tree[node + 1]; ++i)
+                {
+                    if (!getBounds(primitives[objects[offset + i]], primBound))
+                        continue;
+                    box.lo = box.lo.min(primBound.low());
+                    box.hi = box.hi.max(primBound.high());
+                }
+            }
+        }
+
         void subdivide(int left, int right, std::vector<uint32> &tempTree, buildData &dat, AABound &gridBox, AABound &nodeBox, int nodeIndex, int depth, BuildStats &stats);
 };
 
@@ -8,7 +8,6 @@
 
 #include "G3D/Table.h"
 #include "G3D/Array.h"
-#include "G3D/Set.h"
 #include "BoundingIntervalHierarchy.h"
 
 
@@ -44,52 +43,113 @@ class BIHWrap
         }
     };
 
+    /// bounds of the objects in the tree, removed ones leave a NULL behind
+    struct RefitBounds
+    {
+        bool operator() (const T* obj, G3D::AABox& out) const
+        {
+            if (!obj)
+                return false;
+            BoundsFunc::getBounds2(obj, out);
+            return true;
+        }
+    };
+
     typedef G3D::Array<const T*> ObjArray;
 
+    static constexpr int MAX_PENDING = 8;                   // inserted objects tested one by one before the tree is rebuilt
+    static constexpr float MAX_GROWTH = 2.0f;               // refitted bounds this many times the built ones are rebuilt
+
+    static float getExtent(const G3D::AABox& box)
+    {
+        G3D::Vector3 extent = box.extent();
+        return extent.x + extent.y + extent.z;
+    }
+
     BIH m_tree;
-    ObjArray m_objects;
+    ObjArray m_objects;                                     // indexed by the tree, NULL where an object was removed
     G3D::Table<const T*, uint32> m_obj2Idx;
-    G3D::Set<const T*> m_objects_to_push;
-    int unbalanced_times;
+    ObjArray m_pending;                                     // inserted since the tree was built
+    int m_removed;
+    float m_builtExtent;
+
+    void rebuild()
+    {
+        ObjArray objects;
+        for (int i = 0; i < m_objects.size(); ++i)
+            if (m_objects[i])
+                objects.append(m_objects[i]);
+        objects.append(m_pending);
+
+        m_objects = objects;
+        m_pending.fastClear();
+        m_removed = 0;
+
+        m_obj2Idx.clear();
+        for (int i = 0; i < m_objects.size(); ++i)
+            m_obj2Idx.set(m_objects[i], i);
+
+        m_tree.build(m_objects, BoundsFunc::getBounds2);
+        m_builtExtent = getExtent(m_tree.getBounds());
+    }
 
 public:
-    BIHWrap() : unbalanced_times(0) { }
+    BIHWrap() : m_removed(0), m_builtExtent(0.f) { }
 
     void insert(const T& obj)
     {
-        ++unbalanced_times;
-        m_objects_to_push.insert(&obj);
+        m_pending.append(&obj);
+        if (m_pending.size() > MAX_PENDING)
+            rebuild();
     }
 
     void remove(const T& obj)
     {
-        ++unbalanced_times;
         uint32 Idx = 0;
         const T * temp;
         if (m_obj2Idx.getRemove(&obj, temp, Idx))
+        {
             m_objects[Idx] = NULL;
+            // the tree only gets rebuilt once half of it is holes
+            if (++m_removed * 2 > m_objects.size())
+                rebuild();
+        }
         else
-            m_objects_to_push.remove(&obj);
+        {
+            int pending = m_pending.findIndex(&obj);
+            if (pending >= 0)
+                m_pending.fastRemove(pending);
+        }
     }
 
-    void balance()
+    /// the object moved within the area of this tree, its new bounds are taken over
+    void relocate(const T& obj)
     {
-        if (unbalanced_times == 0)
+        // pending objects are always tested where they are
+        if (!m_obj2Idx.containsKey(&obj))
             return;
 
-        unbalanced_times = 0;
-        m_objects.fastClear();
-        m_obj2Idx.getKeys(m_objects);
-        m_objects_to_push.getMembers(m_objects);
-        //assert that m_obj2Idx has all the keys
+        RefitBounds getBounds;
+        m_tree.refit(m_objects, getBounds);
+        if (getExtent(m_tree.getBounds()) > MAX_GROWTH * m_builtExtent)
+            rebuild();
+    }
 
-        m_tree.build(m_objects, BoundsFunc::getBounds2);
+    /// takes the objects inserted and removed since the last build into the tree
+    void balance()
+    {
+        if (m_pending.size() || m_removed)
+            rebuild();
     }
 
     template<typename RayCallback>
     void intersectRay(const G3D::Ray& ray, RayCallback& intersectCallback, float& maxDist)
     {
-        balance();
+        // tested first, a miss must not clear a hit the tree reported
+        for (int i = 0; i < m_pending.size(); ++i)
+            if (intersectCallback(ray, *m_pending[i], maxDist))
+                return;
+
         MDLCallback<RayCallback> temp_cb(intersectCallback, m_objects.getCArray(), m_objects.size());
         m_tree.intersectRay(ray, temp_cb, maxDist, true);
     }
@@ -97,7 +157,9 @@ public:
     template<typename IsectCallback>
     void intersectPoint(const G3D::Vector3& point, IsectCallback& intersectCallback)
     {
-        balance();
+        for (int i = 0; i < m_pending.size(); ++i)
+            intersectCallback(point, *m_pending[i]);
+
         MDLCallback<IsectCallback> callback(intersectCallback, m_objects.getCArray(), m_objects.size());
         m_tree.intersectPoint(point, callback);
     }
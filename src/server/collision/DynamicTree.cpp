@@ -18,6 +18,8 @@
 #include <G3D/Ray.h>
 #include <G3D/Vector3.h>
 
+#include <chrono>
+
 using VMAP::ModelInstance;
 
 namespace {
@@ -70,6 +72,13 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
         ++unbalanced_times;
     }
 
+    void relocate(const Model& mdl)
+    {
+        // within a cell the tree is only refitted, nothing is left to balance
+        if (base::relocate(mdl))
+            ++unbalanced_times;
+    }
+
     void balance()
     {
         base::balance();
@@ -111,6 +120,18 @@ void DynamicMapTree::remove(const GameObjectModel& mdl)
     impl->remove(mdl);
 }
 
+void DynamicMapTree::relocate(const GameObjectModel& mdl)
+{
+    impl->relocate(mdl);
+}
+
+void DynamicMapTree::getModels(std::vector<const GameObjectModel*>& models) const
+{
+    G3D::Array<const GameObjectModel*> keys;
+    impl->memberTable.getKeys(keys);
+    models.assign(keys.getCArray(), keys.getCArray() + keys.size());
+}
+
 bool DynamicMapTree::contains(const GameObjectModel& mdl) const
 {
     return impl->contains(mdl);
@@ -131,6 +152,51 @@ void DynamicMapTree::update(uint32 t_diff)
     impl->update(t_diff);
 }
 
+void DynamicMapTree::benchmark(std::vector<const GameObjectModel*> const& models, uint32 iterations, DynamicTreeBenchmark& result)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // the cells as the grid assigns them
+    G3D::Table<int, G3D::Array<const GameObjectModel*> > cells;
+    for (const GameObjectModel* model : models)
+    {
+        ParentTree::Cell cell = ParentTree::Cell::ComputeCell(model->getPosition().x, model->getPosition().y);
+        if (cell.isValid())
+            cells.getCreate(cell.x * ParentTree::CELL_NUMBER + cell.y).append(model);
+    }
+
+    G3D::Array<int> cellKeys;
+    cells.getKeys(cellKeys);
+
+    // the old BIHWrap::balance() built the whole tree of every cell a model moved in
+    BIH tree;
+    Clock::time_point start = Clock::now();
+    for (uint32 n = 0; n < iterations; ++n)
+        for (int i = 0; i < cellKeys.size(); ++i)
+            tree.build(cells[cellKeys[i]], BoundsTrait<GameObjectModel>::getBounds2);
+    result.RebuildTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    DynamicMapTree dynTree;
+    for (const GameObjectModel* model : models)
+        dynTree.insert(*model);
+    dynTree.balance();
+
+    result.RefitTime = 0;
+    result.UpdateTime = 0;
+    for (uint32 n = 0; n < iterations; ++n)
+    {
+        start = Clock::now();
+        for (const GameObjectModel* model : models)
+            dynTree.relocate(*model);
+        Clock::time_point moved = Clock::now();
+
+        // a full period, so the tree checks its balance every round
+        dynTree.update(CHECK_TREE_PERIOD);
+        result.RefitTime += std::chrono::duration_cast<std::chrono::microseconds>(moved - start).count();
+        result.UpdateTime += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - moved).count();
+    }
+}
+
 struct DynamicTreeIntersectionCallback
 {
     bool did_hit;
@@ -138,8 +204,11 @@ struct DynamicTreeIntersectionCallback
     explicit DynamicTreeIntersectionCallback(uint32 phasemask) : did_hit(false), phase_mask(phasemask) { }
     bool operator()(const G3D::Ray& r, const GameObjectModel& obj, float& distance)
     {
-        did_hit = obj.intersectRay(r, distance, true, phase_mask);
-        return did_hit;
+        // objects of later cells must not clear a hit
+        bool hit = obj.intersectRay(r, distance, true, phase_mask);
+        if (hit)
+            did_hit = true;
+        return hit;
     }
     bool didHit() const { return did_hit;}
 };
@@ -9,6 +9,8 @@
 
 #include "Define.h"
 
+#include <vector>
+
 namespace G3D
 {
     class Ray;
@@ -18,6 +20,13 @@ namespace G3D
 class GameObjectModel;
 struct DynTreeImpl;
 
+struct DynamicTreeBenchmark
+{
+    uint64 RebuildTime;     // us, every cell holding a model rebuilt, as each move did before cells were refitted
+    uint64 RefitTime;       // us, relocate() of every model
+    uint64 UpdateTime;      // us, update() of the tree after each round of moves
+};
+
 class DynamicMapTree
 {
     DynTreeImpl *impl;
@@ -40,11 +49,17 @@ public:
 
     void insert(const GameObjectModel&);
     void remove(const GameObjectModel&);
+    // the model moved, its cell is refitted instead of rebuilt
+    void relocate(const GameObjectModel&);
     bool contains(const GameObjectModel&) const;
     int size() const;
+    void getModels(std::vector<const GameObjectModel*>& models) const;
 
     void balance();
     void update(uint32 diff);
+
+    // moves the models in place iterations times, in trees of its own; the models are only read
+    static void benchmark(std::vector<const GameObjectModel*> const& models, uint32 iterations, DynamicTreeBenchmark& result);
 };
 
 #endif // _DYNTREE_H
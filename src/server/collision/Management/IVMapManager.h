@@ -9,6 +9,11 @@
 #include <string>
 #include "Define.h"
 
+namespace G3D
+{
+    class Vector3;
+}
+
 //===========================================================
 
 /**
@@ -48,6 +53,10 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+            line of sight between count pairs of world positions at once, result[i] is what the single check returns for pos1[i] and pos2[i]
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, const G3D::Vector3* pos1, const G3D::Vector3* pos2, bool* result, uint32 count) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx, ry, rz will hold the hit position or the dest position, if no intersection was found
@@ -66,6 +66,7 @@ namespace MMAP
         // store inside our map list
         MMapData* mmap_data = new MMapData(mesh, mapId);
 
+        std::unique_lock<std::shared_mutex> guard(loadedMMapsLock);
         loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data));
         return true;
     }
@@ -75,11 +76,18 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
-    bool MMapManager::loadMap(const std::string& /*basePath*/, uint32 mapId, int32 x, int32 y)
+    bool MMapManager::loadMap(const std::string& /*basePath*/, uint32 mapId, int32 x, int32 y, PhasedTile* tile)
     {
         // make sure the mmap is loaded and ready to load tiles
         if (!loadMapData(mapId))
+        {
+            if (tile)
+            {
+                dtFree(tile->data);
+                delete tile;
+            }
             return false;
+        }
 
         // get this mmap data
         MMapData* mmap = loadedMMaps[mapId];
@@ -88,59 +96,79 @@ namespace MMAP
         // check if we already have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
         if (mmap->loadedTileRefs.find(packedGridPos) != mmap->loadedTileRefs.end())
-            return false;
-
-        // load this tile :: mmaps/MMMM_XX_YY.mmtile
-        uint32 pathLen = sWorld->GetDataPath().length() + strlen("mmaps/%04i_%02i_%02i.mmtile") + 1;
-        char* fileName = new char[pathLen];
-
-        snprintf(fileName, pathLen, (sWorld->GetDataPath() + "mmaps/%04i_%02i_%02i.mmtile").c_str(), mapId, x, y);
-
-        FILE* file = fopen(fileName, "rb");
-        if (!file)
         {
-            SF_LOG_DEBUG("maps", "MMAP:loadMap: Could not open mmtile file '%s'", fileName);
-            delete[] fileName;
+            if (tile)
+            {
+                dtFree(tile->data);
+                delete tile;
+            }
             return false;
         }
-        delete[] fileName;
 
-        // read header
         MmapTileHeader fileHeader;
-        if (fread(&fileHeader, sizeof(MmapTileHeader), 1, file) != 1 || fileHeader.mmapMagic != MMAP_MAGIC)
-        {
-            SF_LOG_ERROR("maps", "MMAP:loadMap: Bad header in mmap %04u_%02i_%02i.mmtile", mapId, x, y);
-            fclose(file);
-            return false;
-        }
+        unsigned char* data = NULL;
 
-        if (fileHeader.mmapVersion != MMAP_VERSION)
+        if (tile)
         {
-            SF_LOG_ERROR("maps", "MMAP:loadMap: %04u_%02i_%02i.mmtile was built with generator v%f, expected v%f",
-                mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
-            fclose(file);
-            return false;
+            fileHeader = tile->fileHeader;
+            data = tile->data;
+            delete tile;
         }
+        else
+        {
+            // load this tile :: mmaps/MMMM_XX_YY.mmtile
+            uint32 pathLen = sWorld->GetDataPath().length() + strlen("mmaps/%04i_%02i_%02i.mmtile") + 1;
+            char* fileName = new char[pathLen];
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        ASSERT(data);
+            snprintf(fileName, pathLen, (sWorld->GetDataPath() + "mmaps/%04i_%02i_%02i.mmtile").c_str(), mapId, x, y);
+
+            FILE* file = fopen(fileName, "rb");
+            if (!file)
+            {
+                SF_LOG_DEBUG("maps", "MMAP:loadMap: Could not open mmtile file '%s'", fileName);
+                delete[] fileName;
+                return false;
+            }
+            delete[] fileName;
+
+            // read header
+            if (fread(&fileHeader, sizeof(MmapTileHeader), 1, file) != 1 || fileHeader.mmapMagic != MMAP_MAGIC)
+            {
+                SF_LOG_ERROR("maps", "MMAP:loadMap: Bad header in mmap %04u_%02i_%02i.mmtile", mapId, x, y);
+                fclose(file);
+                return false;
+            }
+
+            if (fileHeader.mmapVersion != MMAP_VERSION)
+            {
+                SF_LOG_ERROR("maps", "MMAP:loadMap: %04u_%02i_%02i.mmtile was built with generator v%f, expected v%f",
+                    mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
+                fclose(file);
+                return false;
+            }
+
+            data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+            ASSERT(data);
+
+            size_t result = fread(data, fileHeader.size, 1, file);
+            if (!result)
+            {
+                SF_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap %04u_%02i_%02i.mmtile", mapId, x, y);
+                fclose(file);
+                return false;
+            }
 
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
-        {
-            SF_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap %04u_%02i_%02i.mmtile", mapId, x, y);
             fclose(file);
-            return false;
         }
 
-        fclose(file);
-
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
+        std::unique_lock<std::shared_mutex> tileGuard(mmap->tileLock);
         if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, 0/*DT_TILE_FREE_DATA*/, 0, &tileRef)))
         {
+            tileGuard.unlock();
             mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
             ++loadedTiles;
             SF_LOG_INFO("maps", "MMAP:loadMap: Loaded mmtile %04i[%02i, %02i] into %04i[%02i, %02i]", mapId, x, y, mapId, header->x, header->y);
@@ -280,6 +308,7 @@ namespace MMAP
         dtTileRef tileRef = mmap->loadedTileRefs[packedGridPos];
 
         // unload, and mark as non loaded
+        std::unique_lock<std::shared_mutex> tileGuard(mmap->tileLock);
         if (dtStatusFailed(mmap->navMesh->removeTile(tileRef, NULL, NULL)))
         {
             // this is technically a memory leak
@@ -310,8 +339,10 @@ namespace MMAP
             return false;
         }
 
-        // unload all tiles from given map
+        // unload all tiles from given map, pathfinding threads still using them are waited for
         MMapData* mmap = loadedMMaps[mapId];
+        std::unique_lock<std::shared_mutex> guard(loadedMMapsLock);
+        std::unique_lock<std::shared_mutex> tileGuard(mmap->tileLock);
         for (MMapTileSet::iterator i = mmap->loadedTileRefs.begin(); i != mmap->loadedTileRefs.end(); ++i)
         {
             uint32 x = (i->first >> 16);
@@ -326,8 +357,9 @@ namespace MMAP
             }
         }
 
-        delete mmap;
         loadedMMaps.erase(mapId);
+        tileGuard.unlock();
+        delete mmap;
         SF_LOG_INFO("maps", "MMAP:unloadMap: Unloaded %04i.mmap", mapId);
 
         return true;
@@ -367,6 +399,26 @@ namespace MMAP
         return loadedMMaps[mapId]->GetNavMesh(swaps);
     }
 
+    std::shared_lock<std::shared_mutex> MMapManager::LockNavMesh(uint32 mapId, dtNavMesh const*& navMesh, bool& swapped)
+    {
+        navMesh = NULL;
+        swapped = false;
+
+        std::shared_lock<std::shared_mutex> guard(loadedMMapsLock);
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return std::shared_lock<std::shared_mutex>();
+
+        // taken before guard is released, the map cannot be unloaded in between
+        std::shared_lock<std::shared_mutex> tileGuard(itr->second->tileLock);
+        if (itr->second->HasActiveSwaps())
+            swapped = true;
+        else
+            navMesh = itr->second->navMesh;
+
+        return tileGuard;
+    }
+
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId, TerrainSet swaps)
     {
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
@@ -419,6 +471,7 @@ namespace MMAP
         dtMeshHeader* header = (dtMeshHeader*)ptile->data;
 
         // remove old tile
+        std::unique_lock<std::shared_mutex> tileGuard(tileLock);
         if (dtStatusFailed(navMesh->removeTile(loadedTileRefs[packedXY], NULL, NULL)))
             SF_LOG_ERROR("phase", "MMapData::RemoveSwap: Could not unload phased %04u_%02i_%02i.mmtile from navmesh", swap, x, y);
         else
@@ -479,6 +532,7 @@ namespace MMAP
         // the removed tile's data
         PhasedTile* pt = new PhasedTile();
         // remove old tile
+        std::unique_lock<std::shared_mutex> tileGuard(tileLock);
         if (dtStatusFailed(navMesh->removeTile(loadedTileRefs[packedXY], &pt->data, &pt->dataSize)))
             SF_LOG_ERROR("phase", "MMapData::AddSwap: Could not unload %04u_%02i_%02i.mmtile from navmesh", _mapId, x, y);
         else
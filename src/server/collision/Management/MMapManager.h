@@ -11,7 +11,9 @@
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
 #include "World.h"
+#include <mutex>
 #include <string>
+#include <shared_mutex>
 #include <unordered_map>
 #include <set>
 
@@ -56,6 +58,8 @@ namespace MMAP
         ~MMapData();
 
         dtNavMesh* GetNavMesh(TerrainSet swaps);
+        // changes only under an exclusive tileLock
+        bool HasActiveSwaps() const { return !_activeSwaps.empty(); }
 
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
@@ -64,6 +68,9 @@ namespace MMAP
         MMapTileSet loadedTileRefs;
         TerrainSetMap loadedPhasedTiles;
 
+        // held exclusively while tiles are added to or removed from navMesh, pathfinding threads share it
+        std::shared_mutex tileLock;
+
     private:
         uint32 _mapId;
         PhaseTileContainer _baseTiles;
@@ -83,7 +90,8 @@ namespace MMAP
         MMapManager() : loadedTiles(0) { }
         ~MMapManager();
 
-        bool loadMap(const std::string& basePath, uint32 mapId, int32 x, int32 y);
+        // tile is an already read tile file, the manager takes it over
+        bool loadMap(const std::string& basePath, uint32 mapId, int32 x, int32 y, PhasedTile* tile = NULL);
         bool unloadMap(uint32 mapId, int32 x, int32 y);
         bool unloadMap(uint32 mapId);
         bool unloadMapInstance(uint32 mapId, uint32 instanceId);
@@ -91,10 +99,16 @@ namespace MMAP
         // the returned [dtNavMeshQuery const*] is NOT threadsafe
         dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId, TerrainSet swaps);
         dtNavMesh const* GetNavMesh(uint32 mapId, TerrainSet swaps);
+        // for pathfinding threads: the nav mesh of the map, no tiles are added or removed while the lock is held;
+        // swapped is set instead while terrain swap tiles are in the mesh, those are only right for the units in them
+        std::shared_lock<std::shared_mutex> LockNavMesh(uint32 mapId, dtNavMesh const*& navMesh, bool& swapped);
 
         uint32 getLoadedTilesCount() const { return loadedTiles; }
         uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
 
+        // only reads the tile file, may be called from any thread
+        PhasedTile* LoadTile(uint32 mapId, int32 x, int32 y);
+
         void LoadPhaseTiles(uint32 mapId, int32 x, int32 y);
         void UnloadPhaseTile(uint32 mapId, int32 x, int32 y);
         PhaseTileContainer GetPhaseTileContainer(uint32 mapId) { return _phaseTiles[mapId]; }
@@ -104,9 +118,9 @@ namespace MMAP
         uint32 packTileID(int32 x, int32 y);
 
         MMapDataSet loadedMMaps;
+        std::shared_mutex loadedMMapsLock;                  // only taken for changes and by pathfinding threads
         uint32 loadedTiles;
 
-        PhasedTile* LoadTile(uint32 mapId, int32 x, int32 y);
         PhaseTileMap _phaseTiles;
     };
 }
@@ -75,6 +75,18 @@ namespace VMAP
         return result;
     }
 
+    void VMapManager2::preloadMapTile(const char* basePath, unsigned int mapId, int x, int y, std::vector<std::string>& models)
+    {
+        if (!isMapLoadingEnabled())
+            return;
+
+        std::string path = basePath;
+        if (!path.empty() && path[path.length() - 1] != '/' && path[path.length() - 1] != '\\')
+            path.push_back('/');
+
+        StaticMapTree::AcquireTileModels(path, mapId, x, y, this, models);
+    }
+
     // load one tile (internal use only)
     bool VMapManager2::_loadMap(uint32 mapId, const std::string& basePath, uint32 tileX, uint32 tileY)
     {
@@ -141,6 +153,27 @@ namespace VMAP
         return true;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int mapId, const Vector3* pos1, const Vector3* pos2, bool* result, uint32 count)
+    {
+        std::fill_n(result, count, true);
+        if (!count || !isLineOfSightCalcEnabled() || DisableMgr::IsDisabledFor(DISABLE_TYPE_VMAP, mapId, NULL, VMAP_DISABLE_LOS))
+            return;
+
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(mapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        std::vector<Vector3> from(count);
+        std::vector<Vector3> to(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            from[i] = convertPositionToInternalRep(pos1[i].x, pos1[i].y, pos1[i].z);
+            to[i] = convertPositionToInternalRep(pos2[i].x, pos2[i].y, pos2[i].z);
+        }
+
+        instanceTree->second->isInLineOfSight(&from[0], &to[0], result, count);
+    }
+
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -239,23 +272,39 @@ namespace VMAP
 
     WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename)
     {
-        //! Critical section, thread safe access to iLoadedModelFiles
+        {
+            //! Critical section, thread safe access to iLoadedModelFiles
+            std::lock_guard<std::mutex> guard(LoadedModelFilesLock);
+
+            ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
+            if (model != iLoadedModelFiles.end())
+            {
+                model->second.incRefCount();
+                return model->second.getModel();
+            }
+        }
+
+        // the file is read unlocked, other threads only wait for the models they load themselves
+        WorldModel* worldmodel = new WorldModel();
+        if (!worldmodel->readFile(basepath + filename + ".vmo"))
+        {
+            VMAP_ERROR_LOG("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
+            delete worldmodel;
+            return NULL;
+        }
+        VMAP_DEBUG_LOG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
+
         std::lock_guard<std::mutex> guard(LoadedModelFilesLock);
 
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
-            WorldModel* worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
-            {
-                VMAP_ERROR_LOG("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
-                delete worldmodel;
-                return NULL;
-            }
-            VMAP_DEBUG_LOG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
             model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
             model->second.setModel(worldmodel);
         }
+        else
+            delete worldmodel;                              // loaded by another thread meanwhile
+
         model->second.incRefCount();
         return model->second.getModel();
     }
@@ -11,6 +11,7 @@
 #include "Define.h"
 #include <ace/Thread_Mutex.h>
 #include <mutex>
+#include <vector>
 
 //===========================================================
 
@@ -75,11 +76,17 @@ namespace VMAP
             ~VMapManager2(void);
 
             int loadMap(const char* pBasePath, unsigned int mapId, int x, int y);
+            /**
+            Reads the models of a tile ahead of loadMap(), may be called from any thread.
+            The references are held until they are given back with releaseModelInstance().
+            */
+            void preloadMapTile(const char* pBasePath, unsigned int mapId, int x, int y, std::vector<std::string>& models);
 
             void unloadMap(unsigned int mapId, int x, int y);
             void unloadMap(unsigned int mapId);
 
             bool isInLineOfSight(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2) ;
+            void isInLineOfSight(unsigned int mapId, const G3D::Vector3* pos1, const G3D::Vector3* pos2, bool* result, uint32 count);
             /**
             fill the hit pos and return true, if an object was hit
             */
@@ -37,6 +37,18 @@ namespace VMAP
         bool hit;
     };
 
+    class MapPacketCallback
+    {
+        public:
+            explicit MapPacketCallback(ModelInstance* val): prims(val) { }
+            uint32 operator()(const RayPacket& packet, uint32 entry, uint32 lanes)
+            {
+                return prims[entry].intersectPacket(packet, lanes);
+            }
+    protected:
+        ModelInstance* prims;
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -160,6 +172,50 @@ namespace VMAP
 
         return true;
     }
+
+    void StaticMapTree::isInLineOfSight(const Vector3* pos1, const Vector3* pos2, bool* result, uint32 count) const
+    {
+        MapPacketCallback intersectionCallBack(iTreeValues);
+        RayPacket packet;
+        uint32 queries[RayPacket::LANES];
+        int lanes = 0;
+
+        auto trace = [&]()
+        {
+            uint32 open = (1 << lanes) - 1;
+            iTree.intersectPacket(packet, open, intersectionCallBack);
+            for (int lane = 0; lane < lanes; ++lane)
+                if (!(open & (1 << lane)))
+                    result[queries[lane]] = false;
+            lanes = 0;
+        };
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            // same early results as the single check
+            float maxDist = (pos2[i] - pos1[i]).magnitude();
+            if (maxDist == std::numeric_limits<float>::max() ||
+                maxDist == std::numeric_limits<float>::infinity())
+            {
+                result[i] = false;
+                continue;
+            }
+
+            ASSERT(maxDist < std::numeric_limits<float>::max());
+            result[i] = true;
+            if (maxDist < 1e-10f)
+                continue;
+
+            packet.setRay(lanes, pos1[i], (pos2[i] - pos1[i]) / maxDist, maxDist);
+            queries[lanes] = i;
+            if (++lanes == RayPacket::LANES)
+                trace();
+        }
+
+        if (lanes)
+            trace();
+    }
+
     //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
@@ -409,6 +465,31 @@ namespace VMAP
 
     //=========================================================
 
+    void StaticMapTree::AcquireTileModels(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm, std::vector<std::string> &models)
+    {
+        std::string tilefile = basePath + getTileFileName(mapID, tileX, tileY);
+        FILE* tf = fopen(tilefile.c_str(), "rb");
+        if (!tf)
+            return;
+
+        char chunk[8];
+        uint32 numSpawns = 0;
+        if (readChunk(tf, chunk, VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, tf) == 1)
+        {
+            for (uint32 i=0; i<numSpawns; ++i)
+            {
+                ModelSpawn spawn;
+                uint32 referencedVal;
+                if (!ModelSpawn::readFromFile(tf, spawn) || fread(&referencedVal, sizeof(uint32), 1, tf) != 1)
+                    break;
+
+                if (vm->acquireModelInstance(basePath, spawn.name))
+                    models.push_back(spawn.name);
+            }
+        }
+        fclose(tf);
+    }
+
     void StaticMapTree::UnloadMapTile(uint32 tileX, uint32 tileY, VMapManager2* vm)
     {
         uint32 tileID = packTileID(tileX, tileY);
@@ -51,11 +51,15 @@ namespace VMAP
             static uint32 packTileID(uint32 tileX, uint32 tileY) { return tileX<<16 | tileY; }
             static void unpackTileID(uint32 ID, uint32 &tileX, uint32 &tileY) { tileX = ID>>16; tileY = ID&0xFF; }
             static bool CanLoadMap(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY);
+            // acquires the models spawned on a tile without touching any tree, the names are returned for releasing them
+            static void AcquireTileModels(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm, std::vector<std::string> &models);
 
             StaticMapTree(uint32 mapID, const std::string &basePath);
             ~StaticMapTree();
 
             bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2) const;
+            // same as above for count pairs of positions, traced through the tree in packets of RayPacket::LANES
+            void isInLineOfSight(const G3D::Vector3* pos1, const G3D::Vector3* pos2, bool* result, uint32 count) const;
             bool getObjectHitPos(const G3D::Vector3& pos1, const G3D::Vector3& pos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(const G3D::Vector3& pPos, float maxSearchDist) const;
             bool getAreaInfo(G3D::Vector3 &pos, uint32 &flags, int32 &adtId, int32 &rootId, int32 &groupId) const;
@@ -64,6 +64,7 @@ public:
     void enable(uint32 ph_mask) { phasemask = ph_mask;}
 
     bool isEnabled() const {return phasemask != 0;}
+    uint32 getPhaseMask() const { return phasemask; }
 
     bool intersectRay(const G3D::Ray& Ray, float& MaxDist, bool StopAtFirstHit, uint32 ph_mask) const;
 
@@ -52,6 +52,24 @@ namespace VMAP
         return hit;
     }
 
+    uint32 ModelInstance::intersectPacket(const RayPacket& pPacket, uint32 pLanes) const
+    {
+        if (!iModel)
+            return 0;
+
+        pLanes = pPacket.intersectBox(iBound, pLanes);
+        if (!pLanes)
+            return 0;
+
+        // child bounds are defined in object space:
+        RayPacket modPacket;
+        for (int lane = 0; lane < RayPacket::LANES; ++lane)
+            if (pLanes & (1 << lane))
+                modPacket.setRay(lane, iInvRot * (pPacket.getOrigin(lane) - iPos) * iInvScale, iInvRot * pPacket.getDirection(lane), pPacket.maxDist[lane] * iInvScale);
+
+        return iModel->IntersectPacket(modPacket, pLanes);
+    }
+
     void ModelInstance::intersectPoint(const G3D::Vector3& p, AreaInfo &info) const
     {
         if (!iModel)
@@ -13,6 +13,8 @@
 
 #include "Define.h"
 
+struct RayPacket;
+
 namespace VMAP
 {
     class WorldModel;
@@ -54,6 +56,7 @@ namespace VMAP
             ModelInstance(const ModelSpawn &spawn, WorldModel* model);
             void setUnloaded() { iModel = 0; }
             bool intersectRay(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit) const;
+            uint32 intersectPacket(const RayPacket& pPacket, uint32 pLanes) const;
             void intersectPoint(const G3D::Vector3& p, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3& p, LocationInfo &info) const;
             bool GetLiquidLevel(const G3D::Vector3& p, LocationInfo &info, float &liqHeight) const;
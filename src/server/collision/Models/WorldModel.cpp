@@ -68,6 +68,46 @@ namespace VMAP
         return false;
     }
 
+    //! IntersectTriangle() for every given lane of the packet, returns the lanes that hit the triangle
+    uint32 IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const RayPacket &packet, uint32 lanes)
+    {
+        using namespace RayLanes;
+        static const float EPS = 1e-5f;
+
+        const Vector3 e1 = points[tri.idx1] - points[tri.idx0];
+        const Vector3 e2 = points[tri.idx2] - points[tri.idx0];
+        const Float4 dx = load(packet.dir[0]), dy = load(packet.dir[1]), dz = load(packet.dir[2]);
+
+        // p = dir x e2
+        const Float4 px = sub(mul(dy, splat(e2.z)), mul(dz, splat(e2.y)));
+        const Float4 py = sub(mul(dz, splat(e2.x)), mul(dx, splat(e2.z)));
+        const Float4 pz = sub(mul(dx, splat(e2.y)), mul(dy, splat(e2.x)));
+        const Float4 a = add(add(mul(splat(e1.x), px), mul(splat(e1.y), py)), mul(splat(e1.z), pz));
+
+        // Determinant is ill-conditioned for these lanes
+        lanes &= bits(either(lessEqual(splat(EPS), a), lessEqual(a, splat(-EPS))));
+        if (!lanes)
+            return 0;
+
+        const Float4 f = div(splat(1.0f), a);
+        const Float4 sx = sub(load(packet.org[0]), splat(points[tri.idx0].x));
+        const Float4 sy = sub(load(packet.org[1]), splat(points[tri.idx0].y));
+        const Float4 sz = sub(load(packet.org[2]), splat(points[tri.idx0].z));
+        const Float4 u = mul(f, add(add(mul(sx, px), mul(sy, py)), mul(sz, pz)));
+
+        // q = s x e1
+        const Float4 qx = sub(mul(sy, splat(e1.z)), mul(sz, splat(e1.y)));
+        const Float4 qy = sub(mul(sz, splat(e1.x)), mul(sx, splat(e1.z)));
+        const Float4 qz = sub(mul(sx, splat(e1.y)), mul(sy, splat(e1.x)));
+        const Float4 v = mul(f, add(add(mul(dx, qx), mul(dy, qy)), mul(dz, qz)));
+        const Float4 t = mul(f, add(add(mul(splat(e2.x), qx), mul(splat(e2.y), qy)), mul(splat(e2.z), qz)));
+
+        Mask4 inside = both(lessEqual(splat(0.0f), u), lessEqual(u, splat(1.0f)));
+        inside = both(inside, both(lessEqual(splat(0.0f), v), lessEqual(add(u, v), splat(1.0f))));
+        inside = both(inside, both(less(splat(0.0f), t), less(t, load(packet.maxDist))));
+        return lanes & bits(inside);
+    }
+
     class TriBoundFunc
     {
         public:
@@ -369,6 +409,29 @@ namespace VMAP
         return callback.hit;
     }
 
+    struct GModelPacketCallback
+    {
+        GModelPacketCallback(const std::vector<MeshTriangle> &tris, const std::vector<Vector3> &vert):
+            vertices(vert.begin()), triangles(tris.begin()) { }
+        uint32 operator()(const RayPacket &packet, uint32 entry, uint32 lanes)
+        {
+            return IntersectTriangle(triangles[entry], vertices, packet, lanes);
+        }
+        std::vector<Vector3>::const_iterator vertices;
+        std::vector<MeshTriangle>::const_iterator triangles;
+    };
+
+    uint32 GroupModel::IntersectPacket(const RayPacket &packet, uint32 lanes) const
+    {
+        if (triangles.empty())
+            return 0;
+
+        GModelPacketCallback callback(triangles, vertices);
+        uint32 open = lanes;
+        meshTree.intersectPacket(packet, open, callback);
+        return lanes & ~open;
+    }
+
     bool GroupModel::IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const
     {
         if (triangles.empty() || !iBound.contains(pos))
@@ -430,6 +493,28 @@ namespace VMAP
         return isc.hit;
     }
 
+    struct WModelPacketCallback
+    {
+        explicit WModelPacketCallback(const std::vector<GroupModel> &mod): models(mod.begin()) { }
+        uint32 operator()(const RayPacket &packet, uint32 entry, uint32 lanes)
+        {
+            return models[entry].IntersectPacket(packet, lanes);
+        }
+        std::vector<GroupModel>::const_iterator models;
+    };
+
+    uint32 WorldModel::IntersectPacket(const RayPacket &packet, uint32 lanes) const
+    {
+        // same as IntersectRay(), no bound tree for a single submodel
+        if (groupModels.size() == 1)
+            return groupModels[0].IntersectPacket(packet, lanes);
+
+        WModelPacketCallback isc(groupModels);
+        uint32 open = lanes;
+        groupTree.intersectPacket(packet, open, isc);
+        return lanes & ~open;
+    }
+
     class WModelAreaCallback {
         public:
             WModelAreaCallback(const std::vector<GroupModel> &vals, const Vector3 &down):
@@ -0,0 +1,135 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef _RAYPACKET_H
+#define _RAYPACKET_H
+
+#include "G3D/Vector3.h"
+#include "G3D/AABox.h"
+
+#include "Define.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SF_RAYPACKET_SSE2
+#endif
+
+/** Four wide float operations used to trace the rays of a RayPacket together.
+    min() and max() keep their second operand when the first one is NaN, like
+    minps/maxps do, which the slab tests rely on for rays parallel to a plane.
+*/
+namespace RayLanes
+{
+#ifdef SF_RAYPACKET_SSE2
+    typedef __m128 Float4;
+    typedef __m128 Mask4;
+
+    inline Float4 load(float const* p) { return _mm_load_ps(p); }
+    inline Float4 splat(float f) { return _mm_set1_ps(f); }
+    inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+    inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    inline Float4 div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+    inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+    inline Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+
+    inline Mask4 less(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+    inline Mask4 lessEqual(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+    inline Mask4 both(Mask4 a, Mask4 b) { return _mm_and_ps(a, b); }
+    inline Mask4 either(Mask4 a, Mask4 b) { return _mm_or_ps(a, b); }
+    inline Float4 select(Mask4 m, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    inline uint32 bits(Mask4 m) { return uint32(_mm_movemask_ps(m)); }
+#else
+    struct Float4 { float v[4]; };
+    struct Mask4 { bool v[4]; };
+
+    #define SF_RAYLANES_OP(type, expr) type r; for (int i = 0; i < 4; ++i) r.v[i] = (expr); return r;
+
+    inline Float4 load(float const* p) { SF_RAYLANES_OP(Float4, p[i]) }
+    inline Float4 splat(float f) { SF_RAYLANES_OP(Float4, f) }
+    inline Float4 add(Float4 a, Float4 b) { SF_RAYLANES_OP(Float4, a.v[i] + b.v[i]) }
+    inline Float4 sub(Float4 a, Float4 b) { SF_RAYLANES_OP(Float4, a.v[i] - b.v[i]) }
+    inline Float4 mul(Float4 a, Float4 b) { SF_RAYLANES_OP(Float4, a.v[i] * b.v[i]) }
+    inline Float4 div(Float4 a, Float4 b) { SF_RAYLANES_OP(Float4, a.v[i] / b.v[i]) }
+    inline Float4 min(Float4 a, Float4 b) { SF_RAYLANES_OP(Float4, a.v[i] < b.v[i] ? a.v[i] : b.v[i]) }
+    inline Float4 max(Float4 a, Float4 b) { SF_RAYLANES_OP(Float4, a.v[i] > b.v[i] ? a.v[i] : b.v[i]) }
+
+    inline Mask4 less(Float4 a, Float4 b) { SF_RAYLANES_OP(Mask4, a.v[i] < b.v[i]) }
+    inline Mask4 lessEqual(Float4 a, Float4 b) { SF_RAYLANES_OP(Mask4, a.v[i] <= b.v[i]) }
+    inline Mask4 both(Mask4 a, Mask4 b) { SF_RAYLANES_OP(Mask4, a.v[i] && b.v[i]) }
+    inline Mask4 either(Mask4 a, Mask4 b) { SF_RAYLANES_OP(Mask4, a.v[i] || b.v[i]) }
+    inline Float4 select(Mask4 m, Float4 a, Float4 b) { SF_RAYLANES_OP(Float4, m.v[i] ? a.v[i] : b.v[i]) }
+    inline uint32 bits(Mask4 m) { uint32 r = 0; for (int i = 0; i < 4; ++i) r |= uint32(m.v[i]) << i; return r; }
+
+    #undef SF_RAYLANES_OP
+#endif
+
+    /// narrows [lo, hi] of each lane to the part of the ray between the planes low and high of one axis
+    inline void clipSlab(Float4 org, Float4 invDir, float low, float high, Float4 &lo, Float4 &hi)
+    {
+        // a negative direction enters through the high plane
+        Mask4 negative = less(invDir, splat(0.f));
+        Float4 tLow = mul(sub(splat(low), org), invDir);
+        Float4 tHigh = mul(sub(splat(high), org), invDir);
+        lo = max(select(negative, tHigh, tLow), lo);
+        hi = min(select(negative, tLow, tHigh), hi);
+    }
+}
+
+/** Up to four line segments traced through a BIH together.
+    Stored per axis so every lane of a component is loaded at once. Lanes are
+    selected by bit masks, the contents of unused lanes are never looked at.
+*/
+struct RayPacket
+{
+    enum
+    {
+        LANES       = 4,
+        ALL_LANES   = (1 << LANES) - 1
+    };
+
+    RayPacket()
+    {
+        for (int lane = 0; lane < LANES; ++lane)
+            setRay(lane, G3D::Vector3(0.f, 0.f, 0.f), G3D::Vector3(1.f, 0.f, 0.f), 0.f);
+    }
+
+    void setRay(int lane, const G3D::Vector3 &origin, const G3D::Vector3 &direction, float distance)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            org[i][lane] = origin[i];
+            dir[i][lane] = direction[i];
+            invDir[i][lane] = 1.f / direction[i];
+        }
+        maxDist[lane] = distance;
+    }
+
+    G3D::Vector3 getOrigin(int lane) const { return G3D::Vector3(org[0][lane], org[1][lane], org[2][lane]); }
+    G3D::Vector3 getDirection(int lane) const { return G3D::Vector3(dir[0][lane], dir[1][lane], dir[2][lane]); }
+
+    /// lanes whose segment touches the box, with the part of each segment inside it
+    uint32 clipBox(const G3D::AABox &box, uint32 lanes, RayLanes::Float4 &lo, RayLanes::Float4 &hi) const
+    {
+        lo = RayLanes::splat(0.f);
+        hi = RayLanes::load(maxDist);
+        for (int i = 0; i < 3; ++i)
+            RayLanes::clipSlab(RayLanes::load(org[i]), RayLanes::load(invDir[i]), box.low()[i], box.high()[i], lo, hi);
+        return lanes & RayLanes::bits(RayLanes::lessEqual(lo, hi));
+    }
+
+    uint32 intersectBox(const G3D::AABox &box, uint32 lanes) const
+    {
+        RayLanes::Float4 lo, hi;
+        return clipBox(box, lanes, lo, hi);
+    }
+
+    alignas(16) float org[3][LANES];
+    alignas(16) float dir[3][LANES];
+    alignas(16) float invDir[3][LANES];
+    alignas(16) float maxDist[LANES];
+};
+
+#endif // _RAYPACKET_H
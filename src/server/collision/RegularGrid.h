@@ -66,6 +66,25 @@ public:
         memberTable.remove(&value);
     }
 
+    // the value moved, returns true if that took it to another cell
+    bool relocate(const T& value)
+    {
+        G3D::Vector3 pos;
+        PositionFunc::getPosition(value, pos);
+        Node& node = getGridFor(pos.x, pos.y);
+        Node* current = memberTable[&value];
+        if (current == &node)
+        {
+            node.relocate(value);
+            return false;
+        }
+
+        current->remove(value);
+        node.insert(value);
+        memberTable.set(&value, &node);
+        return true;
+    }
+
     void balance()
     {
         for (int x = 0; x < CELL_NUMBER; ++x)
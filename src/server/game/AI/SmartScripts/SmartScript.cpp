@@ -70,6 +70,7 @@ mPathId(0), mTextTimer(0), mLastTextID(0), mTalkerEntry(0), mUseTextTimer(false)
 mTemplate(SMARTAI_TEMPLATE_BASIC), meOrigGUID(0), goOrigGUID(0), mLastInvoker(0)
 {
     mTargetStorage = new ObjectListMap();
+    memset(mEventTypeStart, 0, sizeof(mEventTypeStart));
 }
 
 SmartScript::~SmartScript()
@@ -120,21 +121,34 @@ void SmartScript::ResetBaseObject()
 
 void SmartScript::ProcessEventsFor(SMART_EVENT e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
 {
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
-    {
-        SMART_EVENT eventType = SMART_EVENT((*i).GetEventType());
-        if (eventType == SMART_EVENT_LINK)//special handling
-            continue;
+    if (e == SMART_EVENT_LINK || e >= SMART_EVENT_END)//special handling
+        return;
 
-        if (eventType == e/* && (!(*i).event.event_phase_mask || IsInPhase((*i).event.event_phase_mask)) && !((*i).event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE && (*i).runOnce)*/)
+    // only the events of this type, the index is built again whenever mEvents changes
+    for (uint32 i = mEventTypeStart[e]; i < mEventTypeStart[e + 1]; ++i)
+    {
+        SmartScriptHolder& holder = mEvents[mEventsByType[i]];
+        if (ConditionList const* conds = GetConditions(holder))
         {
-            ConditionList conds = sConditionMgr->GetConditionsForSmartEvent((*i).entryOrGuid, (*i).event_id, (*i).source_type);
             ConditionSourceInfo info = ConditionSourceInfo(unit, GetBaseObject());
-
-            if (sConditionMgr->IsObjectMeetToConditions(info, conds))
-                ProcessEvent(*i, unit, var0, var1, bvar, spell, gob);
+            if (!sConditionMgr->IsObjectMeetToConditions(info, *conds))
+                continue;
         }
+
+        ProcessEvent(holder, unit, var0, var1, bvar, spell, gob);
+    }
+}
+
+ConditionList const* SmartScript::GetConditions(SmartScriptHolder& e) const
+{
+    // looked up once, and again after the conditions were reloaded
+    uint32 loadCount = sConditionMgr->GetLoadCount();
+    if (e.conditionsLoad != loadCount)
+    {
+        e.conditions = sConditionMgr->FindConditionsForSmartEvent(e.entryOrGuid, e.event_id, e.source_type);
+        e.conditionsLoad = loadCount;
     }
+    return e.conditions;
 }
 
 void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
@@ -2311,10 +2325,10 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
 
 void SmartScript::ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
 {
-    ConditionList const conds = sConditionMgr->GetConditionsForSmartEvent(e.entryOrGuid, e.event_id, e.source_type);
+    ConditionList const* conds = GetConditions(e);
     ConditionSourceInfo info = ConditionSourceInfo(unit, GetBaseObject());
 
-    if (sConditionMgr->IsObjectMeetToConditions(info, conds))
+    if (!conds || sConditionMgr->IsObjectMeetToConditions(info, *conds))
         ProcessAction(e, unit, var0, var1, bvar, spell, gob);
 
     RecalcTimer(e, min, max);
@@ -3320,6 +3334,27 @@ void SmartScript::InstallEvents()
             mEvents.push_back(*i);//must be before UpdateTimers
 
         mInstallEvents.clear();
+        BuildEventIndex();
+    }
+}
+
+void SmartScript::BuildEventIndex()
+{
+    // counting sort by event type, events of the same type keep their order
+    uint32 counts[SMART_EVENT_END] = { };
+    for (SmartAIEventList::const_iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+        ++counts[i->GetEventType()];
+
+    mEventTypeStart[0] = 0;
+    for (uint32 type = 0; type < SMART_EVENT_END; ++type)
+        mEventTypeStart[type + 1] = mEventTypeStart[type] + counts[type];
+
+    mEventsByType.resize(mEvents.size());
+    memcpy(counts, mEventTypeStart, sizeof(counts));
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+    {
+        mEventsByType[counts[mEvents[i].GetEventType()]++] = i;
+        GetConditions(mEvents[i]);
     }
 }
 
@@ -3420,6 +3455,8 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
         }
         mEvents.push_back((*i));//NOTE: 'world(0)' events still get processed in ANY instance mode
     }
+    BuildEventIndex();
+
     if (mEvents.empty() && obj)
         SF_LOG_ERROR("sql.sql", "SmartScript: Entry %u has events but no events added to list because of instance flags.", obj->GetEntry());
     if (mEvents.empty() && at)
@@ -172,6 +172,9 @@ private:
     void SetPhase(uint32 p = 0) { mEventPhase = p; }
 
     SmartAIEventList mEvents;
+    // indexes of mEvents by event type, the ones of type t are from mEventTypeStart[t] up to mEventTypeStart[t + 1]
+    std::vector<uint32> mEventsByType;
+    uint32 mEventTypeStart[SMART_EVENT_END + 1];
     SmartAIEventList mInstallEvents;
     SmartAIEventList mTimedActionList;
     Creature* me;
@@ -194,6 +197,8 @@ private:
 
     SMARTAI_TEMPLATE mTemplate;
     void InstallEvents();
+    void BuildEventIndex();
+    ConditionList const* GetConditions(SmartScriptHolder& e) const;
 
     void RemoveStoredEvent(uint32 id);
 
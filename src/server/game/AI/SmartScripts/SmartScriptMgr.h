@@ -7,6 +7,7 @@
 #define SKYFIRE_SMARTSCRIPTMGR_H
 
 #include "Common.h"
+#include "ConditionMgr.h"
 #include "Creature.h"
 #include "CreatureAI.h"
 #include "DB2Stores.h"
@@ -1309,7 +1310,8 @@ enum SmartCastFlags
 struct SmartScriptHolder
 {
     SmartScriptHolder() : entryOrGuid(0), source_type(SMART_SCRIPT_TYPE_CREATURE),
-        event_id(0), link(0), event(), action(), target(), timer(0), active(false), runOnce(false), enableTimed(false) { }
+        event_id(0), link(0), event(), action(), target(), timer(0), active(false), runOnce(false), enableTimed(false),
+        conditions(NULL), conditionsLoad(0) { }
 
     int32 entryOrGuid;
     SmartScriptType source_type;
@@ -1330,6 +1332,9 @@ public:
     bool active;
     bool runOnce;
     bool enableTimed;
+
+    ConditionList const* conditions;                        // resolved by SmartScript::GetConditions
+    uint32 conditionsLoad;                                  // ConditionMgr::GetLoadCount when they were resolved
 };
 
 typedef UNORDERED_MAP<uint32, WayPoint*> WPPath;
@@ -693,6 +693,12 @@ namespace rbac
         RBAC_PERM_COMMAND_ACCOUNT_BOOST_ADD = 806,
         RBAC_PERM_COMMAND_ACCOUNT_BOOST_DEL = 807,
 
+        RBAC_PERM_COMMAND_DEBUG_UPDATEMASK = 808,
+        RBAC_PERM_COMMAND_DEBUG_DYNTREE = 809,
+        RBAC_PERM_COMMAND_DEBUG_LFGQUEUE = 810,
+        RBAC_PERM_COMMAND_DEBUG_PROCS = 811,
+        RBAC_PERM_COMMAND_DEBUG_EVENTS = 812,
+
         // custom permissions 1000+
         RBAC_PERM_MAX
     };
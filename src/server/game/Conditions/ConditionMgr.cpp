@@ -515,7 +515,7 @@ uint32 Condition::GetMaxAvailableConditionTargets()
     }
 }
 
-ConditionMgr::ConditionMgr() { }
+ConditionMgr::ConditionMgr() : _loadCount(0) { }
 
 ConditionMgr::~ConditionMgr()
 {
@@ -720,17 +720,24 @@ ConditionList ConditionMgr::GetConditionsForVehicleSpell(uint32 creatureId, uint
 ConditionList ConditionMgr::GetConditionsForSmartEvent(int32 entryOrGuid, uint32 eventId, uint32 sourceType)
 {
     ConditionList cond;
+    if (ConditionList const* conditions = FindConditionsForSmartEvent(entryOrGuid, eventId, sourceType))
+        cond = *conditions;
+    return cond;
+}
+
+ConditionList const* ConditionMgr::FindConditionsForSmartEvent(int32 entryOrGuid, uint32 eventId, uint32 sourceType) const
+{
     SmartEventConditionContainer::const_iterator itr = SmartEventConditionStore.find(std::make_pair(entryOrGuid, sourceType));
     if (itr != SmartEventConditionStore.end())
     {
         ConditionTypeContainer::const_iterator i = (*itr).second.find(eventId + 1);
         if (i != (*itr).second.end())
         {
-            cond = (*i).second;
             SF_LOG_DEBUG("condition", "GetConditionsForSmartEvent: found conditions for Smart Event entry or guid %d event_id %u", entryOrGuid, eventId);
+            return &(*i).second;
         }
     }
-    return cond;
+    return NULL;
 }
 
 ConditionList ConditionMgr::GetConditionsForNpcVendorEvent(uint32 creatureId, uint32 itemId)
@@ -754,6 +761,7 @@ void ConditionMgr::LoadConditions(bool isReload)
     uint32 oldMSTime = getMSTime();
 
     Clean();
+    ++_loadCount;
 
     //must clear all custom handled cases (groupped types) before reload
     if (isReload)
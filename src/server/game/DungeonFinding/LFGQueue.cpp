@@ -89,25 +89,20 @@ namespace lfg
         RemoveFromCurrentQueue(guid);
         RemoveFromCompatibles(guid);
 
-        std::ostringstream o;
-        o << guid;
-        std::string sguid = o.str();
+        LfgQueueDataContainer::iterator itDelete = QueueDataStore.find(guid);
+        if (itDelete == QueueDataStore.end())
+            return;
 
-        LfgQueueDataContainer::iterator itDelete = QueueDataStore.end();
+        uint32 slot = itDelete->second.slot;
         for (LfgQueueDataContainer::iterator itr = QueueDataStore.begin(); itr != QueueDataStore.end(); ++itr)
-            if (itr->first != guid)
+            if (itr != itDelete && itr->second.bestCompatible.Contains(slot))
             {
-                if (std::string::npos != itr->second.bestCompatible.find(sguid))
-                {
-                    itr->second.bestCompatible.clear();
-                    FindBestCompatibleInQueue(itr);
-                }
+                itr->second.bestCompatible = LfgCompatibleKey();
+                FindBestCompatibleInQueue(itr);
             }
-            else
-                itDelete = itr;
 
-        if (itDelete != QueueDataStore.end())
-            QueueDataStore.erase(itDelete);
+        ReleaseSlot(itDelete->second);
+        QueueDataStore.erase(itDelete);
     }
 
     void LFGQueue::AddToNewQueue(uint64 guid)
@@ -132,7 +127,13 @@ namespace lfg
 
     void LFGQueue::AddQueueData(uint64 guid, time_t joinTime, LfgDungeonSet const& dungeons, LfgRolesMap const& rolesMap)
     {
-        QueueDataStore[guid] = LfgQueueData(joinTime, dungeons, rolesMap);
+        LfgQueueDataContainer::iterator it = QueueDataStore.find(guid);
+        if (it != QueueDataStore.end())
+            ReleaseSlot(it->second);
+
+        LfgQueueData& data = QueueDataStore[guid];
+        data = LfgQueueData(joinTime, dungeons, rolesMap);
+        AssignSlot(guid, data);
         AddToQueue(guid);
     }
 
@@ -140,7 +141,164 @@ namespace lfg
     {
         LfgQueueDataContainer::iterator it = QueueDataStore.find(guid);
         if (it != QueueDataStore.end())
+        {
+            ReleaseSlot(it->second);
             QueueDataStore.erase(it);
+        }
+    }
+
+    /**
+       Gives a queued player or group the slot it is known by in compatible keys
+       and what the pruning of FindNewGroups needs to know about it
+
+       @param[in]     guid Guid of the queued player or group
+       @param[in]     data Its queue data
+    */
+    void LFGQueue::AssignSlot(uint64 guid, LfgQueueData& data)
+    {
+        if (freeSlots.empty())
+        {
+            if (slotGuids.empty())
+                slotGuids.push_back(0);                        // 0 marks the unused places of a key
+
+            data.slot = uint32(slotGuids.size());
+            slotGuids.push_back(guid);
+            slotCompatibles.resize(slotGuids.size());
+        }
+        else
+        {
+            data.slot = freeSlots.back();
+            freeSlots.pop_back();
+            slotGuids[data.slot] = guid;
+        }
+
+        data.onlyTanks = 0;
+        data.onlyHealers = 0;
+        data.onlyDps = 0;
+        for (LfgRolesMap::const_iterator it = data.roles.begin(); it != data.roles.end(); ++it)
+        {
+            switch (it->second & ~PLAYER_ROLE_LEADER)
+            {
+                case PLAYER_ROLE_TANK:
+                    ++data.onlyTanks;
+                    break;
+                case PLAYER_ROLE_HEALER:
+                    ++data.onlyHealers;
+                    break;
+                case PLAYER_ROLE_DAMAGE:
+                    ++data.onlyDps;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        data.dungeonMask.reset();
+        for (LfgDungeonSet::const_iterator it = data.dungeons.begin(); it != data.dungeons.end(); ++it)
+        {
+            std::map<uint32, uint16>::const_iterator itBit = dungeonBits.find(*it);
+            if (itBit == dungeonBits.end())
+            {
+                // the queue can not tell more dungeons apart, this one is taken as any
+                if (dungeonBits.size() >= LFG_DUNGEON_MASK_BITS)
+                {
+                    data.dungeonMask.set();
+                    break;
+                }
+
+                itBit = dungeonBits.insert(std::make_pair(*it, uint16(dungeonBits.size()))).first;
+            }
+            data.dungeonMask.set(itBit->second);
+        }
+    }
+
+    void LFGQueue::ReleaseSlot(LfgQueueData const& data)
+    {
+        if (!data.slot)
+            return;
+
+        // the next one in the slot must not find the cached combinations of this one
+        std::vector<LfgCompatibleKey>& keys = slotCompatibles[data.slot];
+        for (std::vector<LfgCompatibleKey>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+            CompatibleMapStore.erase(*it);
+        keys.clear();
+
+        slotGuids[data.slot] = 0;
+        freeSlots.push_back(data.slot);
+    }
+
+    bool LFGQueue::MakeKey(LfgGuidList const& check, LfgCompatibleKey& key) const
+    {
+        if (check.empty() || check.size() > LFG_COMPATIBLE_KEY_SIZE)
+            return false;
+
+        uint8 size = 0;
+        for (LfgGuidList::const_iterator it = check.begin(); it != check.end(); ++it)
+        {
+            LfgQueueDataContainer::const_iterator itQueue = QueueDataStore.find(*it);
+            if (itQueue == QueueDataStore.end() || !itQueue->second.slot)
+            {
+                key = LfgCompatibleKey();
+                return false;
+            }
+            key.slots[size++] = itQueue->second.slot;
+        }
+
+        std::sort(key.slots, key.slots + size);
+        return true;
+    }
+
+    std::string LFGQueue::KeyToString(LfgCompatibleKey const& key) const
+    {
+        std::ostringstream o;
+        for (uint8 i = 0; i < LFG_COMPATIBLE_KEY_SIZE && key.slots[i]; ++i)
+        {
+            if (i)
+                o << '|';
+            o << slotGuids[key.slots[i]];
+        }
+        return o.str();
+    }
+
+    /**
+       Checks the things CheckCompatibility would turn a combination down for that are known before asking anyone:
+       too many players, more players that can only take a role than the group has places for it, no dungeon all selected
+
+       @param[in]     filter What the queued groups of the combination have together
+       @param[in]     guid Queued player or group to add to it
+       @param[out]    joined What they have together with guid
+       @return false if the combination can not be compatible
+    */
+    bool LFGQueue::CanJoin(LfgQueueFilter const& filter, uint64 guid, LfgQueueFilter& joined) const
+    {
+        joined = filter;
+
+        // CheckCompatibility takes care of guids that are not queued any more
+        LfgQueueDataContainer::const_iterator itQueue = QueueDataStore.find(guid);
+        if (itQueue == QueueDataStore.end())
+            return true;
+
+        LfgQueueData const& data = itQueue->second;
+        joined.players += uint8(data.roles.size());
+        joined.onlyTanks += data.onlyTanks;
+        joined.onlyHealers += data.onlyHealers;
+        joined.onlyDps += data.onlyDps;
+        joined.dungeons &= data.dungeonMask;
+
+        return joined.players <= MAXGROUPSIZE && joined.onlyTanks <= LFG_TANKS_NEEDED &&
+            joined.onlyHealers <= LFG_HEALERS_NEEDED && joined.onlyDps <= LFG_DPS_NEEDED && joined.dungeons.any();
+    }
+
+    std::vector<LfgGuidList> LFGQueue::TakeReplayMatches()
+    {
+        std::vector<LfgGuidList> matches;
+        matches.swap(replayMatches);
+
+        for (std::vector<LfgGuidList>::const_iterator it = matches.begin(); it != matches.end(); ++it)
+            for (LfgGuidList::const_iterator itGuid = it->begin(); itGuid != it->end(); ++itGuid)
+                RemoveFromQueue(*itGuid);
+
+        return matches;
     }
 
     void LFGQueue::UpdateWaitTimeAvg(int32 waitTime, uint32 dungeonId)
@@ -178,60 +336,71 @@ namespace lfg
     */
     void LFGQueue::RemoveFromCompatibles(uint64 guid)
     {
-        std::stringstream out;
-        out << guid;
-        std::string strGuid = out.str();
-
         SF_LOG_DEBUG("lfg.queue.data.compatibles.remove", "Removing [%u]", GUID_LOPART(guid));
-        for (LfgCompatibleContainer::iterator itNext = CompatibleMapStore.begin(); itNext != CompatibleMapStore.end();)
-        {
-            LfgCompatibleContainer::iterator it = itNext++;
-            if (std::string::npos != it->first.find(strGuid))
-                CompatibleMapStore.erase(it);
-        }
+
+        LfgQueueDataContainer::iterator itQueue = QueueDataStore.find(guid);
+        if (itQueue == QueueDataStore.end() || !itQueue->second.slot)
+            return;
+
+        std::vector<LfgCompatibleKey>& keys = slotCompatibles[itQueue->second.slot];
+        for (std::vector<LfgCompatibleKey>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+            CompatibleMapStore.erase(*it);
+        keys.clear();
     }
 
     /**
-       Stores the compatibility of a list of guids
+       Stores the compatibility of a combination of queued guids
 
-       @param[in]     key String concatenation of guids (| used as separator)
+       @param[in]     key Slots of the guids, nothing is stored for an empty key
        @param[in]     compatibles type of compatibility
     */
-    void LFGQueue::SetCompatibles(std::string const& key, LfgCompatibility compatibles)
+    void LFGQueue::SetCompatibles(LfgCompatibleKey const& key, LfgCompatibility compatibles)
     {
-        LfgCompatibilityData& data = CompatibleMapStore[key];
-        data.compatibility = compatibles;
+        if (!key.slots[0])
+            return;
+
+        std::pair<LfgCompatibleContainer::iterator, bool> result = CompatibleMapStore.insert(LfgCompatibleContainer::value_type(key, LfgCompatibilityData(compatibles)));
+        if (!result.second)
+        {
+            result.first->second.compatibility = compatibles;
+            return;
+        }
+
+        for (uint8 i = 0; i < LFG_COMPATIBLE_KEY_SIZE && key.slots[i]; ++i)
+            slotCompatibles[key.slots[i]].push_back(key);
     }
 
-    void LFGQueue::SetCompatibilityData(std::string const& key, LfgCompatibilityData const& data)
+    void LFGQueue::SetCompatibilityData(LfgCompatibleKey const& key, LfgCompatibilityData const& data)
     {
-        CompatibleMapStore[key] = data;
+        if (!key.slots[0])
+            return;
+
+        std::pair<LfgCompatibleContainer::iterator, bool> result = CompatibleMapStore.insert(LfgCompatibleContainer::value_type(key, data));
+        if (!result.second)
+        {
+            result.first->second = data;
+            return;
+        }
+
+        for (uint8 i = 0; i < LFG_COMPATIBLE_KEY_SIZE && key.slots[i]; ++i)
+            slotCompatibles[key.slots[i]].push_back(key);
     }
 
     /**
-       Get the compatibility of a group of guids
+       Get the compatibility of a combination of queued guids
 
-       @param[in]     key String concatenation of guids (| used as separator)
+       @param[in]     key Slots of the guids
        @return LfgCompatibility type of compatibility
     */
-    LfgCompatibility LFGQueue::GetCompatibles(std::string const& key)
+    LfgCompatibility LFGQueue::GetCompatibles(LfgCompatibleKey const& key) const
     {
-        LfgCompatibleContainer::iterator itr = CompatibleMapStore.find(key);
+        LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.find(key);
         if (itr != CompatibleMapStore.end())
             return itr->second.compatibility;
 
         return LFG_COMPATIBILITY_PENDING;
     }
 
-    LfgCompatibilityData* LFGQueue::GetCompatibilityData(std::string const& key)
-    {
-        LfgCompatibleContainer::iterator itr = CompatibleMapStore.find(key);
-        if (itr != CompatibleMapStore.end())
-            return &(itr->second);
-
-        return NULL;
-    }
-
     uint8 LFGQueue::FindGroups()
     {
         uint8 proposals = 0;
@@ -245,7 +414,9 @@ namespace lfg
             RemoveFromNewQueue(frontguid);
 
             LfgGuidList temporalList = currentQueueStore;
-            LfgCompatibility compatibles = FindNewGroups(firstNew, temporalList);
+            LfgQueueFilter filter;
+            CanJoin(LfgQueueFilter(), frontguid, filter);
+            LfgCompatibility compatibles = FindNewGroups(firstNew, temporalList, filter);
 
             if (compatibles == LFG_COMPATIBLES_MATCH)
                 ++proposals;
@@ -260,21 +431,23 @@ namespace lfg
 
        @param[in]     check List of guids trying to match with other groups
        @param[in]     all List of all other guids in main queue to match against
+       @param[in]     filter What the guids in check have together
        @return LfgCompatibility type of compatibility between groups
     */
-    LfgCompatibility LFGQueue::FindNewGroups(LfgGuidList& check, LfgGuidList& all)
+    LfgCompatibility LFGQueue::FindNewGroups(LfgGuidList& check, LfgGuidList& all, LfgQueueFilter const& filter)
     {
-        std::string strGuids = ConcatenateGuids(check);
-        LfgCompatibility compatibles = GetCompatibles(strGuids);
+        LfgCompatibleKey key;
+        MakeKey(check, key);
+        LfgCompatibility compatibles = GetCompatibles(key);
 
-        SF_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s): %s - all(%s)", strGuids.c_str(), GetCompatibleString(compatibles), ConcatenateGuids(all).c_str());
+        SF_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s): %s - all(%s)", ConcatenateGuids(check).c_str(), GetCompatibleString(compatibles), ConcatenateGuids(all).c_str());
         if (compatibles == LFG_COMPATIBILITY_PENDING) // Not previously cached, calculate
             compatibles = CheckCompatibility(check);
 
         if (compatibles == LFG_COMPATIBLES_BAD_STATES && sLFGMgr->AllQueued(check))
         {
-            SF_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s) compatibles (cached) changed from bad states to match", strGuids.c_str());
-            SetCompatibles(strGuids, LFG_COMPATIBLES_MATCH);
+            SF_LOG_DEBUG("lfg.queue.match.check", "Guids: (%s) compatibles (cached) changed from bad states to match", ConcatenateGuids(check).c_str());
+            SetCompatibles(key, LFG_COMPATIBLES_MATCH);
             return LFG_COMPATIBLES_MATCH;
         }
 
@@ -284,9 +457,19 @@ namespace lfg
         // Try to match with queued groups
         while (!all.empty())
         {
-            check.push_back(all.front());
+            uint64 guid = all.front();
             all.pop_front();
-            LfgCompatibility subcompatibility = FindNewGroups(check, all);
+
+            // CheckCompatibility would turn it down, no need to build and cache the combination
+            LfgQueueFilter joined;
+            if (!CanJoin(filter, guid, joined))
+            {
+                ++pruned;
+                continue;
+            }
+
+            check.push_back(guid);
+            LfgCompatibility subcompatibility = FindNewGroups(check, all, joined);
             if (subcompatibility == LFG_COMPATIBLES_MATCH)
                 return LFG_COMPATIBLES_MATCH;
             check.pop_back();
@@ -302,7 +485,9 @@ namespace lfg
     */
     LfgCompatibility LFGQueue::CheckCompatibility(LfgGuidList check)
     {
-        std::string strGuids = ConcatenateGuids(check);
+        LfgCompatibleKey key;
+        MakeKey(check, key);
+        std::string strGuids = SF_LOG_ENABLED("lfg.queue.match.compatibility.check", LogLevel::LOG_LEVEL_DEBUG) ? ConcatenateGuids(check) : std::string();
         LfgProposal proposal;
         LfgDungeonSet proposalDungeons;
         LfgGroupsMap proposalGroups;
@@ -326,7 +511,7 @@ namespace lfg
             if (child_compatibles < LFG_COMPATIBLES_WITH_LESS_PLAYERS) // Group not compatible
             {
                 SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) child %s not compatibles", strGuids.c_str(), ConcatenateGuids(check).c_str());
-                SetCompatibles(strGuids, child_compatibles);
+                SetCompatibles(key, child_compatibles);
                 return child_compatibles;
             }
             check.push_front(frontGuid);
@@ -370,22 +555,22 @@ namespace lfg
             data.roles = itQueue->second.roles;
             LFGMgr::CheckGroupRoles(data.roles);
 
-            UpdateBestCompatibleInQueue(itQueue, strGuids, data.roles);
-            SetCompatibilityData(strGuids, data);
+            UpdateBestCompatibleInQueue(itQueue, key, data.roles);
+            SetCompatibilityData(key, data);
             return LFG_COMPATIBLES_WITH_LESS_PLAYERS;
         }
 
         if (numLfgGroups > 1)
         {
             SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) More than one Lfggroup (%u)", strGuids.c_str(), numLfgGroups);
-            SetCompatibles(strGuids, LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS);
+            SetCompatibles(key, LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS);
             return LFG_INCOMPATIBLES_MULTIPLE_LFG_GROUPS;
         }
 
         if (numPlayers > MAXGROUPSIZE)
         {
             SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Too much players (%u)", strGuids.c_str(), numPlayers);
-            SetCompatibles(strGuids, LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS);
+            SetCompatibles(key, LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS);
             return LFG_INCOMPATIBLES_TOO_MUCH_PLAYERS;
         }
 
@@ -415,7 +600,7 @@ namespace lfg
             if (uint8 playersize = numPlayers - proposalRoles.size())
             {
                 SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) not compatible, %u players are ignoring each other", strGuids.c_str(), playersize);
-                SetCompatibles(strGuids, LFG_INCOMPATIBLES_HAS_IGNORES);
+                SetCompatibles(key, LFG_INCOMPATIBLES_HAS_IGNORES);
                 return LFG_INCOMPATIBLES_HAS_IGNORES;
             }
 
@@ -427,7 +612,7 @@ namespace lfg
                     o << ", " << it->first << ": " << GetRolesString(it->second);
 
                 SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Roles not compatible%s", strGuids.c_str(), o.str().c_str());
-                SetCompatibles(strGuids, LFG_INCOMPATIBLES_NO_ROLES);
+                SetCompatibles(key, LFG_INCOMPATIBLES_NO_ROLES);
                 return LFG_INCOMPATIBLES_NO_ROLES;
             }
 
@@ -447,7 +632,7 @@ namespace lfg
             if (proposalDungeons.empty())
             {
                 SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) No compatible dungeons%s", strGuids.c_str(), o.str().c_str());
-                SetCompatibles(strGuids, LFG_INCOMPATIBLES_NO_DUNGEONS);
+                SetCompatibles(key, LFG_INCOMPATIBLES_NO_DUNGEONS);
                 return LFG_INCOMPATIBLES_NO_DUNGEONS;
             }
         }
@@ -468,12 +653,27 @@ namespace lfg
             data.roles = proposalRoles;
 
             for (LfgGuidList::const_iterator itr = check.begin(); itr != check.end(); ++itr)
-                UpdateBestCompatibleInQueue(QueueDataStore.find(*itr), strGuids, data.roles);
+                UpdateBestCompatibleInQueue(QueueDataStore.find(*itr), key, data.roles);
 
-            SetCompatibilityData(strGuids, data);
+            SetCompatibilityData(key, data);
             return LFG_COMPATIBLES_WITH_LESS_PLAYERS;
         }
 
+        if (replay)
+        {
+            // nobody behind the guids to send a proposal to, the match is only taken out of the queue
+            SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) MATCH! (replay)", strGuids.c_str());
+            for (LfgGuidList::const_iterator itQueue = check.begin(); itQueue != check.end(); ++itQueue)
+            {
+                RemoveFromNewQueue(*itQueue);
+                RemoveFromCurrentQueue(*itQueue);
+            }
+
+            replayMatches.push_back(check);
+            SetCompatibles(key, LFG_COMPATIBLES_MATCH);
+            return LFG_COMPATIBLES_MATCH;
+        }
+
         uint64 gguid = *check.begin();
         proposal.queues = check;
         proposal.isNew = numLfgGroups != 1 || sLFGMgr->GetOldState(gguid) != LFG_STATE_DUNGEON;
@@ -481,7 +681,7 @@ namespace lfg
         if (!sLFGMgr->AllQueued(check))
         {
             SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) Group MATCH but can't create proposal!", strGuids.c_str());
-            SetCompatibles(strGuids, LFG_COMPATIBLES_BAD_STATES);
+            SetCompatibles(key, LFG_COMPATIBLES_BAD_STATES);
             return LFG_COMPATIBLES_BAD_STATES;
         }
 
@@ -523,7 +723,7 @@ namespace lfg
         sLFGMgr->AddProposal(proposal);
 
         SF_LOG_DEBUG("lfg.queue.match.compatibility.check", "Guids: (%s) MATCH! Group formed", strGuids.c_str());
-        SetCompatibles(strGuids, LFG_COMPATIBLES_MATCH);
+        SetCompatibles(key, LFG_COMPATIBLES_MATCH);
         return LFG_COMPATIBLES_MATCH;
     }
 
@@ -565,7 +765,7 @@ namespace lfg
                     break;
             }
 
-            if (queueinfo.bestCompatible.empty())
+            if (!queueinfo.bestCompatible.GetSize())
                 FindBestCompatibleInQueue(itQueue);
 
             LfgQueueStatusData queueData(queueId, dungeonId, queueinfo.joinTime, waitTime, wtAvg, wtTank, wtHealer, wtDps, queuedTime, queueinfo.tanks, queueinfo.healers, queueinfo.dps);
@@ -618,7 +818,7 @@ namespace lfg
         o << "Compatible Map size: " << CompatibleMapStore.size() << "\n";
         if (full)
             for (LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end(); ++itr)
-                o << "(" << itr->first << "): " << GetCompatibleString(itr->second.compatibility) << "\n";
+                o << "(" << KeyToString(itr->first) << "): " << GetCompatibleString(itr->second.compatibility) << "\n";
 
         return o.str();
     }
@@ -626,32 +826,37 @@ namespace lfg
     void LFGQueue::FindBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue)
     {
         SF_LOG_DEBUG("lfg.queue.compatibles.find", "Guid: " UI64FMTD, itrQueue->first);
-        std::ostringstream o;
-        o << itrQueue->first;
-        std::string sguid = o.str();
+        if (!itrQueue->second.slot)
+            return;
 
-        for (LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.begin(); itr != CompatibleMapStore.end(); ++itr)
-            if (itr->second.compatibility == LFG_COMPATIBLES_WITH_LESS_PLAYERS &&
-                std::string::npos != itr->first.find(sguid))
-            {
+        // only the combinations of its own slot, the ones that are not cached any more are dropped on the way
+        std::vector<LfgCompatibleKey>& keys = slotCompatibles[itrQueue->second.slot];
+        std::vector<LfgCompatibleKey>::iterator itKept = keys.begin();
+        for (std::vector<LfgCompatibleKey>::iterator itKey = keys.begin(); itKey != keys.end(); ++itKey)
+        {
+            LfgCompatibleContainer::const_iterator itr = CompatibleMapStore.find(*itKey);
+            if (itr == CompatibleMapStore.end())
+                continue;
+
+            *itKept++ = *itKey;
+            if (itr->second.compatibility == LFG_COMPATIBLES_WITH_LESS_PLAYERS)
                 UpdateBestCompatibleInQueue(itrQueue, itr->first, itr->second.roles);
-            }
+        }
+        keys.erase(itKept, keys.end());
     }
 
-    void LFGQueue::UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, std::string const& key, LfgRolesMap const& roles)
+    void LFGQueue::UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, LfgCompatibleKey const& key, LfgRolesMap const& roles)
     {
         LfgQueueData& queueData = itrQueue->second;
 
-        uint8 storedSize = queueData.bestCompatible.empty() ? 0 :
-            std::count(queueData.bestCompatible.begin(), queueData.bestCompatible.end(), '|') + 1;
-
-        uint8 size = std::count(key.begin(), key.end(), '|') + 1;
+        uint8 storedSize = queueData.bestCompatible.GetSize();
+        uint8 size = key.GetSize();
 
         if (size <= storedSize)
             return;
 
         SF_LOG_DEBUG("lfg.queue.compatibles.update", "Changed (%s) to (%s) as best compatible group for " UI64FMTD,
-            queueData.bestCompatible.c_str(), key.c_str(), itrQueue->first);
+            KeyToString(queueData.bestCompatible).c_str(), KeyToString(key).c_str(), itrQueue->first);
 
         queueData.bestCompatible = key;
         queueData.tanks = LFG_TANKS_NEEDED;
@@ -6,6 +6,9 @@
 #ifndef SF_LFGQUEUE_H
 #define SF_LFGQUEUE_H
 
+#include <bitset>
+#include <unordered_map>
+
 #include "LFG.h"
 
 namespace lfg
@@ -36,16 +39,58 @@ namespace lfg
         LfgRolesMap roles;
     };
 
+    #define LFG_COMPATIBLE_KEY_SIZE 5                          // MAXGROUPSIZE, a combination has at most one queued player per member
+    #define LFG_DUNGEON_MASK_BITS 1024                         // dungeons a queue tells apart, later ones match anything
+
+    typedef std::bitset<LFG_DUNGEON_MASK_BITS> LfgDungeonMask;
+
+    /// A combination of queued players and groups by their queue slots, sorted, unused slots are 0
+    struct LfgCompatibleKey
+    {
+        LfgCompatibleKey() { memset(slots, 0, sizeof(slots)); }
+
+        uint8 GetSize() const
+        {
+            uint8 size = 0;
+            while (size < LFG_COMPATIBLE_KEY_SIZE && slots[size])
+                ++size;
+            return size;
+        }
+
+        bool Contains(uint32 slot) const
+        {
+            for (uint8 i = 0; i < LFG_COMPATIBLE_KEY_SIZE && slots[i]; ++i)
+                if (slots[i] == slot)
+                    return true;
+            return false;
+        }
+
+        bool operator==(LfgCompatibleKey const& right) const { return !memcmp(slots, right.slots, sizeof(slots)); }
+
+        uint32 slots[LFG_COMPATIBLE_KEY_SIZE];
+    };
+
+    struct LfgCompatibleKeyHash
+    {
+        std::size_t operator()(LfgCompatibleKey const& key) const
+        {
+            uint64 hash = 0xCBF29CE484222325ULL;
+            for (uint8 i = 0; i < LFG_COMPATIBLE_KEY_SIZE; ++i)
+                hash = (hash ^ key.slots[i]) * 0x100000001B3ULL;
+            return std::size_t(hash ^ (hash >> 32));
+        }
+    };
+
     /// Stores player or group queue info
     struct LfgQueueData
     {
         LfgQueueData() : joinTime(time_t(time(NULL))), tanks(LFG_TANKS_NEEDED),
-            healers(LFG_HEALERS_NEEDED), dps(LFG_DPS_NEEDED)
+            healers(LFG_HEALERS_NEEDED), dps(LFG_DPS_NEEDED), slot(0), onlyTanks(0), onlyHealers(0), onlyDps(0)
         { }
 
         LfgQueueData(time_t _joinTime, LfgDungeonSet const& _dungeons, LfgRolesMap const& _roles) :
             joinTime(_joinTime), tanks(LFG_TANKS_NEEDED), healers(LFG_HEALERS_NEEDED),
-            dps(LFG_DPS_NEEDED), dungeons(_dungeons), roles(_roles)
+            dps(LFG_DPS_NEEDED), dungeons(_dungeons), roles(_roles), slot(0), onlyTanks(0), onlyHealers(0), onlyDps(0)
         { }
 
         time_t joinTime;                                       ///< Player queue join time (to calculate wait times)
@@ -54,7 +99,25 @@ namespace lfg
         uint8 dps;                                             ///< Dps needed
         LfgDungeonSet dungeons;                                ///< Selected Player/Group Dungeon/s
         LfgRolesMap roles;                                     ///< Selected Player Role/s
-        std::string bestCompatible;                            ///< Best compatible combination of people queued
+        LfgCompatibleKey bestCompatible;                       ///< Best compatible combination of people queued
+
+        uint32 slot;                                           ///< Index in the queue, used in compatible keys
+        uint8 onlyTanks;                                       ///< Players that can only tank
+        uint8 onlyHealers;                                     ///< Players that can only heal
+        uint8 onlyDps;                                         ///< Players that can only deal damage
+        LfgDungeonMask dungeonMask;                            ///< Selected dungeons as bits of the queue
+    };
+
+    /// What the queued players and groups of a combination have together, checked before trying to add more
+    struct LfgQueueFilter
+    {
+        LfgQueueFilter() : players(0), onlyTanks(0), onlyHealers(0), onlyDps(0) { dungeons.set(); }
+
+        uint8 players;
+        uint8 onlyTanks;
+        uint8 onlyHealers;
+        uint8 onlyDps;
+        LfgDungeonMask dungeons;                               ///< Dungeons all of them selected
     };
 
     struct LfgWaitTime
@@ -65,7 +128,7 @@ namespace lfg
     };
 
     typedef std::map<uint32, LfgWaitTime> LfgWaitTimesContainer;
-    typedef std::map<std::string, LfgCompatibilityData> LfgCompatibleContainer;
+    typedef std::unordered_map<LfgCompatibleKey, LfgCompatibilityData, LfgCompatibleKeyHash> LfgCompatibleContainer;
     typedef std::map<uint64, LfgQueueData> LfgQueueDataContainer;
 
     /**
@@ -74,6 +137,8 @@ namespace lfg
     class LFGQueue
     {
     public:
+        LFGQueue() : replay(false), pruned(0) { }
+
         // Add/Remove from queue
         void AddToQueue(uint64 guid, bool reQueue = false);
         void RemoveFromQueue(uint64 guid);
@@ -97,6 +162,14 @@ namespace lfg
         std::string DumpQueueInfo() const;
         std::string DumpCompatibleInfo(bool full = false) const;
 
+        /// Matches are only counted and their players left in the queue data, for replaying a queue without players - Only for internal testing
+        void SetReplay(bool enable) { replay = enable; }
+        /// Matches found in replay, removes them from the queue
+        std::vector<LfgGuidList> TakeReplayMatches();
+        /// Combinations that were not checked as a player or group could not join them
+        uint64 GetPrunedCount() const { return pruned; }
+        uint32 GetCompatibleCount() const { return uint32(CompatibleMapStore.size()); }
+
     private:
         void SetQueueUpdateData(std::string const& strGuids, LfgRolesMap const& proposalRoles);
         LfgRolesMap const& RemoveFromQueueUpdateData(uint64 guid);
@@ -106,16 +179,21 @@ namespace lfg
         void RemoveFromNewQueue(uint64 guid);
         void RemoveFromCurrentQueue(uint64 guid);
 
-        void SetCompatibles(std::string const& key, LfgCompatibility compatibles);
-        LfgCompatibility GetCompatibles(std::string const& key);
+        void AssignSlot(uint64 guid, LfgQueueData& data);
+        void ReleaseSlot(LfgQueueData const& data);
+        bool MakeKey(LfgGuidList const& check, LfgCompatibleKey& key) const;
+        std::string KeyToString(LfgCompatibleKey const& key) const;
+        bool CanJoin(LfgQueueFilter const& filter, uint64 guid, LfgQueueFilter& joined) const;
+
+        void SetCompatibles(LfgCompatibleKey const& key, LfgCompatibility compatibles);
+        LfgCompatibility GetCompatibles(LfgCompatibleKey const& key) const;
         void RemoveFromCompatibles(uint64 guid);
 
-        void SetCompatibilityData(std::string const& key, LfgCompatibilityData const& compatibles);
-        LfgCompatibilityData* GetCompatibilityData(std::string const& key);
+        void SetCompatibilityData(LfgCompatibleKey const& key, LfgCompatibilityData const& compatibles);
         void FindBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue);
-        void UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, std::string const& key, LfgRolesMap const& roles);
+        void UpdateBestCompatibleInQueue(LfgQueueDataContainer::iterator itrQueue, LfgCompatibleKey const& key, LfgRolesMap const& roles);
 
-        LfgCompatibility FindNewGroups(LfgGuidList& check, LfgGuidList& all);
+        LfgCompatibility FindNewGroups(LfgGuidList& check, LfgGuidList& all, LfgQueueFilter const& filter);
         LfgCompatibility CheckCompatibility(LfgGuidList check);
 
         // Queue
@@ -128,6 +206,15 @@ namespace lfg
         LfgWaitTimesContainer waitTimesDpsStore;           ///< Average wait time to find a group queuing as dps
         LfgGuidList currentQueueStore;                     ///< Ordered list. Used to find groups
         LfgGuidList newToQueueStore;                       ///< New groups to add to queue
+
+        std::vector<uint64> slotGuids;                     ///< Guid queued in each slot, 0 if free, slot 0 is never used
+        std::vector<uint32> freeSlots;                     ///< Slots to use again
+        std::vector<std::vector<LfgCompatibleKey>> slotCompatibles; ///< Cached combinations each slot is part of (may list removed ones)
+        std::map<uint32, uint16> dungeonBits;              ///< Bit of each dungeon in the dungeon masks
+
+        bool replay;
+        std::vector<LfgGuidList> replayMatches;
+        uint64 pruned;
     };
 
 } // namespace lfg
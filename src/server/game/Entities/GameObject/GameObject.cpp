@@ -2076,7 +2076,15 @@ void GameObject::EnableCollision(bool enable)
     /*if (enable && !GetMap()->ContainsGameObjectModel(*m_model))
         GetMap()->InsertGameObjectModel(*m_model);*/
 
-    m_model->enable(enable ? GetPhaseMask() : 0);
+    uint32 phaseMask = enable ? GetPhaseMask() : 0;
+    if (m_model->getPhaseMask() == phaseMask)
+        return;
+
+    m_model->enable(phaseMask);
+
+    // a door opened or closed, cached line of sight through it is outdated
+    if (IsInWorld())
+        GetMap()->InvalidateQueryCache();
 }
 
 void GameObject::UpdateModel()
@@ -2157,61 +2165,56 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
     ByteBuffer fieldBuffer;
 
     UpdateMask updateMask;
-    updateMask.SetCount(m_valuesCount);
 
-    uint32* flags = GameObjectUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC | UF_FLAG_VIEWER_DEPENDENT;
     if (GetOwnerGUID() == target->GetGUID())
         visibleFlag |= UF_FLAG_OWNER;
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    BuildValuesUpdateMask(updateType, visibleFlag, updateMask);
+    if (forcedFlags)
+        updateMask.SetBit(GAMEOBJECT_FIELD_FLAGS);
+
+    updateMask.ForEachSetBit([&](uint32 index)
     {
-        if ((m_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-            (index == GAMEOBJECT_FIELD_FLAGS && forcedFlags)))
+        if (index == OBJECT_FIELD_DYNAMIC_FLAGS)
         {
-            updateMask.SetBit(index);
-
-            if (index == OBJECT_FIELD_DYNAMIC_FLAGS)
+            uint16 dynFlags = 0;
+            int16 pathProgress = -1;
+            switch (GetGoType())
             {
-                uint16 dynFlags = 0;
-                int16 pathProgress = -1;
-                switch (GetGoType())
-                {
-                    case GAMEOBJECT_TYPE_CHEST:
-                    case GAMEOBJECT_TYPE_GOOBER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
-                        else if (targetIsGM)
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_GENERIC:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_SPARKLE;
-                        break;
-                    case GAMEOBJECT_TYPE_MO_TRANSPORT:
-                        pathProgress = int16(float(m_goValue.Transport.PathProgress) / float(GetUInt32Value(GAMEOBJECT_FIELD_LEVEL)) * 65535.0f);
-                        break;
-                    default:
-                        break;
-                }
-
-                fieldBuffer << uint16(dynFlags);
-                fieldBuffer << int16(pathProgress);
+                case GAMEOBJECT_TYPE_CHEST:
+                case GAMEOBJECT_TYPE_GOOBER:
+                    if (ActivateToQuest(target))
+                        dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
+                    else if (targetIsGM)
+                        dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+                    break;
+                case GAMEOBJECT_TYPE_GENERIC:
+                    if (ActivateToQuest(target))
+                        dynFlags |= GO_DYNFLAG_LO_SPARKLE;
+                    break;
+                case GAMEOBJECT_TYPE_MO_TRANSPORT:
+                    pathProgress = int16(float(m_goValue.Transport.PathProgress) / float(GetUInt32Value(GAMEOBJECT_FIELD_LEVEL)) * 65535.0f);
+                    break;
+                default:
+                    break;
             }
-            else if (index == GAMEOBJECT_FIELD_FLAGS)
-            {
-                uint32 flags = m_uint32Values[GAMEOBJECT_FIELD_FLAGS];
-                if (GetGoType() == GAMEOBJECT_TYPE_CHEST)
-                    if (GetGOInfo()->chest.groupLootRules && !IsLootAllowedFor(target))
-                        flags |= GO_FLAG_LOCKED | GO_FLAG_NOT_SELECTABLE;
 
-                fieldBuffer << flags;
-            }
-            else
-                fieldBuffer << m_uint32Values[index];                // other cases
+            fieldBuffer << uint16(dynFlags);
+            fieldBuffer << int16(pathProgress);
         }
-    }
+        else if (index == GAMEOBJECT_FIELD_FLAGS)
+        {
+            uint32 flags = m_uint32Values[GAMEOBJECT_FIELD_FLAGS];
+            if (GetGoType() == GAMEOBJECT_TYPE_CHEST)
+                if (GetGOInfo()->chest.groupLootRules && !IsLootAllowedFor(target))
+                    flags |= GO_FLAG_LOCKED | GO_FLAG_NOT_SELECTABLE;
+
+            fieldBuffer << flags;
+        }
+        else
+            fieldBuffer << m_uint32Values[index];                // other cases
+    });
 
     *data << uint8(updateMask.GetBlockCount());
     updateMask.AppendToPacket(data);
@@ -2219,6 +2222,29 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
     *data << uint8(0);
 }
 
+bool GameObject::CanShareValuesUpdate() const
+{
+    // flags are always sent per viewer while a group loot chest has a recipient
+    if (GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.groupLootRules && HasLootRecipient())
+        return false;
+
+    return Object::CanShareValuesUpdate();
+}
+
+// must match the per target cases of GameObject::BuildValuesUpdate
+bool GameObject::IsViewerDependentUpdateField(uint16 index) const
+{
+    switch (index)
+    {
+        case OBJECT_FIELD_DYNAMIC_FLAGS:
+            return GetGoType() == GAMEOBJECT_TYPE_CHEST || GetGoType() == GAMEOBJECT_TYPE_GOOBER || GetGoType() == GAMEOBJECT_TYPE_GENERIC;
+        case GAMEOBJECT_FIELD_FLAGS:
+            return GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.groupLootRules;
+        default:
+            return false;
+    }
+}
+
 void GameObject::GetRespawnPosition(float& x, float& y, float& z, float* ori /* = NULL*/) const
 {
     if (m_DBTableGuid)
@@ -2246,11 +2272,11 @@ void GameObject::UpdateModelPosition()
     if (!m_model)
         return;
 
+    // transports and elevators move every update, their cell is refitted rather than rebuilt
     if (GetMap()->ContainsGameObjectModel(*m_model))
     {
-        GetMap()->RemoveGameObjectModel(*m_model);
         m_model->Relocate();
-        GetMap()->InsertGameObjectModel(*m_model);
+        GetMap()->RelocateGameObjectModel(*m_model);
     }
 }
 uint32 GameObject::GetGOStateValue(GOState state)
@@ -624,6 +624,8 @@ public:
     ~GameObject();
 
     void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const OVERRIDE;
+    bool IsViewerDependentUpdateField(uint16 index) const OVERRIDE;
+    bool CanShareValuesUpdate() const OVERRIDE;
 
     void AddToWorld() OVERRIDE;
     void RemoveFromWorld() OVERRIDE;
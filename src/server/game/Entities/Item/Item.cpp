@@ -1095,6 +1095,15 @@ void Item::BuildUpdate(UpdateDataMapType& data_map)
     ClearUpdateMask(false);
 }
 
+// item changes are only ever sent to the owner, let the owner's map send them
+Map* Item::GetObjectUpdateMap() const
+{
+    if (Player* owner = GetOwner())
+        return owner->FindMap();
+
+    return NULL;
+}
+
 void Item::SaveRefundDataToDB()
 {
     SQLTransaction trans = CharacterDatabase.BeginTransaction();
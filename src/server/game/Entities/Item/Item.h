@@ -341,6 +341,7 @@ public:
     bool CheckSoulboundTradeExpire();
 
     void BuildUpdate(UpdateDataMapType&);
+    Map* GetObjectUpdateMap() const OVERRIDE;
 
     uint32 GetScriptId() const { return GetTemplate()->ScriptId; }
 
@@ -60,7 +60,7 @@ TypeID GuidHigh2TypeId(uint32 guid_hi)
 }
 
 Object::Object() : m_PackGUID(sizeof(uint64) + 1), m_objectTypeId(TypeID::TYPEID_OBJECT), m_objectType(TYPEMASK_OBJECT), m_uint32Values(NULL),
-m_valuesCount(0), m_fieldNotifyFlags(UF_FLAG_URGENT), m_inWorld(false), m_objectUpdated(false), m_updateFlag(UPDATEFLAG_NONE)
+m_valuesCount(0), m_fieldNotifyFlags(UF_FLAG_URGENT), m_inWorld(false), m_objectUpdated(false), m_objectUpdateMap(NULL), m_updateFlag(UPDATEFLAG_NONE)
 {
     m_PackGUID.appendPackGUID(0);
 }
@@ -95,7 +95,7 @@ Object::~Object()
     {
         SF_LOG_FATAL("misc", "Object::~Object - guid=" UI64FMTD ", typeid=%d, entry=%u deleted but still in update list!!", GetGUID(), uint8(GetTypeId()), GetEntry());
         ASSERT(false);
-        sObjectAccessor->RemoveUpdateObject(this);
+        RemoveFromObjectUpdate();
     }
 
     delete[] m_uint32Values;
@@ -785,20 +785,15 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
 
     ByteBuffer fieldBuffer;
     UpdateMask updateMask;
-    updateMask.SetCount(m_valuesCount);
 
     uint32* flags = NULL;
     uint32 visibleFlag = GetUpdateFieldData(target, flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    BuildValuesUpdateMask(updateType, visibleFlag, updateMask);
+    updateMask.ForEachSetBit([&](uint32 index)
     {
-        if ((m_fieldNotifyFlags & flags[index] ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag))))
-        {
-            updateMask.SetBit(index);
-            fieldBuffer << m_uint32Values[index];
-        }
-    }
+        fieldBuffer << m_uint32Values[index];
+    });
 
     *data << uint8(updateMask.GetBlockCount());
     updateMask.AppendToPacket(data);
@@ -870,12 +865,37 @@ void Object::ClearUpdateMask(bool remove)
             memset(m_dynamicChange[i], 0, 32 * sizeof(bool));
 
         if (remove)
-            sObjectAccessor->RemoveUpdateObject(this);
+            RemoveFromObjectUpdate();
         m_objectUpdated = false;
     }
 }
 
-void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
+void Object::AddToObjectUpdateIfNeeded()
+{
+    if (!m_inWorld || m_objectUpdated)
+        return;
+
+    // remember where we were queued, the object may change map before the changes are sent
+    m_objectUpdateMap = GetObjectUpdateMap();
+    if (m_objectUpdateMap)
+        m_objectUpdateMap->AddUpdateObject(this);
+    else
+        sObjectAccessor->AddUpdateObject(this);
+
+    m_objectUpdated = true;
+}
+
+void Object::RemoveFromObjectUpdate()
+{
+    if (m_objectUpdateMap)
+        m_objectUpdateMap->RemoveUpdateObject(this);
+    else
+        sObjectAccessor->RemoveUpdateObject(this);
+
+    m_objectUpdateMap = NULL;
+}
+
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, ValuesUpdateBlockCache* cache /*= NULL*/) const
 {
     UpdateDataMapType::iterator iter = data_map.find(player);
 
@@ -886,7 +906,134 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (!cache)
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        return;
+    }
+
+    // observers with the same visibility flags get the same bytes, build them once
+    uint32* flags = NULL;
+    uint32 visibleFlag = GetUpdateFieldData(player, flags);
+
+    ValuesUpdateBlockCache::iterator block = cache->find(visibleFlag);
+    if (block == cache->end())
+    {
+        ByteBuffer buf(500);
+        buf << uint8(UPDATETYPE_VALUES);
+        buf.append(GetPackGUID());
+        BuildValuesUpdate(UPDATETYPE_VALUES, &buf, player);
+        block = cache->insert(ValuesUpdateBlockCache::value_type(visibleFlag, buf)).first;
+    }
+
+    iter->second.AddUpdateBlock(block->second);
+}
+
+bool Object::CanShareValuesUpdate() const
+{
+    UpdateFieldMaskTable const* masks = GetUpdateFieldMasks();
+    if (!masks)
+        return false;
+
+    // same selection as BuildValuesUpdate for UPDATETYPE_VALUES, any observer
+    for (uint32 block = 0; block < _changesMask.GetBlockCount(); ++block)
+    {
+        uint32 sent = _changesMask.GetBlock(block) | masks->GetBlock(m_fieldNotifyFlags, block);
+        for (; sent; sent &= sent - 1)
+            if (IsViewerDependentUpdateField(uint16(block * UpdateMask::CLIENT_UPDATE_MASK_BITS + std::countr_zero(sent))))
+                return false;
+    }
+
+    return true;
+}
+
+uint32* Object::GetUpdateFieldFlags() const
+{
+    switch (GetTypeId())
+    {
+        case TypeID::TYPEID_ITEM:
+        case TypeID::TYPEID_CONTAINER:
+            return ItemUpdateFieldFlags;
+        case TypeID::TYPEID_UNIT:
+        case TypeID::TYPEID_PLAYER:
+            return UnitUpdateFieldFlags;
+        case TypeID::TYPEID_GAMEOBJECT:
+            return GameObjectUpdateFieldFlags;
+        case TypeID::TYPEID_DYNAMICOBJECT:
+            return DynamicObjectUpdateFieldFlags;
+        case TypeID::TYPEID_CORPSE:
+            return CorpseUpdateFieldFlags;
+        case TypeID::TYPEID_AREATRIGGER:
+            return AreaTriggerUpdateFieldFlags;
+        default:
+            return NULL;
+    }
+}
+
+UpdateFieldMaskTable const* Object::GetUpdateFieldMasks() const
+{
+    switch (GetTypeId())
+    {
+        case TypeID::TYPEID_ITEM:
+        case TypeID::TYPEID_CONTAINER:
+            return &ItemUpdateFieldMasks;
+        case TypeID::TYPEID_UNIT:
+        case TypeID::TYPEID_PLAYER:
+            return &UnitUpdateFieldMasks;
+        case TypeID::TYPEID_GAMEOBJECT:
+            return &GameObjectUpdateFieldMasks;
+        case TypeID::TYPEID_DYNAMICOBJECT:
+            return &DynamicObjectUpdateFieldMasks;
+        case TypeID::TYPEID_CORPSE:
+            return &CorpseUpdateFieldMasks;
+        case TypeID::TYPEID_AREATRIGGER:
+            return &AreaTriggerUpdateFieldMasks;
+        default:
+            return NULL;
+    }
+}
+
+void Object::BuildValuesUpdateMask(uint8 updateType, uint32 visibleFlag, UpdateMask& updateMask) const
+{
+    updateMask.SetCount(m_valuesCount);
+
+    UpdateFieldMaskTable const* masks = GetUpdateFieldMasks();
+    if (!masks)
+        return;
+
+    // a field is sent if it always notifies, or if it changed (is set, for creation) and the observer may see it;
+    // special info fields are sent to empathy casters even when unchanged
+    uint32 alwaysSent = m_fieldNotifyFlags | (visibleFlag & UF_FLAG_SPECIAL_INFO);
+    for (uint32 block = 0; block < updateMask.GetBlockCount(); ++block)
+    {
+        uint32 present = updateType == UPDATETYPE_VALUES ? _changesMask.GetBlock(block) : UpdateMask::GetNonZeroBlock(m_uint32Values, m_valuesCount, block);
+        updateMask.SetBlock(block, masks->GetBlock(alwaysSent, block) | (present & masks->GetBlock(visibleFlag, block)));
+    }
+
+    // tables are sized for the largest type sharing them (containers, players), drop the fields past our end
+    if (uint32 tail = m_valuesCount % UpdateMask::CLIENT_UPDATE_MASK_BITS)
+    {
+        uint32 last = updateMask.GetBlockCount() - 1;
+        updateMask.SetBlock(last, updateMask.GetBlock(last) & ((uint32(1) << tail) - 1));
+    }
+}
+
+void Object::BuildValuesUpdateMaskFor(Player const* target, uint8 updateType, UpdateMask& updateMask, bool perField) const
+{
+    uint32* flags = NULL;
+    uint32 visibleFlag = GetUpdateFieldData(target, flags);
+    if (!perField || !flags)
+    {
+        BuildValuesUpdateMask(updateType, visibleFlag, updateMask);
+        return;
+    }
+
+    updateMask.SetCount(m_valuesCount);
+
+    uint32 alwaysSent = m_fieldNotifyFlags | (visibleFlag & UF_FLAG_SPECIAL_INFO);
+    for (uint16 index = 0; index < m_valuesCount; ++index)
+        if ((alwaysSent & flags[index]) || ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
+            updateMask.SetBit(index);
 }
 
 uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
@@ -896,11 +1043,12 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
     if (target == this)
         visibleFlag |= UF_FLAG_PRIVATE;
 
+    flags = GetUpdateFieldFlags();
+
     switch (GetTypeId())
     {
         case TypeID::TYPEID_ITEM:
         case TypeID::TYPEID_CONTAINER:
-            flags = ItemUpdateFieldFlags;
             if (((Item*)this)->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER | UF_FLAG_ITEM_OWNER;
             break;
@@ -908,7 +1056,6 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
         case TypeID::TYPEID_PLAYER:
         {
             Player* plr = ToUnit()->GetCharmerOrOwnerPlayerOrPlayerItself();
-            flags = UnitUpdateFieldFlags;
             if (ToUnit()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
 
@@ -921,25 +1068,17 @@ uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
             break;
         }
         case TypeID::TYPEID_GAMEOBJECT:
-            flags = GameObjectUpdateFieldFlags;
             if (ToGameObject()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TypeID::TYPEID_DYNAMICOBJECT:
-            flags = DynamicObjectUpdateFieldFlags;
             if (((DynamicObject*)this)->GetCasterGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
         case TypeID::TYPEID_CORPSE:
-            flags = CorpseUpdateFieldFlags;
             if (ToCorpse()->GetOwnerGUID() == target->GetGUID())
                 visibleFlag |= UF_FLAG_OWNER;
             break;
-        case TypeID::TYPEID_AREATRIGGER:
-            flags = AreaTriggerUpdateFieldFlags;
-            break;
-        case TypeID::TYPEID_OBJECT:
-            break;
         default:
             break;
     }
@@ -973,11 +1112,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
         m_int32Values[index] = value;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -990,11 +1125,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
         m_uint32Values[index] = value;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1006,11 +1137,7 @@ void Object::SetDynamicUInt32Value(uint32 tab, uint16 index, uint32 value)
     {
         m_dynamicTab[tab][index] = value;
         m_dynamicChange[tab][index] = true;
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1032,11 +1159,7 @@ void Object::SetUInt64Value(uint16 index, uint64 value)
         _changesMask.SetBit(index);
         _changesMask.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1050,11 +1173,7 @@ bool Object::AddUInt64Value(uint16 index, uint64 value)
         _changesMask.SetBit(index);
         _changesMask.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
 
         return true;
     }
@@ -1072,11 +1191,7 @@ bool Object::RemoveUInt64Value(uint16 index, uint64 value)
         _changesMask.SetBit(index);
         _changesMask.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
 
         return true;
     }
@@ -1093,11 +1208,7 @@ void Object::SetFloatValue(uint16 index, float value)
         m_floatValues[index] = value;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1117,11 +1228,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1141,11 +1248,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1215,11 +1318,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
         m_uint32Values[index] = newval;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1236,11 +1335,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
         m_uint32Values[index] = newval;
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1280,11 +1375,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1303,11 +1394,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
         _changesMask.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -2267,11 +2354,7 @@ void WorldObject::SendPlaySound(uint32 Sound, bool OnlySelf)
 void Object::ForceValuesUpdateAtIndex(uint32 i)
 {
     _changesMask.SetBit(i);
-    if (m_inWorld && !m_objectUpdated)
-    {
-        sObjectAccessor->AddUpdateObject(this);
-        m_objectUpdated = true;
-    }
+    AddToObjectUpdateIfNeeded();
 }
 
 namespace Skyfire
@@ -3443,7 +3526,8 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
     std::set<uint64> plr_list;
-    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj) { }
+    ValuesUpdateBlockCache* i_blockCache;
+    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d, ValuesUpdateBlockCache* cache) : i_updateDatas(d), i_object(obj), i_blockCache(cache) { }
     void Visit(PlayerMapType& m)
     {
         Player* source = NULL;
@@ -3500,7 +3584,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(player->GetGUID()) == plr_list.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            i_object.BuildFieldsUpdate(player, i_updateDatas, i_blockCache);
             plr_list.insert(player->GetGUID());
         }
     }
@@ -3513,7 +3597,9 @@ void WorldObject::BuildUpdate(UpdateDataMapType& data_map)
     CellCoord p = Skyfire::ComputeCellCoord(GetPositionX(), GetPositionY());
     Cell cell(p);
     cell.SetNoCreate();
-    WorldObjectChangeAccumulator notifier(*this, data_map);
+    // raid bosses and city npcs are watched by dozens of players sharing the same visibility flags
+    ValuesUpdateBlockCache blockCache;
+    WorldObjectChangeAccumulator notifier(*this, data_map, CanShareValuesUpdate() ? &blockCache : NULL);
     TypeContainerVisitor<WorldObjectChangeAccumulator, WorldTypeMapContainer > player_notifier(notifier);
     Map& map = *GetMap();
     //we must build packets for all visible players
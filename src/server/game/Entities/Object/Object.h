@@ -99,11 +99,14 @@ class TempSummon;
 class Transport;
 class Unit;
 class UpdateData;
+class UpdateFieldMaskTable;
 class WorldObject;
 class WorldPacket;
 class ZoneScript;
 
 typedef UNORDERED_MAP<Player*, UpdateData> UpdateDataMapType;
+// values update blocks of one object for one tick, by visibility flags of the observers
+typedef UNORDERED_MAP<uint32, ByteBuffer> ValuesUpdateBlockCache;
 
 class Object
 {
@@ -192,7 +195,11 @@ public:
     virtual bool hasQuest(uint32 /* quest_id */) const { return false; }
     virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
     virtual void BuildUpdate(UpdateDataMapType&) { }
-    void BuildFieldsUpdate(Player*, UpdateDataMapType&) const;
+    void BuildFieldsUpdate(Player*, UpdateDataMapType&, ValuesUpdateBlockCache* cache = NULL) const;
+    virtual bool CanShareValuesUpdate() const;
+    // the fields BuildValuesUpdate selects for target, or the same selection field by field as it was done
+    // before the mask blocks; for checking and timing the block selection
+    void BuildValuesUpdateMaskFor(Player const* target, uint8 updateType, UpdateMask& updateMask, bool perField = false) const;
 
     void SetFieldNotifyFlag(uint16 flag) { m_fieldNotifyFlags |= flag; }
     void RemoveFieldNotifyFlag(uint16 flag) { m_fieldNotifyFlags &= ~flag; }
@@ -230,6 +237,12 @@ protected:
     void _LoadIntoDataField(std::string const& data, uint32 startOffset, uint32 count);
 
     uint32 GetUpdateFieldData(Player const* target, uint32*& flags) const;
+    uint32* GetUpdateFieldFlags() const;
+    UpdateFieldMaskTable const* GetUpdateFieldMasks() const;
+    // fields sent for UPDATETYPE_VALUES/CREATE_OBJECT to an observer with visibleFlag, selected a block at a time
+    void BuildValuesUpdateMask(uint8 updateType, uint32 visibleFlag, UpdateMask& updateMask) const;
+    // true if BuildValuesUpdate currently writes a value for this field that depends on the observer
+    virtual bool IsViewerDependentUpdateField(uint16 /*index*/) const { return false; }
 
     void BuildMovementUpdate(ByteBuffer* data, uint16 flags) const;
     void BuildDynamicValuesUpdate(ByteBuffer* data) const;
@@ -258,8 +271,14 @@ protected:
 
     bool m_objectUpdated;
 
+    void AddToObjectUpdateIfNeeded();
+    void RemoveFromObjectUpdate();
+    // map whose update pass sends our value changes, NULL for the global ObjectAccessor pass
+    virtual Map* GetObjectUpdateMap() const { return NULL; }
+
 private:
     bool m_inWorld;
+    Map* m_objectUpdateMap;
 
     ByteBuffer m_PackGUID;
 
@@ -745,6 +764,7 @@ public:
     virtual void ResetMap();
     Map* GetMap() const { ASSERT(m_currMap); return m_currMap; }
     Map* FindMap() const { return m_currMap; }
+    Map* GetObjectUpdateMap() const OVERRIDE { return m_currMap; }
     //used to check all object's GetMap() calls when object is not in world!
 
     //this function should be removed in nearest time...
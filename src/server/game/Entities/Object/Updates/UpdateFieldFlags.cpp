@@ -4,6 +4,9 @@
 */
 
 #include "UpdateFieldFlags.h"
+#include "UpdateMask.h"
+
+#include <bit>
 
 uint32 ItemUpdateFieldFlags[CONTAINER_END] =
 {
@@ -2279,4 +2282,38 @@ uint32 PlayerDynamicField[PLAYER_DYNAMIC_END] =
     UF_FLAG_PRIVATE, // PLAYER_DYNAMIC_FIELD_RESERACH_SITE
     UF_FLAG_PRIVATE, // PLAYER_DYNAMIC_FIELD_RESEARCH_SITE_PROGRESS
     UF_FLAG_PRIVATE, // PLAYER_DYNAMIC_FIELD_DAILY_QUESTS
-};
\ No newline at end of file
+};
+
+UpdateFieldMaskTable::UpdateFieldMaskTable(uint32 const* flags, uint32 count) : _count(count)
+{
+    _blockCount = (count + UpdateMask::CLIENT_UPDATE_MASK_BITS - 1) / UpdateMask::CLIENT_UPDATE_MASK_BITS;
+    _bitmaps.resize(_blockCount * UF_FLAG_BIT_COUNT, 0);
+
+    for (uint32 index = 0; index < count; ++index)
+    {
+        uint32 block = index / UpdateMask::CLIENT_UPDATE_MASK_BITS;
+        uint32 bit = uint32(1) << (index % UpdateMask::CLIENT_UPDATE_MASK_BITS);
+
+        for (uint32 flag = 0; flag < UF_FLAG_BIT_COUNT; ++flag)
+            if (flags[index] & (1 << flag))
+                _bitmaps[block * UF_FLAG_BIT_COUNT + flag] |= bit;
+    }
+}
+
+uint32 UpdateFieldMaskTable::GetBlock(uint32 flagMask, uint32 block) const
+{
+    uint32 const* bitmaps = &_bitmaps[block * UF_FLAG_BIT_COUNT];
+    uint32 result = 0;
+
+    for (flagMask &= (1 << UF_FLAG_BIT_COUNT) - 1; flagMask; flagMask &= flagMask - 1)
+        result |= bitmaps[std::countr_zero(flagMask)];
+
+    return result;
+}
+
+UpdateFieldMaskTable const ItemUpdateFieldMasks(ItemUpdateFieldFlags, CONTAINER_END);
+UpdateFieldMaskTable const UnitUpdateFieldMasks(UnitUpdateFieldFlags, PLAYER_END);
+UpdateFieldMaskTable const GameObjectUpdateFieldMasks(GameObjectUpdateFieldFlags, GAMEOBJECT_END);
+UpdateFieldMaskTable const DynamicObjectUpdateFieldMasks(DynamicObjectUpdateFieldFlags, DYNAMICOBJECT_END);
+UpdateFieldMaskTable const CorpseUpdateFieldMasks(CorpseUpdateFieldFlags, CORPSE_END);
+UpdateFieldMaskTable const AreaTriggerUpdateFieldMasks(AreaTriggerUpdateFieldFlags, AREATRIGGER_END);
@@ -9,6 +9,8 @@
 #include "Define.h"
 #include "UpdateFields.h"
 
+#include <vector>
+
 enum UpdatefieldFlags
 {
     UF_FLAG_NONE = 0x000,
@@ -31,4 +33,38 @@ extern uint32 DynamicObjectUpdateFieldFlags[DYNAMICOBJECT_END];
 extern uint32 CorpseUpdateFieldFlags[CORPSE_END];
 extern uint32 AreaTriggerUpdateFieldFlags[AREATRIGGER_END];
 
+/*
+ * One bitmap per UpdatefieldFlags bit over a field flags table, laid out in
+ * UpdateMask blocks, so that the fields matching any of a set of flags can be
+ * selected 32 fields at a time instead of testing flags[index] field by field.
+ */
+class UpdateFieldMaskTable
+{
+public:
+    UpdateFieldMaskTable(uint32 const* flags, uint32 count);
+
+    /// Fields of the given UpdateMask block that have any of flagMask set
+    uint32 GetBlock(uint32 flagMask, uint32 block) const;
+
+    uint32 GetCount() const { return _count; }
+    uint32 GetBlockCount() const { return _blockCount; }
+
+private:
+    enum
+    {
+        UF_FLAG_BIT_COUNT = 10                              // UF_FLAG_PUBLIC .. UF_FLAG_URGENT_SELF_ONLY
+    };
+
+    uint32 _count;
+    uint32 _blockCount;
+    std::vector<uint32> _bitmaps;                           // UF_FLAG_BIT_COUNT bitmaps per block
+};
+
+extern UpdateFieldMaskTable const ItemUpdateFieldMasks;
+extern UpdateFieldMaskTable const UnitUpdateFieldMasks;
+extern UpdateFieldMaskTable const GameObjectUpdateFieldMasks;
+extern UpdateFieldMaskTable const DynamicObjectUpdateFieldMasks;
+extern UpdateFieldMaskTable const CorpseUpdateFieldMasks;
+extern UpdateFieldMaskTable const AreaTriggerUpdateFieldMasks;
+
 #endif // _UPDATEFIELDFLAGS_H
@@ -0,0 +1,42 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include "UpdateMask.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SF_UPDATEMASK_SSE2
+#endif
+
+UpdateMask::ClientUpdateMaskType UpdateMask::GetNonZeroBlock(uint32 const* values, uint32 count, uint32 block)
+{
+    uint32 first = block * CLIENT_UPDATE_MASK_BITS;
+    if (first >= count)
+        return 0;
+
+    uint32 const* itr = values + first;
+    uint32 size = std::min<uint32>(count - first, CLIENT_UPDATE_MASK_BITS);
+    ClientUpdateMaskType result = 0;
+    uint32 i = 0;
+
+#ifdef SF_UPDATEMASK_SSE2
+    // four fields per compare, movemask gives one bit per field that is zero
+    __m128i const zero = _mm_setzero_si128();
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128i fields = _mm_loadu_si128(reinterpret_cast<__m128i const*>(itr + i));
+        uint32 isZero = uint32(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(fields, zero))));
+        result |= ClientUpdateMaskType(~isZero & 0xF) << i;
+    }
+#endif
+
+    for (; i < size; ++i)
+        if (itr[i])
+            result |= ClientUpdateMaskType(1) << i;
+
+    return result;
+}
@@ -10,6 +10,13 @@
 #include "Errors.h"
 #include "UpdateFields.h"
 
+#include <bit>
+
+/*
+ * Bit per update field, stored in the same 32 bit blocks the client reads.
+ * Blocks can be combined and scanned a word at a time so that building an
+ * update only touches the fields that are actually sent.
+ */
 class UpdateMask
 {
 public:
@@ -21,68 +28,87 @@ public:
         CLIENT_UPDATE_MASK_BITS = sizeof(ClientUpdateMaskType) * 8,
     };
 
-    UpdateMask() : _fieldCount(0), _blockCount(0), _bits(NULL) { }
+    UpdateMask() : _fieldCount(0), _blockCount(0), _blocks(NULL) { }
 
-    UpdateMask(UpdateMask const& right) : _bits(NULL)
+    UpdateMask(UpdateMask const& right) : _fieldCount(0), _blockCount(0), _blocks(NULL)
     {
         SetCount(right.GetCount());
-        memcpy(_bits, right._bits, sizeof(uint8) * _blockCount * 32);
+        memcpy(_blocks, right._blocks, sizeof(ClientUpdateMaskType) * _blockCount);
     }
 
-    ~UpdateMask() { delete[] _bits; }
+    ~UpdateMask() { delete[] _blocks; }
 
-    void SetBit(uint32 index) { _bits[index] = 1; }
-    void UnsetBit(uint32 index) { _bits[index] = 0; }
-    bool GetBit(uint32 index) const { return _bits[index] != 0; }
+    void SetBit(uint32 index) { _blocks[index / CLIENT_UPDATE_MASK_BITS] |= ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS); }
+    void UnsetBit(uint32 index) { _blocks[index / CLIENT_UPDATE_MASK_BITS] &= ~(ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS)); }
+    bool GetBit(uint32 index) const { return (_blocks[index / CLIENT_UPDATE_MASK_BITS] & (ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS))) != 0; }
 
-    void AppendToPacket(ByteBuffer* data)
+    ClientUpdateMaskType GetBlock(uint32 block) const { return _blocks[block]; }
+    void SetBlock(uint32 block, ClientUpdateMaskType value) { _blocks[block] = value; }
+
+    void AppendToPacket(ByteBuffer* data) const
     {
         for (uint32 i = 0; i < GetBlockCount(); ++i)
-        {
-            ClientUpdateMaskType maskPart = 0;
-            for (uint32 j = 0; j < CLIENT_UPDATE_MASK_BITS; ++j)
-                if (_bits[CLIENT_UPDATE_MASK_BITS * i + j])
-                    maskPart |= 1 << j;
-
-            *data << maskPart;
-        }
+            *data << _blocks[i];
     }
 
     uint32 GetBlockCount() const { return _blockCount; }
     uint32 GetCount() const { return _fieldCount; }
 
+    bool IsEmpty() const
+    {
+        for (uint32 i = 0; i < _blockCount; ++i)
+            if (_blocks[i])
+                return false;
+
+        return true;
+    }
+
     void SetCount(uint32 valuesCount)
     {
-        delete[] _bits;
+        delete[] _blocks;
 
         _fieldCount = valuesCount;
         _blockCount = (valuesCount + CLIENT_UPDATE_MASK_BITS - 1) / CLIENT_UPDATE_MASK_BITS;
 
-        _bits = new uint8[_blockCount * CLIENT_UPDATE_MASK_BITS];
-        memset(_bits, 0, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+        _blocks = new ClientUpdateMaskType[_blockCount];
+        memset(_blocks, 0, sizeof(ClientUpdateMaskType) * _blockCount);
     }
 
     void Clear()
     {
-        if (_bits)
-            memset(_bits, 0, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+        if (_blocks)
+            memset(_blocks, 0, sizeof(ClientUpdateMaskType) * _blockCount);
+    }
+
+    /// Calls f(index) for every set bit, in increasing order
+    template<class F>
+    void ForEachSetBit(F f) const
+    {
+        for (uint32 i = 0; i < _blockCount; ++i)
+        {
+            for (ClientUpdateMaskType block = _blocks[i]; block; block &= block - 1)
+                f(i * CLIENT_UPDATE_MASK_BITS + uint32(std::countr_zero(block)));
+        }
     }
 
+    /// Bit n is set when values[block * CLIENT_UPDATE_MASK_BITS + n] is not zero, values past count read as zero
+    static ClientUpdateMaskType GetNonZeroBlock(uint32 const* values, uint32 count, uint32 block);
+
     UpdateMask& operator=(UpdateMask const& right)
     {
         if (this == &right)
             return *this;
 
         SetCount(right.GetCount());
-        memcpy(_bits, right._bits, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+        memcpy(_blocks, right._blocks, sizeof(ClientUpdateMaskType) * _blockCount);
         return *this;
     }
 
     UpdateMask& operator&=(UpdateMask const& right)
     {
         ASSERT(right.GetCount() <= GetCount());
-        for (uint32 i = 0; i < _fieldCount; ++i)
-            _bits[i] &= right._bits[i];
+        for (uint32 i = 0; i < _blockCount; ++i)
+            _blocks[i] &= i < right._blockCount ? right._blocks[i] : 0;
 
         return *this;
     }
@@ -90,8 +116,8 @@ public:
     UpdateMask& operator|=(UpdateMask const& right)
     {
         ASSERT(right.GetCount() <= GetCount());
-        for (uint32 i = 0; i < _fieldCount; ++i)
-            _bits[i] |= right._bits[i];
+        for (uint32 i = 0; i < right._blockCount; ++i)
+            _blocks[i] |= right._blocks[i];
 
         return *this;
     }
@@ -106,7 +132,7 @@ public:
 private:
     uint32 _fieldCount;
     uint32 _blockCount;
-    uint8* _bits;
+    ClientUpdateMaskType* _blocks;
 };
 
 #endif
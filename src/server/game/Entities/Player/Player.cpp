@@ -20184,7 +20184,8 @@ void Player::SaveToDB(bool create /*=false*/)
     if (m_session->isLogingOut() || !sWorld->GetBoolConfig(WorldBoolConfigs::CONFIG_STATS_SAVE_ONLY_ON_LOGOUT))
         _SaveStats(trans);
 
-    CharacterDatabase.CommitTransaction(trans);
+    // same connection as the login queries of this character, a relog never reads older data
+    CharacterDatabase.CommitTransaction(trans, GetGUIDLow());
 
     // save pet (hunter pet level and experience and all type pets health/mana).
     if (Pet* pet = GetPet())
@@ -20927,7 +20928,7 @@ void Player::_SaveStats(SQLTransaction& trans)
 
 void Player::outDebugValues() const
 {
-    if (!sLog->ShouldLog("entities.unit", LogLevel::LOG_LEVEL_DEBUG))
+    if (!SF_LOG_ENABLED("entities.unit", LogLevel::LOG_LEVEL_DEBUG))
         return;
 
     SF_LOG_DEBUG("entities.unit", "HP is: \t\t\t%u\t\tMP is: \t\t\t%u", GetMaxHealth(), GetMaxPower(POWER_MANA));
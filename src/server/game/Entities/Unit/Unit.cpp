@@ -48,6 +48,9 @@
 #include "WorldPacket.h"
 #include "WorldSession.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <math.h>
 
 float baseMoveSpeed[MAX_MOVE_TYPE] =
@@ -192,6 +195,8 @@ Unit::Unit(bool isWorldObject) :
     m_auraUpdateIterator = m_ownedAuras.end();
 
     m_interruptMask = 0;
+    m_procAuraMask = 0;
+    m_procAurasLoad = sSpellMgr->GetProcLoadCount();
     m_transform = 0;
     m_canModifyStats = false;
 
@@ -504,6 +509,53 @@ void Unit::UpdateInterruptMask()
             m_interruptMask |= spell->m_spellInfo->ChannelInterruptFlags;
 }
 
+void Unit::UpdateProcAuraMask()
+{
+    // made again after the proc tables were reloaded
+    if (m_procAurasLoad != sSpellMgr->GetProcLoadCount())
+    {
+        m_procAuras.clear();
+        m_procAurasLoad = sSpellMgr->GetProcLoadCount();
+        for (AuraApplicationMap::const_iterator i = m_appliedAuras.begin(); i != m_appliedAuras.end(); ++i)
+            _AddProcAura(i->second);
+    }
+
+    m_procAuraMask = 0;
+    for (std::vector<ProcAura>::const_iterator i = m_procAuras.begin(); i != m_procAuras.end(); ++i)
+        m_procAuraMask |= i->procFlags;
+}
+
+void Unit::_AddProcAura(AuraApplication* aurApp)
+{
+    ProcAura procAura;
+    procAura.spellId = aurApp->GetBase()->GetId();
+    procAura.procFlags = sSpellMgr->GetSpellProcEventFlags(aurApp->GetBase()->GetSpellInfo());
+    procAura.aurApp = aurApp;
+    if (!procAura.procFlags)
+        return;
+
+    // after the ones of the same spell, where m_appliedAuras puts it too
+    std::vector<ProcAura>::iterator itr = m_procAuras.begin();
+    while (itr != m_procAuras.end() && itr->spellId <= procAura.spellId)
+        ++itr;
+
+    m_procAuras.insert(itr, procAura);
+    m_procAuraMask |= procAura.procFlags;
+}
+
+void Unit::_RemoveProcAura(AuraApplication* aurApp)
+{
+    for (std::vector<ProcAura>::iterator itr = m_procAuras.begin(); itr != m_procAuras.end(); ++itr)
+    {
+        if (itr->aurApp == aurApp)
+        {
+            m_procAuras.erase(itr);
+            UpdateProcAuraMask();
+            return;
+        }
+    }
+}
+
 bool Unit::HasVisionObscured(Unit const* target) const
 {
     if (!target)
@@ -3253,6 +3305,7 @@ AuraApplication* Unit::_CreateAuraApplication(Aura* aura, uint32 effMask)
 
     AuraApplication* aurApp = new AuraApplication(this, caster, aura, effMask);
     m_appliedAuras.insert(AuraApplicationMap::value_type(aurId, aurApp));
+    _AddProcAura(aurApp);
 
     if (aurSpellInfo->AuraInterruptFlags)
     {
@@ -3337,6 +3390,7 @@ void Unit::_UnapplyAura(AuraApplicationMap::iterator& i, AuraRemoveMode removeMo
 
     // Remove all pointers from lists here to prevent possible pointer invalidation on spellcast/auraapply/auraremove
     m_appliedAuras.erase(i);
+    _RemoveProcAura(aurApp);
 
     if (aura->GetSpellInfo()->AuraInterruptFlags)
     {
@@ -3449,6 +3503,8 @@ void Unit::_RegisterAuraEffect(AuraEffect* aurEff, bool apply)
         m_modAuras[aurEff->GetAuraType()].push_back(aurEff);
     else
         m_modAuras[aurEff->GetAuraType()].remove(aurEff);
+
+    InvalidateAuraModifiers(aurEff->GetAuraType());
 }
 
 // All aura base removes should go threw this function!
@@ -4404,10 +4460,17 @@ uint32 Unit::GetDoTsByCaster(uint64 casterGUID) const
 
 int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
+    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
+    if (mTotalAuraList.empty())
+        return 0;
+
+    AuraModifierCache& cache = m_auraModifiers[auratype];
+    if (cache.cached & AURA_MODIFIER_CACHED_TOTAL)
+        return cache.total;
+
     std::map<SpellGroup, int32> SameEffectSpellGroup;
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
     for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if (!sSpellMgr->AddSameEffectStackRuleSpellGroups((*i)->GetSpellInfo(), (*i)->GetAmount(), SameEffectSpellGroup))
             modifier += (*i)->GetAmount();
@@ -4415,53 +4478,89 @@ int32 Unit::GetTotalAuraModifier(AuraType auratype) const
     for (std::map<SpellGroup, int32>::const_iterator itr = SameEffectSpellGroup.begin(); itr != SameEffectSpellGroup.end(); ++itr)
         modifier += itr->second;
 
+    cache.total = modifier;
+    cache.cached |= AURA_MODIFIER_CACHED_TOTAL;
     return modifier;
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
+    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
+    if (mTotalAuraList.empty())
+        return 1.0f;
+
+    AuraModifierCache& cache = m_auraModifiers[auratype];
+    if (cache.cached & AURA_MODIFIER_CACHED_MULTIPLIER)
+        return cache.multiplier;
+
     float multiplier = 1.0f;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
     for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         AddPct(multiplier, (*i)->GetAmount());
 
+    cache.multiplier = multiplier;
+    cache.cached |= AURA_MODIFIER_CACHED_MULTIPLIER;
     return multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype) const
 {
+    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
+    if (mTotalAuraList.empty())
+        return 0;
+
+    AuraModifierCache& cache = m_auraModifiers[auratype];
+    if (cache.cached & AURA_MODIFIER_CACHED_MAX_POSITIVE)
+        return cache.maxPositive;
+
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
     for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->GetAmount() > modifier)
             modifier = (*i)->GetAmount();
     }
 
+    cache.maxPositive = modifier;
+    cache.cached |= AURA_MODIFIER_CACHED_MAX_POSITIVE;
     return modifier;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
+    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
+    if (mTotalAuraList.empty())
+        return 0;
+
+    AuraModifierCache& cache = m_auraModifiers[auratype];
+    if (cache.cached & AURA_MODIFIER_CACHED_MAX_NEGATIVE)
+        return cache.maxNegative;
+
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
     for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if ((*i)->GetAmount() < modifier)
             modifier = (*i)->GetAmount();
 
+    cache.maxNegative = modifier;
+    cache.cached |= AURA_MODIFIER_CACHED_MAX_NEGATIVE;
     return modifier;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 miscMask) const
 {
+    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
+    if (mTotalAuraList.empty())
+        return 0;
+
+    std::vector<std::pair<uint32, int32> >& cached = m_auraModifiers[auratype].totalByMiscMask;
+    for (std::vector<std::pair<uint32, int32> >::const_iterator itr = cached.begin(); itr != cached.end(); ++itr)
+        if (itr->first == miscMask)
+            return itr->second;
+
     std::map<SpellGroup, int32> SameEffectSpellGroup;
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-
     for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if ((*i)->GetMiscValue() & miscMask)
             if (!sSpellMgr->AddSameEffectStackRuleSpellGroups((*i)->GetSpellInfo(), (*i)->GetAmount(), SameEffectSpellGroup))
@@ -4470,15 +4569,25 @@ int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 miscMask) c
     for (std::map<SpellGroup, int32>::const_iterator itr = SameEffectSpellGroup.begin(); itr != SameEffectSpellGroup.end(); ++itr)
         modifier += itr->second;
 
+    if (cached.size() < MAX_AURA_MODIFIER_CACHED_MASKS)
+        cached.push_back(std::make_pair(miscMask, modifier));
     return modifier;
 }
 
 float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auratype, uint32 miscMask) const
 {
+    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
+    if (mTotalAuraList.empty())
+        return 1.0f;
+
+    std::vector<std::pair<uint32, float> >& cached = m_auraModifiers[auratype].multiplierByMiscMask;
+    for (std::vector<std::pair<uint32, float> >::const_iterator itr = cached.begin(); itr != cached.end(); ++itr)
+        if (itr->first == miscMask)
+            return itr->second;
+
     std::map<SpellGroup, int32> SameEffectSpellGroup;
     float multiplier = 1.0f;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
     for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if (((*i)->GetMiscValue() & miscMask))
@@ -4493,6 +4602,8 @@ float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auratype, uint32 miscMask)
     for (std::map<SpellGroup, int32>::const_iterator itr = SameEffectSpellGroup.begin(); itr != SameEffectSpellGroup.end(); ++itr)
         AddPct(multiplier, itr->second);
 
+    if (cached.size() < MAX_AURA_MODIFIER_CACHED_MASKS)
+        cached.push_back(std::make_pair(miscMask, multiplier));
     return multiplier;
 }
 
@@ -12432,6 +12543,82 @@ struct ProcTriggeredData
 
 typedef std::list< ProcTriggeredData > ProcTriggeredList;
 
+namespace
+{
+    // map threads proc at the same time, each counts on its own and GetProcStats sums them up
+    struct ProcCounters
+    {
+        ProcCounters();
+        ~ProcCounters();
+
+        void AddTo(UnitProcStats& stats) const;
+
+        std::atomic<uint64> Events;                         // written by the owning thread only
+        std::atomic<uint64> Applied;
+        std::atomic<uint64> Examined;
+        std::atomic<uint64> Triggered;
+    };
+
+    std::mutex sProcCountersLock;
+    std::vector<ProcCounters const*> sProcCounters;
+    UnitProcStats sExitedProcStats = { 0, 0, 0, 0 };         // threads that ended already
+    UnitProcStats sProcStatsAtReset = { 0, 0, 0, 0 };        // the counters are never cleared, only the totals at the last reset noted
+
+    thread_local ProcCounters tProcCounters;
+
+    ProcCounters::ProcCounters() : Events(0), Applied(0), Examined(0), Triggered(0)
+    {
+        std::lock_guard<std::mutex> guard(sProcCountersLock);
+        sProcCounters.push_back(this);
+    }
+
+    ProcCounters::~ProcCounters()
+    {
+        std::lock_guard<std::mutex> guard(sProcCountersLock);
+        AddTo(sExitedProcStats);
+        sProcCounters.erase(std::find(sProcCounters.begin(), sProcCounters.end(), this));
+    }
+
+    void ProcCounters::AddTo(UnitProcStats& stats) const
+    {
+        stats.events += Events.load(std::memory_order_relaxed);
+        stats.applied += Applied.load(std::memory_order_relaxed);
+        stats.examined += Examined.load(std::memory_order_relaxed);
+        stats.triggered += Triggered.load(std::memory_order_relaxed);
+    }
+
+    void CountProcs(std::atomic<uint64>& counter, uint64 count)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
+    // sProcCountersLock must be held
+    UnitProcStats SumProcCounters()
+    {
+        UnitProcStats stats = sExitedProcStats;
+        for (std::vector<ProcCounters const*>::const_iterator itr = sProcCounters.begin(); itr != sProcCounters.end(); ++itr)
+            (*itr)->AddTo(stats);
+        return stats;
+    }
+}
+
+UnitProcStats Unit::GetProcStats()
+{
+    std::lock_guard<std::mutex> guard(sProcCountersLock);
+    UnitProcStats stats = SumProcCounters();
+    stats.events -= sProcStatsAtReset.events;
+    stats.applied -= sProcStatsAtReset.applied;
+    stats.examined -= sProcStatsAtReset.examined;
+    stats.triggered -= sProcStatsAtReset.triggered;
+    return stats;
+}
+
+void Unit::ResetProcStats()
+{
+    std::lock_guard<std::mutex> guard(sProcCountersLock);
+    sProcStatsAtReset = SumProcCounters();
+}
+
 // List of auras that CAN be trigger but may not exist in spell_proc_event
 // in most case need for drop charges
 // in some types of aura need do additional check
@@ -12644,19 +12831,31 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
     ProcEventInfo eventInfo = ProcEventInfo(actor, actionTarget, target, procFlag, 0, 0, procExtra, NULL, &damageInfo, &healInfo);
 
     ProcTriggeredList procTriggered;
-    // Fill procTriggered list
-    for (AuraApplicationMap::const_iterator itr = GetAppliedAuras().begin(); itr != GetAppliedAuras().end(); ++itr)
+    if (isVictim)
+        procExtra &= ~PROC_EX_INTERNAL_REQ_FAMILY;
+
+    if (m_procAurasLoad != sSpellMgr->GetProcLoadCount())
+        UpdateProcAuraMask();
+
+    uint32 examined = 0;
+    // Fill procTriggered list, only with the auras that can proc on one of the flags
+    for (size_t n = 0; (procFlag & m_procAuraMask) && n < m_procAuras.size(); ++n)
     {
+        if (!(m_procAuras[n].procFlags & procFlag))
+            continue;
+
         // Do not allow auras to proc from effect triggered by itself
-        if (procAura && procAura->Id == itr->first)
+        if (procAura && procAura->Id == m_procAuras[n].spellId)
             continue;
-        ProcTriggeredData triggerData(itr->second->GetBase());
+
+        AuraApplication* aurApp = m_procAuras[n].aurApp;
+        ++examined;
+
+        ProcTriggeredData triggerData(aurApp->GetBase());
         // Defensive procs are active on absorbs (so absorption effects are not a hindrance)
         bool active = damage || (procExtra & PROC_EX_BLOCK && isVictim);
-        if (isVictim)
-            procExtra &= ~PROC_EX_INTERNAL_REQ_FAMILY;
 
-        SpellInfo const* spellProto = itr->second->GetBase()->GetSpellInfo();
+        SpellInfo const* spellProto = aurApp->GetBase()->GetSpellInfo();
 
         // only auras that has triggered spell should proc from fully absorbed damage
         if (procExtra & PROC_EX_ABSORB && isVictim)
@@ -12673,7 +12872,7 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
             continue;
 
         // AuraScript Hook
-        if (!triggerData.aura->CallScriptCheckProcHandlers(itr->second, eventInfo))
+        if (!triggerData.aura->CallScriptCheckProcHandlers(aurApp, eventInfo))
             continue;
 
         // Triggered spells not triggering additional spells
@@ -12682,9 +12881,9 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
 
         for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
         {
-            if (itr->second->HasEffect(i))
+            if (aurApp->HasEffect(i))
             {
-                AuraEffect* aurEff = itr->second->GetBase()->GetEffect(i);
+                AuraEffect* aurEff = aurApp->GetBase()->GetEffect(i);
                 // Skip this auras
                 if (isNonTriggerAura[aurEff->GetAuraType()])
                     continue;
@@ -12700,6 +12899,11 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
             procTriggered.push_front(triggerData);
     }
 
+    CountProcs(tProcCounters.Events, 1);
+    CountProcs(tProcCounters.Applied, m_appliedAuras.size());
+    CountProcs(tProcCounters.Examined, examined);
+    CountProcs(tProcCounters.Triggered, procTriggered.size());
+
     // Nothing found
     if (procTriggered.empty())
         return;
@@ -16977,17 +17181,10 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
     ByteBuffer fieldBuffer;
     UpdateMask updateMask;
 
-    uint32 valCount = m_valuesCount;
-
-    uint32* flags = UnitUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC | UF_FLAG_VIEWER_DEPENDENT;
 
     if (target == this)
         visibleFlag |= UF_FLAG_PRIVATE;
-    //else if (GetTypeId() == TYPEID_PLAYER)
-    //    valCount = PLAYER_END_NOT_SELF;
-
-    updateMask.SetCount(valCount);
 
     Player* plr = GetCharmerOrOwnerPlayerOrPlayerItself();
     if (GetOwnerGUID() == target->GetGUID())
@@ -17000,147 +17197,144 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
     if (plr && plr->IsInSameRaidWith(target))
         visibleFlag |= UF_FLAG_PARTY_MEMBER;
 
+    BuildValuesUpdateMask(updateType, visibleFlag, updateMask);
+
+    if (HasFlag(UNIT_FIELD_AURA_STATE, PER_CASTER_AURA_STATE_MASK))
+        updateMask.SetBit(UNIT_FIELD_AURA_STATE);
+
     Creature const* creature = ToCreature();
-    for (uint16 index = 0; index < valCount; ++index)
+    updateMask.ForEachSetBit([&](uint32 index)
     {
-        if ((m_fieldNotifyFlags & flags[index] ||
-            ((flags[index] & visibleFlag) & UF_FLAG_SPECIAL_INFO) ||
-            ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-            (index == UNIT_FIELD_AURA_STATE && HasFlag(UNIT_FIELD_AURA_STATE, PER_CASTER_AURA_STATE_MASK))))
+        if (index == UNIT_FIELD_NPC_FLAGS)
         {
-            updateMask.SetBit(index);
+            uint32 appendValue = m_uint32Values[UNIT_FIELD_NPC_FLAGS];
 
-            if (index == UNIT_FIELD_NPC_FLAGS)
-            {
-                uint32 appendValue = m_uint32Values[UNIT_FIELD_NPC_FLAGS];
+            if (creature)
+                if (!target->CanSeeSpellClickOn(creature))
+                    appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
 
-                if (creature)
-                    if (!target->CanSeeSpellClickOn(creature))
-                        appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
+            fieldBuffer << uint32(appendValue);
+        }
+        else if (index == UNIT_FIELD_AURA_STATE)
+        {
+            // Check per caster aura states to not enable using a spell in client if specified aura is not by target
+            fieldBuffer << BuildAuraStateUpdateForTarget(target);
+        }
+        // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+        else if (index >= UNIT_FIELD_ATTACK_ROUND_BASE_TIME && index <= UNIT_FIELD_RANGED_ATTACK_ROUND_BASE_TIME)
+        {
+            // convert from float to uint32 and send
+            fieldBuffer << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+        }
+        // there are some float values which may be negative or can't get negative due to other checks
+        else if ((index >= UNIT_FIELD_STAT_NEG_BUFF && index <= UNIT_FIELD_STAT_NEG_BUFF + 4) ||
+            (index >= UNIT_FIELD_RESISTANCE_BUFF_MODS_POSITIVE && index <= (UNIT_FIELD_RESISTANCE_BUFF_MODS_POSITIVE + 6)) ||
+            (index >= UNIT_FIELD_RESISTANCE_BUFF_MODS_NEGATIVE && index <= (UNIT_FIELD_RESISTANCE_BUFF_MODS_NEGATIVE + 6)) ||
+            (index >= UNIT_FIELD_STAT_POS_BUFF && index <= UNIT_FIELD_STAT_POS_BUFF + 4))
+        {
+            fieldBuffer << uint32(m_floatValues[index]);
+        }
+        // Gamemasters should be always able to select units - remove not selectable flag
+        else if (index == UNIT_FIELD_FLAGS)
+        {
+            uint32 appendValue = m_uint32Values[UNIT_FIELD_FLAGS];
+            if (target->IsGameMaster())
+                appendValue &= ~UNIT_FLAG_NOT_SELECTABLE;
 
-                fieldBuffer << uint32(appendValue);
-            }
-            else if (index == UNIT_FIELD_AURA_STATE)
-            {
-                // Check per caster aura states to not enable using a spell in client if specified aura is not by target
-                fieldBuffer << BuildAuraStateUpdateForTarget(target);
-            }
-            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-            else if (index >= UNIT_FIELD_ATTACK_ROUND_BASE_TIME && index <= UNIT_FIELD_RANGED_ATTACK_ROUND_BASE_TIME)
-            {
-                // convert from float to uint32 and send
-                fieldBuffer << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
-            }
-            // there are some float values which may be negative or can't get negative due to other checks
-            else if ((index >= UNIT_FIELD_STAT_NEG_BUFF && index <= UNIT_FIELD_STAT_NEG_BUFF + 4) ||
-                (index >= UNIT_FIELD_RESISTANCE_BUFF_MODS_POSITIVE && index <= (UNIT_FIELD_RESISTANCE_BUFF_MODS_POSITIVE + 6)) ||
-                (index >= UNIT_FIELD_RESISTANCE_BUFF_MODS_NEGATIVE && index <= (UNIT_FIELD_RESISTANCE_BUFF_MODS_NEGATIVE + 6)) ||
-                (index >= UNIT_FIELD_STAT_POS_BUFF && index <= UNIT_FIELD_STAT_POS_BUFF + 4))
-            {
-                fieldBuffer << uint32(m_floatValues[index]);
-            }
-            // Gamemasters should be always able to select units - remove not selectable flag
-            else if (index == UNIT_FIELD_FLAGS)
+            fieldBuffer << uint32(appendValue);
+        }
+        // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
+        else if (index == UNIT_FIELD_DISPLAY_ID)
+        {
+            uint32 displayId = m_uint32Values[UNIT_FIELD_DISPLAY_ID];
+            if (creature)
             {
-                uint32 appendValue = m_uint32Values[UNIT_FIELD_FLAGS];
-                if (target->IsGameMaster())
-                    appendValue &= ~UNIT_FLAG_NOT_SELECTABLE;
+                CreatureTemplate const* cinfo = creature->GetCreatureTemplate();
 
-                fieldBuffer << uint32(appendValue);
-            }
-            // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
-            else if (index == UNIT_FIELD_DISPLAY_ID)
-            {
-                uint32 displayId = m_uint32Values[UNIT_FIELD_DISPLAY_ID];
-                if (creature)
-                {
-                    CreatureTemplate const* cinfo = creature->GetCreatureTemplate();
-
-                    // this also applies for transform auras
-                    if (SpellInfo const* transform = sSpellMgr->GetSpellInfo(getTransForm()))
-                        for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-                            if (transform->Effects[i].IsAura(SPELL_AURA_TRANSFORM))
-                                if (CreatureTemplate const* transformInfo = sObjectMgr->GetCreatureTemplate(transform->Effects[i].MiscValue))
-                                {
-                                    cinfo = transformInfo;
-                                    break;
-                                }
+                // this also applies for transform auras
+                if (SpellInfo const* transform = sSpellMgr->GetSpellInfo(getTransForm()))
+                    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+                        if (transform->Effects[i].IsAura(SPELL_AURA_TRANSFORM))
+                            if (CreatureTemplate const* transformInfo = sObjectMgr->GetCreatureTemplate(transform->Effects[i].MiscValue))
+                            {
+                                cinfo = transformInfo;
+                                break;
+                            }
 
-                    if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
+                if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
+                {
+                    if (target->IsGameMaster())
                     {
-                        if (target->IsGameMaster())
-                        {
-                            if (cinfo->Modelid1)
-                                displayId = cinfo->Modelid1;    // Modelid1 is a visible model for gms
-                            else
-                                displayId = 17519;              // world visible trigger's model
-                        }
+                        if (cinfo->Modelid1)
+                            displayId = cinfo->Modelid1;    // Modelid1 is a visible model for gms
                         else
-                        {
-                            if (cinfo->Modelid2)
-                                displayId = cinfo->Modelid2;    // Modelid2 is an invisible model for players
-                            else
-                                displayId = 11686;              // world invisible trigger's model
-                        }
+                            displayId = 17519;              // world visible trigger's model
+                    }
+                    else
+                    {
+                        if (cinfo->Modelid2)
+                            displayId = cinfo->Modelid2;    // Modelid2 is an invisible model for players
+                        else
+                            displayId = 11686;              // world invisible trigger's model
                     }
                 }
-
-                fieldBuffer << uint32(displayId);
             }
-            // hide lootable animation for unallowed players
-            else if (index == OBJECT_FIELD_DYNAMIC_FLAGS)
-            {
-                uint32 dynamicFlags = m_uint32Values[OBJECT_FIELD_DYNAMIC_FLAGS] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
 
-                if (creature)
-                {
-                    if (creature->hasLootRecipient())
-                    {
-                        dynamicFlags |= UNIT_DYNFLAG_TAPPED;
-                        if (creature->isTappedBy(target))
-                            dynamicFlags |= UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                    }
+            fieldBuffer << uint32(displayId);
+        }
+        // hide lootable animation for unallowed players
+        else if (index == OBJECT_FIELD_DYNAMIC_FLAGS)
+        {
+            uint32 dynamicFlags = m_uint32Values[OBJECT_FIELD_DYNAMIC_FLAGS] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
 
-                    if (!target->isAllowedToLoot(creature))
-                        dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
+            if (creature)
+            {
+                if (creature->hasLootRecipient())
+                {
+                    dynamicFlags |= UNIT_DYNFLAG_TAPPED;
+                    if (creature->isTappedBy(target))
+                        dynamicFlags |= UNIT_DYNFLAG_TAPPED_BY_PLAYER;
                 }
 
-                // unit UNIT_DYNFLAG_TRACK_UNIT should only be sent to caster of SPELL_AURA_MOD_STALKED auras
-                if (dynamicFlags & UNIT_DYNFLAG_TRACK_UNIT)
-                    if (!HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetGUID()))
-                        dynamicFlags &= ~UNIT_DYNFLAG_TRACK_UNIT;
-
-                fieldBuffer << dynamicFlags;
+                if (!target->isAllowedToLoot(creature))
+                    dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
             }
-            // FG: pretend that OTHER players in own group are friendly ("blue")
-            else if (index == UNIT_FIELD_SHAPESHIFT_FORM || index == UNIT_FIELD_FACTION_TEMPLATE)
+
+            // unit UNIT_DYNFLAG_TRACK_UNIT should only be sent to caster of SPELL_AURA_MOD_STALKED auras
+            if (dynamicFlags & UNIT_DYNFLAG_TRACK_UNIT)
+                if (!HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetGUID()))
+                    dynamicFlags &= ~UNIT_DYNFLAG_TRACK_UNIT;
+
+            fieldBuffer << dynamicFlags;
+        }
+        // FG: pretend that OTHER players in own group are friendly ("blue")
+        else if (index == UNIT_FIELD_SHAPESHIFT_FORM || index == UNIT_FIELD_FACTION_TEMPLATE)
+        {
+            if (IsControlledByPlayer() && target != this && sWorld->GetBoolConfig(WorldBoolConfigs::CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP) && IsInRaidWith(target))
             {
-                if (IsControlledByPlayer() && target != this && sWorld->GetBoolConfig(WorldBoolConfigs::CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP) && IsInRaidWith(target))
+                FactionTemplateEntry const* ft1 = GetFactionTemplateEntry();
+                FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
+                if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
                 {
-                    FactionTemplateEntry const* ft1 = GetFactionTemplateEntry();
-                    FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
-                    if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
-                    {
-                        if (index == UNIT_FIELD_SHAPESHIFT_FORM)
-                            // Allow targetting opposite faction in party when enabled in config
-                            fieldBuffer << (m_uint32Values[UNIT_FIELD_SHAPESHIFT_FORM] & ((UNIT_BYTE2_FLAG_SANCTUARY /*| UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5*/) << 8)); // this flag is at uint8 offset 1 !!
-                        else
-                            // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
-                            fieldBuffer << uint32(target->getFaction());
-                    }
+                    if (index == UNIT_FIELD_SHAPESHIFT_FORM)
+                        // Allow targetting opposite faction in party when enabled in config
+                        fieldBuffer << (m_uint32Values[UNIT_FIELD_SHAPESHIFT_FORM] & ((UNIT_BYTE2_FLAG_SANCTUARY /*| UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5*/) << 8)); // this flag is at uint8 offset 1 !!
                     else
-                        fieldBuffer << m_uint32Values[index];
+                        // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
+                        fieldBuffer << uint32(target->getFaction());
                 }
                 else
                     fieldBuffer << m_uint32Values[index];
             }
             else
-            {
-                // send in current format (float as float, uint32 as uint32)
                 fieldBuffer << m_uint32Values[index];
-            }
         }
-    }
+        else
+        {
+            // send in current format (float as float, uint32 as uint32)
+            fieldBuffer << m_uint32Values[index];
+        }
+    });
 
     *data << uint8(updateMask.GetBlockCount());
     updateMask.AppendToPacket(data);
@@ -17148,6 +17342,40 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
     *data << uint8(0);
 }
 
+bool Unit::CanShareValuesUpdate() const
+{
+    // aura state is always sent per caster when such auras are present
+    if (HasFlag(UNIT_FIELD_AURA_STATE, PER_CASTER_AURA_STATE_MASK))
+        return false;
+
+    return Object::CanShareValuesUpdate();
+}
+
+// must match the per target cases of Unit::BuildValuesUpdate
+bool Unit::IsViewerDependentUpdateField(uint16 index) const
+{
+    Creature const* creature = ToCreature();
+    switch (index)
+    {
+        case UNIT_FIELD_NPC_FLAGS:
+            return creature && HasFlag(UNIT_FIELD_NPC_FLAGS, UNIT_NPC_FLAG_SPELLCLICK);
+        case UNIT_FIELD_AURA_STATE:
+            return true;
+        case UNIT_FIELD_FLAGS:
+            return HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE);
+        case UNIT_FIELD_DISPLAY_ID:
+            return creature && (creature->IsTrigger() || getTransForm());
+        case OBJECT_FIELD_DYNAMIC_FLAGS:
+            return (creature && (creature->hasLootRecipient() || HasFlag(OBJECT_FIELD_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE))) ||
+                HasFlag(OBJECT_FIELD_DYNAMIC_FLAGS, UNIT_DYNFLAG_TRACK_UNIT);
+        case UNIT_FIELD_SHAPESHIFT_FORM:
+        case UNIT_FIELD_FACTION_TEMPLATE:
+            return IsControlledByPlayer() && sWorld->GetBoolConfig(WorldBoolConfigs::CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP);
+        default:
+            return false;
+    }
+}
+
 void Unit::SendSetVehicleRecId(uint32 vehicleId)
 {
     if (Player* player = ToPlayer())
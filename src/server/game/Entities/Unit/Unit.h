@@ -268,6 +268,8 @@ enum UnitRename
 #define MAX_AGGRO_RESET_TIME 10 // in seconds
 #define MAX_AGGRO_RADIUS 45.0f  // yards
 
+#define MAX_AURA_MODIFIER_CACHED_MASKS 8 // misc masks whose totals a unit keeps per aura type
+
 enum Swing
 {
     NOSWING = 0,
@@ -1056,6 +1058,15 @@ struct SpellPeriodicAuraLogInfo
 
 uint32 createProcExtendMask(SpellNonMeleeDamage* damageInfo, SpellMissInfo missCondition);
 
+// counted over all units by Unit::ProcDamageAndSpellFor
+struct UnitProcStats
+{
+    uint64 events;                                          // calls
+    uint64 applied;                                         // auras applied on the unit of each call
+    uint64 examined;                                        // auras whose proc flags matched the event
+    uint64 triggered;                                       // auras that passed the proc checks
+};
+
 struct RedirectThreatInfo
 {
     RedirectThreatInfo() : _targetGUID(0), _threatPct(0)
@@ -1754,6 +1765,8 @@ public:
 
     void ProcDamageAndSpell(Unit* victim, uint32 procAttacker, uint32 procVictim, uint32 procEx, uint32 amount, WeaponAttackType attType = WeaponAttackType::BASE_ATTACK, SpellInfo const* procSpell = NULL, SpellInfo const* procAura = NULL);
     void ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, SpellInfo const* procSpell, uint32 damage, SpellInfo const* procAura = NULL);
+    static UnitProcStats GetProcStats();
+    static void ResetProcStats();
 
     void GetProcAurasTriggeredOnEvent(AuraApplicationList& aurasTriggeringProc, AuraApplicationList* procAuras, ProcEventInfo eventInfo);
     void TriggerAurasProcOnEvent(CalcDamageInfo& damageInfo);
@@ -2292,6 +2305,9 @@ public:
     int32 GetMaxPositiveAuraModifierByAffectMask(AuraType auratype, SpellInfo const* affectedSpell) const;
     int32 GetMaxNegativeAuraModifierByAffectMask(AuraType auratype, SpellInfo const* affectedSpell) const;
 
+    // drops the cached totals of the type, called whenever an effect of it is (un)registered or its amount changes
+    void InvalidateAuraModifiers(AuraType auratype) { m_auraModifiers.erase(auratype); }
+
     float GetResistanceBuffMods(SpellSchools school, bool positive) const;
     void SetResistanceBuffMods(SpellSchools school, bool positive, float val);
     void ApplyResistanceBuffModsMod(SpellSchools school, bool positive, float val, bool apply);
@@ -2474,6 +2490,7 @@ public:
         m_interruptMask |= mask;
     }
     void UpdateInterruptMask();
+    void UpdateProcAuraMask();
     bool HasVisionObscured(Unit const* target) const;
 
     uint32 GetDisplayId() const
@@ -2851,6 +2868,8 @@ protected:
     explicit Unit(bool isWorldObject);
 
     void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+    bool CanShareValuesUpdate() const override;
+    bool IsViewerDependentUpdateField(uint16 index) const override;
 
     UnitAI* i_AI, * i_disabledAI;
 
@@ -2891,11 +2910,49 @@ protected:
     uint32 m_removedAurasCount;
 
     AuraEffectList m_modAuras[TOTAL_AURAS];
+
+    enum AuraModifierCached
+    {
+        AURA_MODIFIER_CACHED_TOTAL          = 0x01,
+        AURA_MODIFIER_CACHED_MULTIPLIER     = 0x02,
+        AURA_MODIFIER_CACHED_MAX_POSITIVE   = 0x04,
+        AURA_MODIFIER_CACHED_MAX_NEGATIVE   = 0x08
+    };
+
+    // what the GetTotalAuraModifier family calculated from m_modAuras, only for aura types that have effects
+    struct AuraModifierCache
+    {
+        AuraModifierCache() : cached(0), total(0), multiplier(1.0f), maxPositive(0), maxNegative(0) { }
+
+        uint8 cached;                                          // AuraModifierCached
+        int32 total;
+        float multiplier;
+        int32 maxPositive;
+        int32 maxNegative;
+        std::vector<std::pair<uint32, int32> > totalByMiscMask;
+        std::vector<std::pair<uint32, float> > multiplierByMiscMask;
+    };
+    // filled by the const getters: only the thread updating the unit's map may read modifiers
+    mutable UNORDERED_MAP<uint32, AuraModifierCache> m_auraModifiers;
+
     AuraList m_scAuras;                        // casted singlecast auras
     AuraApplicationList m_interruptableAuras;             // auras which have interrupt mask applied on unit
     AuraStateAurasMap m_auraStateAuras;        // Used for improve performance of aura state checks on aura apply/remove
     uint32 m_interruptMask;
 
+    // applied auras ProcDamageAndSpellFor checks, ordered by spell id like m_appliedAuras
+    struct ProcAura
+    {
+        uint32 spellId;
+        uint32 procFlags;                                      // SpellMgr::GetSpellProcEventFlags
+        AuraApplication* aurApp;
+    };
+    std::vector<ProcAura> m_procAuras;
+    uint32 m_procAuraMask;                     // procFlags of all m_procAuras
+    uint32 m_procAurasLoad;                    // SpellMgr::GetProcLoadCount m_procAuras were made for
+    void _AddProcAura(AuraApplication* aurApp);
+    void _RemoveProcAura(AuraApplication* aurApp);
+
     float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
     float m_weaponDamage[uint8(WeaponAttackType::MAX_ATTACK)][2];
     bool m_canModifyStats;
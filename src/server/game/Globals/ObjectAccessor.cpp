@@ -280,13 +280,13 @@ void ObjectAccessor::SaveAllPlayers()
 }
 void ObjectAccessor::AddUpdateObject(Object* obj)
 {
-    SF_SHARED_GUARD readGuard(i_objectLock);
+    SF_UNIQUE_GUARD writeGuard(i_objectLock);
     i_objects.insert(obj);
 }
 
 void ObjectAccessor::RemoveUpdateObject(Object* obj)
 {
-    SF_SHARED_GUARD readGuard(i_objectLock);
+    SF_UNIQUE_GUARD writeGuard(i_objectLock);
     i_objects.erase(obj);
 }
 
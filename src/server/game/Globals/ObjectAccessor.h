@@ -167,6 +167,7 @@ public:
     static void SaveAllPlayers();
 
     //non-static functions
+    // only objects that are not on a map end up here, see Map::SendObjectUpdates
     void AddUpdateObject(Object* obj);
     void RemoveUpdateObject(Object* obj);
 
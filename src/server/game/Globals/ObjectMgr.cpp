@@ -38,6 +38,7 @@
 #include "Vehicle.h"
 #include "WaypointManager.h"
 #include "World.h"
+#include "WorldSnapshot.h"
 
 ScriptMapMap sSpellScripts;
 ScriptMapMap sEventScripts;
@@ -1556,19 +1557,100 @@ void ObjectMgr::LoadTempSummons()
     SF_LOG_INFO("server.loading", ">> Loaded %u temp summons in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
+/// A row of the creature query as it is kept in the snapshot.
+struct CreatureSpawnRecord
+{
+    uint32 Guid;
+    uint32 Entry;
+    uint16 MapId;
+    int8 EquipmentId;
+    uint8 MovementType;
+    uint32 DisplayId;
+    float PosX;
+    float PosY;
+    float PosZ;
+    float Orientation;
+    uint32 SpawnTimeSecs;
+    float SpawnDist;
+    uint32 CurrentWaypoint;
+    uint32 CurHealth;
+    uint32 CurMana;
+    uint32 SpawnMask;
+    uint32 PhaseId;
+    uint32 PhaseGroup;
+    int16 GameEvent;
+    uint32 PoolId;
+    uint32 NpcFlag;
+    uint32 UnitFlags;
+    uint32 DynamicFlags;
+};
+
 void ObjectMgr::LoadCreatures()
 {
     uint32 oldMSTime = getMSTime();
 
-    //                                               0              1   2    3        4             5           6           7           8            9              10
-    QueryResult result = WorldDatabase.Query("SELECT creature.guid, id, map, modelid, equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, "
-        //   11               12         13       14            15            16                17                18          19             20                 21             22                    23
-        "currentwaypoint, curhealth, curmana, MovementType, spawnMask, creature.phaseid, creature.phasegroup, eventEntry, pool_entry, creature.npcflag, creature.unit_flags, creature.dynamicflags "
-        "FROM creature "
-        "LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid "
-        "LEFT OUTER JOIN pool_creature ON creature.guid = pool_creature.guid");
+    WorldSnapshot snapshot("creature", sizeof(CreatureSpawnRecord), { "creature", "game_event_creature", "pool_creature" });
+    std::vector<CreatureSpawnRecord> rows;
+    CreatureSpawnRecord const* records;
+    uint32 recordCount;
 
-    if (!result)
+    if (snapshot.Open())
+    {
+        records = snapshot.GetRecords<CreatureSpawnRecord>();
+        recordCount = snapshot.GetRecordCount();
+    }
+    else
+    {
+        //                                               0              1   2    3        4             5           6           7           8            9              10
+        QueryResult result = WorldDatabase.Query("SELECT creature.guid, id, map, modelid, equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, "
+            //   11               12         13       14            15            16                17                18          19             20                 21             22                    23
+            "currentwaypoint, curhealth, curmana, MovementType, spawnMask, creature.phaseid, creature.phasegroup, eventEntry, pool_entry, creature.npcflag, creature.unit_flags, creature.dynamicflags "
+            "FROM creature "
+            "LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid "
+            "LEFT OUTER JOIN pool_creature ON creature.guid = pool_creature.guid");
+
+        if (result)
+        {
+            rows.reserve(result->GetRowCount());
+            do
+            {
+                Field* fields = result->Fetch();
+
+                CreatureSpawnRecord row;
+                memset(&row, 0, sizeof(row));                    // padding goes into the snapshot too
+                row.Guid = fields[0].GetUInt32();
+                row.Entry = fields[1].GetUInt32();
+                row.MapId = fields[2].GetUInt16();
+                row.DisplayId = fields[3].GetUInt32();
+                row.EquipmentId = fields[4].GetInt8();
+                row.PosX = fields[5].GetFloat();
+                row.PosY = fields[6].GetFloat();
+                row.PosZ = fields[7].GetFloat();
+                row.Orientation = fields[8].GetFloat();
+                row.SpawnTimeSecs = fields[9].GetUInt32();
+                row.SpawnDist = fields[10].GetFloat();
+                row.CurrentWaypoint = fields[11].GetUInt32();
+                row.CurHealth = fields[12].GetUInt32();
+                row.CurMana = fields[13].GetUInt32();
+                row.MovementType = fields[14].GetUInt8();
+                row.SpawnMask = fields[15].GetUInt32();
+                row.PhaseId = fields[16].GetUInt32();
+                row.PhaseGroup = fields[17].GetUInt32();
+                row.GameEvent = fields[18].GetInt8();
+                row.PoolId = fields[19].GetUInt32();
+                row.NpcFlag = fields[20].GetUInt32();
+                row.UnitFlags = fields[21].GetUInt32();
+                row.DynamicFlags = fields[22].GetUInt32();
+                rows.push_back(row);
+            } while (result->NextRow());
+        }
+
+        snapshot.Write(rows.data(), uint32(rows.size()));
+        records = rows.data();
+        recordCount = uint32(rows.size());
+    }
+
+    if (!recordCount)
     {
         SF_LOG_ERROR("server.loading", ">> Loaded 0 creatures. DB table `creature` is empty.");
         return;
@@ -1582,14 +1664,14 @@ void ObjectMgr::LoadCreatures()
                 if (GetMapDifficultyData(i, DifficultyID(k)))
                     spawnMasks[i] |= (1 << k);
 
-    _creatureDataStore.rehash(result->GetRowCount());
+    _creatureDataStore.rehash(recordCount);
     uint32 count = 0;
-    do
+    for (uint32 i = 0; i < recordCount; ++i)
     {
-        Field* fields = result->Fetch();
+        CreatureSpawnRecord const& row = records[i];
 
-        uint32 guid = fields[0].GetUInt32();
-        uint32 entry = fields[1].GetUInt32();
+        uint32 guid = row.Guid;
+        uint32 entry = row.Entry;
 
         CreatureTemplate const* cInfo = GetCreatureTemplate(entry);
         if (!cInfo)
@@ -1600,27 +1682,27 @@ void ObjectMgr::LoadCreatures()
 
         CreatureData& data = _creatureDataStore[guid];
         data.id = entry;
-        data.mapid = fields[2].GetUInt16();
-        data.displayid = fields[3].GetUInt32();
-        data.equipmentId = fields[4].GetInt8();
-        data.posX = fields[5].GetFloat();
-        data.posY = fields[6].GetFloat();
-        data.posZ = fields[7].GetFloat();
-        data.orientation = fields[8].GetFloat();
-        data.spawntimesecs = fields[9].GetUInt32();
-        data.spawndist = fields[10].GetFloat();
-        data.currentwaypoint = fields[11].GetUInt32();
-        data.curhealth = fields[12].GetUInt32();
-        data.curmana = fields[13].GetUInt32();
-        data.movementType = fields[14].GetUInt8();
-        data.spawnMask = fields[15].GetUInt32();
-        data.phaseid = fields[16].GetUInt32();
-        data.phaseGroup = fields[17].GetUInt32();
-        int16 gameEvent = fields[18].GetInt8();
-        uint32 PoolId = fields[19].GetUInt32();
-        data.npcflag = fields[20].GetUInt32();
-        data.unit_flags = fields[21].GetUInt32();
-        data.dynamicflags = fields[22].GetUInt32();
+        data.mapid = row.MapId;
+        data.displayid = row.DisplayId;
+        data.equipmentId = row.EquipmentId;
+        data.posX = row.PosX;
+        data.posY = row.PosY;
+        data.posZ = row.PosZ;
+        data.orientation = row.Orientation;
+        data.spawntimesecs = row.SpawnTimeSecs;
+        data.spawndist = row.SpawnDist;
+        data.currentwaypoint = row.CurrentWaypoint;
+        data.curhealth = row.CurHealth;
+        data.curmana = row.CurMana;
+        data.movementType = row.MovementType;
+        data.spawnMask = row.SpawnMask;
+        data.phaseid = row.PhaseId;
+        data.phaseGroup = row.PhaseGroup;
+        int16 gameEvent = row.GameEvent;
+        uint32 PoolId = row.PoolId;
+        data.npcflag = row.NpcFlag;
+        data.unit_flags = row.UnitFlags;
+        data.dynamicflags = row.DynamicFlags;
 
         MapEntry const* mapEntry = sMapStore.LookupEntry(data.mapid);
         if (!mapEntry)
@@ -1700,7 +1782,7 @@ void ObjectMgr::LoadCreatures()
             AddCreatureToGrid(guid, &data);
 
         ++count;
-    } while (result->NextRow());
+    }
 
     SF_LOG_INFO("server.loading", ">> Loaded %u creatures in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
@@ -1871,20 +1953,93 @@ uint32 ObjectMgr::AddCreData(uint32 entry, uint32 /*team*/, uint32 mapId, float
     return guid;
 }
 
+/// A row of the gameobject query as it is kept in the snapshot.
+struct GameObjectSpawnRecord
+{
+    uint32 Guid;
+    uint32 Entry;
+    uint16 MapId;
+    uint8 AnimProgress;
+    uint8 State;
+    float PosX;
+    float PosY;
+    float PosZ;
+    float Orientation;
+    float Rotation0;
+    float Rotation1;
+    float Rotation2;
+    float Rotation3;
+    int32 SpawnTimeSecs;
+    uint8 SpawnMask;
+    int16 GameEvent;
+    uint32 PhaseId;
+    uint32 PhaseGroup;
+    uint32 PoolId;
+};
+
 void ObjectMgr::LoadGameobjects()
 {
     uint32 oldMSTime = getMSTime();
 
     uint32 count = 0;
 
-    //                                                0                1   2    3           4           5           6
-    QueryResult result = WorldDatabase.Query("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation, "
-        //   7          8          9          10         11             12            13     14         15         16          17           18
-        "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, phaseid, phasegroup, eventEntry, pool_entry "
-        "FROM gameobject LEFT OUTER JOIN game_event_gameobject ON gameobject.guid = game_event_gameobject.guid "
-        "LEFT OUTER JOIN pool_gameobject ON gameobject.guid = pool_gameobject.guid");
+    WorldSnapshot snapshot("gameobject", sizeof(GameObjectSpawnRecord), { "gameobject", "game_event_gameobject", "pool_gameobject" });
+    std::vector<GameObjectSpawnRecord> rows;
+    GameObjectSpawnRecord const* records;
+    uint32 recordCount;
 
-    if (!result)
+    if (snapshot.Open())
+    {
+        records = snapshot.GetRecords<GameObjectSpawnRecord>();
+        recordCount = snapshot.GetRecordCount();
+    }
+    else
+    {
+        //                                                0                1   2    3           4           5           6
+        QueryResult result = WorldDatabase.Query("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation, "
+            //   7          8          9          10         11             12            13     14         15         16          17           18
+            "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, phaseid, phasegroup, eventEntry, pool_entry "
+            "FROM gameobject LEFT OUTER JOIN game_event_gameobject ON gameobject.guid = game_event_gameobject.guid "
+            "LEFT OUTER JOIN pool_gameobject ON gameobject.guid = pool_gameobject.guid");
+
+        if (result)
+        {
+            rows.reserve(result->GetRowCount());
+            do
+            {
+                Field* fields = result->Fetch();
+
+                GameObjectSpawnRecord row;
+                memset(&row, 0, sizeof(row));                    // padding goes into the snapshot too
+                row.Guid = fields[0].GetUInt32();
+                row.Entry = fields[1].GetUInt32();
+                row.MapId = fields[2].GetUInt16();
+                row.PosX = fields[3].GetFloat();
+                row.PosY = fields[4].GetFloat();
+                row.PosZ = fields[5].GetFloat();
+                row.Orientation = fields[6].GetFloat();
+                row.Rotation0 = fields[7].GetFloat();
+                row.Rotation1 = fields[8].GetFloat();
+                row.Rotation2 = fields[9].GetFloat();
+                row.Rotation3 = fields[10].GetFloat();
+                row.SpawnTimeSecs = fields[11].GetInt32();
+                row.AnimProgress = fields[12].GetUInt8();
+                row.State = fields[13].GetUInt8();
+                row.SpawnMask = fields[14].GetUInt8();
+                row.PhaseId = fields[15].GetUInt32();
+                row.PhaseGroup = fields[16].GetUInt32();
+                row.GameEvent = fields[17].GetInt8();
+                row.PoolId = fields[18].GetUInt32();
+                rows.push_back(row);
+            } while (result->NextRow());
+        }
+
+        snapshot.Write(rows.data(), uint32(rows.size()));
+        records = rows.data();
+        recordCount = uint32(rows.size());
+    }
+
+    if (!recordCount)
     {
         SF_LOG_ERROR("server.loading", ">> Loaded 0 gameobjects. DB table `gameobject` is empty.");
         return;
@@ -1898,13 +2053,13 @@ void ObjectMgr::LoadGameobjects()
                 if (GetMapDifficultyData(i, DifficultyID(k)))
                     spawnMasks[i] |= (1 << k);
 
-    _gameObjectDataStore.rehash(result->GetRowCount());
-    do
+    _gameObjectDataStore.rehash(recordCount);
+    for (uint32 i = 0; i < recordCount; ++i)
     {
-        Field* fields = result->Fetch();
+        GameObjectSpawnRecord const& row = records[i];
 
-        uint32 guid = fields[0].GetUInt32();
-        uint32 entry = fields[1].GetUInt32();
+        uint32 guid = row.Guid;
+        uint32 entry = row.Entry;
 
         GameObjectTemplate const* gInfo = GetGameObjectTemplate(entry);
         if (!gInfo)
@@ -1935,16 +2090,16 @@ void ObjectMgr::LoadGameobjects()
         GameObjectData& data = _gameObjectDataStore[guid];
 
         data.id = entry;
-        data.mapid = fields[2].GetUInt16();
-        data.posX = fields[3].GetFloat();
-        data.posY = fields[4].GetFloat();
-        data.posZ = fields[5].GetFloat();
-        data.orientation = fields[6].GetFloat();
-        data.rotation0 = fields[7].GetFloat();
-        data.rotation1 = fields[8].GetFloat();
-        data.rotation2 = fields[9].GetFloat();
-        data.rotation3 = fields[10].GetFloat();
-        data.spawntimesecs = fields[11].GetInt32();
+        data.mapid = row.MapId;
+        data.posX = row.PosX;
+        data.posY = row.PosY;
+        data.posZ = row.PosZ;
+        data.orientation = row.Orientation;
+        data.rotation0 = row.Rotation0;
+        data.rotation1 = row.Rotation1;
+        data.rotation2 = row.Rotation2;
+        data.rotation3 = row.Rotation3;
+        data.spawntimesecs = row.SpawnTimeSecs;
 
         MapEntry const* mapEntry = sMapStore.LookupEntry(data.mapid);
         if (!mapEntry)
@@ -1958,10 +2113,10 @@ void ObjectMgr::LoadGameobjects()
             SF_LOG_ERROR("sql.sql", "Table `gameobject` has gameobject (GUID: %u Entry: %u) with `spawntimesecs` (0) value, but the gameobejct is marked as despawnable at action.", guid, data.id);
         }
 
-        data.animprogress = fields[12].GetUInt8();
+        data.animprogress = row.AnimProgress;
         data.artKit = 0;
 
-        uint32 go_state = fields[13].GetUInt8();
+        uint32 go_state = row.State;
         switch (GOState(go_state))
         {
             case GOState::GO_STATE_ACTIVE:
@@ -1978,15 +2133,15 @@ void ObjectMgr::LoadGameobjects()
         }
         data.go_state = GOState(go_state);
 
-        data.spawnMask = fields[14].GetUInt8();
+        data.spawnMask = row.SpawnMask;
 
         if (data.spawnMask & ~spawnMasks[data.mapid])
             SF_LOG_ERROR("sql.sql", "Table `gameobject` has gameobject (GUID: %u Entry: %u) that has wrong spawn mask %u including not supported difficulty modes for map (Id: %u), skip", guid, data.id, data.spawnMask, data.mapid);
 
-        data.phaseid = fields[15].GetUInt32();
-        data.phaseGroup = fields[16].GetUInt32();
-        int16 gameEvent = fields[17].GetInt8();
-        uint32 PoolId = fields[18].GetUInt32();
+        data.phaseid = row.PhaseId;
+        data.phaseGroup = row.PhaseGroup;
+        int16 gameEvent = row.GameEvent;
+        uint32 PoolId = row.PoolId;
 
         if (data.phaseGroup && GetPhasesForGroup(data.phaseGroup).empty())
         {
@@ -2021,7 +2176,7 @@ void ObjectMgr::LoadGameobjects()
         if (gameEvent == 0 && PoolId == 0)                      // if not this is to be managed by GameEvent System or Pool system
             AddGameobjectToGrid(guid, &data);
         ++count;
-    } while (result->NextRow());
+    }
 
     SF_LOG_INFO("server.loading", ">> Loaded %lu gameobjects in %u ms", (unsigned long)_gameObjectDataStore.size(), GetMSTimeDiffToNow(oldMSTime));
 }
@@ -0,0 +1,131 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include <ace/Mem_Map.h>
+#include <ace/OS_NS_stdio.h>
+#include <ace/OS_NS_sys_stat.h>
+
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include "World.h"
+#include "WorldSnapshot.h"
+
+WorldSnapshot::WorldSnapshot(char const* name, uint32 recordSize, std::initializer_list<char const*> tables) :
+    _name(name), _recordSize(recordSize), _tables(tables.begin(), tables.end()), _checksum(0), _hasChecksum(false),
+    _fileMap(NULL), _records(NULL), _recordCount(0)
+{
+    _path = sWorld->GetDataPath() + "snapshots/" + _name + ".snapshot";
+}
+
+WorldSnapshot::~WorldSnapshot()
+{
+    delete _fileMap;
+}
+
+bool WorldSnapshot::Open()
+{
+    if (!sWorld->GetBoolConfig(WorldBoolConfigs::CONFIG_WORLD_SNAPSHOTS))
+        return false;
+
+    // without a checksum a snapshot is neither used nor written
+    if (!ReadChecksum())
+        return false;
+
+    _fileMap = new ACE_Mem_Map();
+    if (_fileMap->map(_path.c_str(), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == -1)
+    {
+        delete _fileMap;
+        _fileMap = NULL;
+        return false;
+    }
+
+    uint8 const* data = static_cast<uint8 const*>(_fileMap->addr());
+    size_t size = std::min<size_t>(_fileMap->size(), ACE_OS::filesize(_fileMap->handle()));
+
+    WorldSnapshotHeader header;
+    if (size < sizeof(header))
+        header.Magic = 0;
+    else
+        memcpy(&header, data, sizeof(header));
+
+    if (header.Magic != WORLD_SNAPSHOT_MAGIC || header.Version != WORLD_SNAPSHOT_VERSION || header.RecordSize != _recordSize ||
+        header.Checksum != _checksum || (size - sizeof(header)) / _recordSize < header.RecordCount)
+    {
+        delete _fileMap;
+        _fileMap = NULL;
+        return false;
+    }
+
+    _records = data + sizeof(header);
+    _recordCount = header.RecordCount;
+
+    SF_LOG_INFO("server.loading", "Using the %s snapshot, %u rows", _name.c_str(), _recordCount);
+    return true;
+}
+
+void WorldSnapshot::Write(void const* records, uint32 count)
+{
+    if (!_hasChecksum)
+        return;
+
+    std::string directory = sWorld->GetDataPath() + "snapshots";
+    ACE_OS::mkdir(directory.c_str());
+
+    // written next to it and renamed, a server that mapped the old file keeps reading that
+    std::string temporary = _path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file)
+    {
+        SF_LOG_ERROR("server.loading", "WorldSnapshot: could not create %s, the %s rows are read from the database on the next start too", temporary.c_str(), _name.c_str());
+        return;
+    }
+
+    WorldSnapshotHeader header;
+    header.Magic = WORLD_SNAPSHOT_MAGIC;
+    header.Version = WORLD_SNAPSHOT_VERSION;
+    header.RecordSize = _recordSize;
+    header.RecordCount = count;
+    header.Checksum = _checksum;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        (!count || fwrite(records, _recordSize, count, file) == count);
+
+    if (fclose(file) != 0 || !written || ACE_OS::rename(temporary.c_str(), _path.c_str()) != 0)
+    {
+        SF_LOG_ERROR("server.loading", "WorldSnapshot: could not write %s", _path.c_str());
+        remove(temporary.c_str());
+    }
+}
+
+bool WorldSnapshot::ReadChecksum()
+{
+    std::string tables;
+    for (std::string const& table : _tables)
+    {
+        if (!tables.empty())
+            tables += ", ";
+        tables += table;
+    }
+
+    //                                          0       1
+    QueryResult result = WorldDatabase.PQuery("CHECKSUM TABLE %s", tables.c_str());
+    if (!result || result->GetRowCount() != _tables.size())
+        return false;
+
+    _checksum = WORLD_SNAPSHOT_VERSION;
+    do
+    {
+        Field* fields = result->Fetch();
+
+        // a table that does not exist has no checksum
+        if (fields[1].IsNull())
+            return false;
+
+        _checksum = (_checksum ^ fields[1].GetUInt64()) * 0x100000001B3ULL;
+    } while (result->NextRow());
+
+    _hasChecksum = true;
+    return true;
+}
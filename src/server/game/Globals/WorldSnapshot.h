@@ -0,0 +1,76 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef SF_WORLD_SNAPSHOT_H
+#define SF_WORLD_SNAPSHOT_H
+
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Define.h"
+
+class ACE_Mem_Map;
+
+#define WORLD_SNAPSHOT_MAGIC    0x53575346                  // "FSWS"
+#define WORLD_SNAPSHOT_VERSION  1                           // raise when the layout of a record changes
+
+struct WorldSnapshotHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint32 RecordSize;
+    uint32 RecordCount;
+    uint64 Checksum;                                        // of the source tables, CHECKSUM TABLE
+};
+
+/*
+ * The rows a loader read from world tables, kept in DataDir/snapshots.
+ *
+ * The world tables only change when new content is deployed. A loader opens
+ * its snapshot with the tables its query reads, the snapshot is only used while
+ * their checksums are the same as when it was written. The file is mapped read
+ * only and the loader builds its data from the records in there, the checks of
+ * the loader still run on every start. Without a valid snapshot the loader
+ * queries the database and writes a new one from the rows it read.
+ */
+class WorldSnapshot
+{
+public:
+    WorldSnapshot(char const* name, uint32 recordSize, std::initializer_list<char const*> tables);
+    ~WorldSnapshot();
+
+    // maps the snapshot, false if there is none or the tables changed since it was written
+    bool Open();
+    // replaces the snapshot, readers of the old file keep their mapping
+    void Write(void const* records, uint32 count);
+
+    template<class Record>
+    Record const* GetRecords() const
+    {
+        static_assert(std::is_trivially_copyable<Record>::value, "snapshot records are written as they are in memory");
+        return reinterpret_cast<Record const*>(_records);
+    }
+
+    uint32 GetRecordCount() const { return _recordCount; }
+
+private:
+    bool ReadChecksum();
+
+    std::string _name;
+    std::string _path;
+    uint32 _recordSize;
+    std::vector<std::string> _tables;
+
+    uint64 _checksum;
+    bool _hasChecksum;                                      // false if a table has none, it is not snapshot then
+
+    ACE_Mem_Map* _fileMap;
+    uint8 const* _records;
+    uint32 _recordCount;
+};
+
+#endif
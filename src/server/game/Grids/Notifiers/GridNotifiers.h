@@ -117,9 +117,10 @@ namespace Skyfire
         float i_distSq;
         uint32 team;
         Player const* skipped_receiver;
+        WorldPacketBroadcast i_broadcast;
         MessageDistDeliverer(WorldObject* src, WorldPacket* msg, float dist, bool own_team_only = false, Player const* skipped = NULL)
             : i_source(src), i_message(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist* dist),
-            team(0), skipped_receiver(skipped)
+            team(0), skipped_receiver(skipped), i_broadcast(msg)
         {
             if (own_team_only)
                 if (Player* player = src->ToPlayer())
@@ -1966,6 +1966,7 @@ void Group::BroadcastAddonMessagePacket(WorldPacket* packet, const std::string&
 
 void Group::BroadcastPacket(WorldPacket* packet, bool ignorePlayersInBGRaid, int group, uint64 ignore)
 {
+    WorldPacketBroadcast broadcast(packet);
     for (GroupReference* itr = GetFirstMember(); itr != NULL; itr = itr->next())
     {
         Player* player = itr->GetSource();
@@ -2765,6 +2765,7 @@ void Guild::BroadcastPacketToRank(WorldPacket* packet, uint8 rankId) const
 
 void Guild::BroadcastPacket(WorldPacket* packet) const
 {
+    WorldPacketBroadcast broadcast(packet);
     for (Members::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
         if (Player* player = itr->second->FindPlayer())
             player->GetSession()->SendPacket(packet);
@@ -3537,7 +3538,7 @@ void Guild::_BroadcastEvent(GuildEvents guildEvent, uint64 guid, const char* par
 
     BroadcastPacket(&data);
 
-    if (sLog->ShouldLog("guild", LogLevel::LOG_LEVEL_DEBUG))
+    if (SF_LOG_ENABLED("guild", LogLevel::LOG_LEVEL_DEBUG))
         SF_LOG_DEBUG("guild", "SMSG_GUILD_EVENT [Broadcast] Event: %s (%u)", _GetGuildEventString(guildEvent).c_str(), guildEvent);
 }
 
@@ -15,6 +15,7 @@
 #include "UnaryFunction.h"
 #include "Util.h"
 #include "World.h"
+#include "WorldSnapshot.h"
 
 static Rates const qualityToRate[MAX_ITEM_QUALITY] =
 {
@@ -111,6 +112,18 @@ void LootStore::Verify() const
         i->second->Verify(*this, i->first);
 }
 
+// A row of a loot table as it is kept in the snapshot
+struct LootSnapshotRecord
+{
+    uint32 Entry;
+    uint32 Item;
+    float ChanceOrQuestChance;
+    uint16 LootMode;
+    uint8 Group;
+    uint8 MaxCount;
+    int32 MinCountOrRef;
+};
+
 // Loads a *_loot_template DB table into loot store
 // All checks of the loaded template are called from here, no error reports at loot generation required
 uint32 LootStore::LoadLootTable()
@@ -120,25 +133,61 @@ uint32 LootStore::LoadLootTable()
     // Clearing store (for reloading case)
     Clear();
 
-    //                                                  0     1            2               3         4         5             6
-    QueryResult result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, lootmode, groupid, mincountOrRef, maxcount FROM %s", GetName());
+    WorldSnapshot snapshot(GetName(), sizeof(LootSnapshotRecord), { GetName() });
+    std::vector<LootSnapshotRecord> rows;
+    LootSnapshotRecord const* records;
+    uint32 recordCount;
+
+    if (snapshot.Open())
+    {
+        records = snapshot.GetRecords<LootSnapshotRecord>();
+        recordCount = snapshot.GetRecordCount();
+    }
+    else
+    {
+        //                                                  0     1            2               3         4         5             6
+        QueryResult result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, lootmode, groupid, mincountOrRef, maxcount FROM %s", GetName());
 
-    if (!result)
+        if (result)
+        {
+            rows.reserve(result->GetRowCount());
+            do
+            {
+                Field* fields = result->Fetch();
+
+                LootSnapshotRecord row;
+                row.Entry = fields[0].GetUInt32();
+                row.Item = fields[1].GetUInt32();
+                row.ChanceOrQuestChance = fields[2].GetFloat();
+                row.LootMode = fields[3].GetUInt16();
+                row.Group = fields[4].GetUInt8();
+                row.MinCountOrRef = fields[5].GetInt32();
+                row.MaxCount = fields[6].GetUInt8();
+                rows.push_back(row);
+            } while (result->NextRow());
+        }
+
+        snapshot.Write(rows.data(), uint32(rows.size()));
+        records = rows.data();
+        recordCount = uint32(rows.size());
+    }
+
+    if (!recordCount)
         return 0;
 
     uint32 count = 0;
 
-    do
+    for (uint32 i = 0; i < recordCount; ++i)
     {
-        Field* fields = result->Fetch();
+        LootSnapshotRecord const& row = records[i];
 
-        uint32 entry = fields[0].GetUInt32();
-        uint32 item = fields[1].GetUInt32();
-        float  chanceOrQuestChance = fields[2].GetFloat();
-        uint16 lootmode = fields[3].GetUInt16();
-        uint8  group = fields[4].GetUInt8();
-        int32  mincountOrRef = fields[5].GetInt32();
-        int32  maxcount = fields[6].GetUInt8();
+        uint32 entry = row.Entry;
+        uint32 item = row.Item;
+        float  chanceOrQuestChance = row.ChanceOrQuestChance;
+        uint16 lootmode = row.LootMode;
+        uint8  group = row.Group;
+        int32  mincountOrRef = row.MinCountOrRef;
+        int32  maxcount = row.MaxCount;
 
         if (maxcount > std::numeric_limits<uint8>::max())
         {
@@ -178,7 +227,7 @@ uint32 LootStore::LoadLootTable()
         // Adds current row to the template
         tab->second->AddEntry(storeitem);
         ++count;
-    } while (result->NextRow());
+    }
 
     Verify();                                           // Checks validity of the loot store
 
@@ -0,0 +1,207 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include "GridPrefetcher.h"
+#include "Log.h"
+#include "Map.h"
+#include "MMapFactory.h"
+#include "VMapFactory.h"
+#include "VMapManager2.h"
+#include "World.h"
+
+namespace
+{
+    // time a prefetched grid is kept for the map to take it
+    uint32 const PREFETCH_EXPIRY = 60 * IN_MILLISECONDS;
+}
+
+PrefetchedGrid::~PrefetchedGrid()
+{
+    delete Terrain;
+
+    if (NavTile)
+    {
+        dtFree(NavTile->data);
+        delete NavTile;
+    }
+
+    if (!Models.empty())
+    {
+        VMAP::VMapManager2* vmgr = (VMAP::VMapManager2*)VMAP::VMapFactory::createOrGetVMapManager();
+        for (std::string const& name : Models)
+            vmgr->releaseModelInstance(name);
+    }
+}
+
+GridPrefetcher::GridPrefetcher() : _cancelationToken(false) { }
+
+GridPrefetcher::~GridPrefetcher()
+{
+    Deactivate();
+}
+
+void GridPrefetcher::Activate(size_t threads)
+{
+    if (IsActive())
+        return;
+
+    _cancelationToken = false;
+
+    for (size_t i = 0; i < threads; ++i)
+        _threads.push_back(std::thread(&GridPrefetcher::WorkerThread, this));
+}
+
+void GridPrefetcher::Deactivate()
+{
+    if (!IsActive())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _cancelationToken = true;
+    }
+    _workAvailable.notify_all();
+
+    for (std::thread& thread : _threads)
+        thread.join();
+
+    _threads.clear();
+
+    for (RequestMap::iterator itr = _requests.begin(); itr != _requests.end(); ++itr)
+        delete itr->second.Grid;
+
+    _requests.clear();
+    _queue.clear();
+}
+
+void GridPrefetcher::Prefetch(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!IsActive())
+        return;
+
+    uint64 key = MakeKey(mapId, gx, gy);
+    Request request = { REQUEST_QUEUED, 0, NULL };
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (!_requests.insert(RequestMap::value_type(key, request)).second)
+            return;
+
+        _queue.push_back(key);
+    }
+    _workAvailable.notify_one();
+}
+
+PrefetchedGrid* GridPrefetcher::Take(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!IsActive())
+        return NULL;
+
+    uint64 key = MakeKey(mapId, gx, gy);
+
+    std::unique_lock<std::mutex> guard(_lock);
+    RequestMap::iterator itr;
+    while (true)
+    {
+        itr = _requests.find(key);
+        if (itr == _requests.end())
+            return NULL;
+
+        // loading it again here would only take longer
+        if (itr->second.State != REQUEST_LOADING)
+            break;
+
+        _loaded.wait(guard);
+    }
+
+    // a queued request is dropped, the worker skips it
+    PrefetchedGrid* grid = itr->second.Grid;
+    _requests.erase(itr);
+    return grid;
+}
+
+void GridPrefetcher::Update(uint32 diff)
+{
+    if (!IsActive())
+        return;
+
+    std::vector<PrefetchedGrid*> expired;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        for (RequestMap::iterator itr = _requests.begin(); itr != _requests.end();)
+        {
+            if (itr->second.State == REQUEST_READY && (itr->second.Age += diff) >= PREFETCH_EXPIRY)
+            {
+                expired.push_back(itr->second.Grid);
+                itr = _requests.erase(itr);
+            }
+            else
+                ++itr;
+        }
+    }
+
+    // releasing vmap models takes their lock, not done while holding ours
+    for (PrefetchedGrid* grid : expired)
+        delete grid;
+}
+
+void GridPrefetcher::WorkerThread()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    while (true)
+    {
+        while (_queue.empty() && !_cancelationToken)
+            _workAvailable.wait(guard);
+
+        if (_cancelationToken)
+            return;
+
+        uint64 key = _queue.front();
+        _queue.pop_front();
+
+        RequestMap::iterator itr = _requests.find(key);
+        if (itr == _requests.end() || itr->second.State != REQUEST_QUEUED)
+            continue;
+
+        // requests being loaded are never erased, the reference stays valid while unlocked
+        Request& request = itr->second;
+        request.State = REQUEST_LOADING;
+
+        guard.unlock();
+        PrefetchedGrid* grid = Load(uint32(key >> 16), uint32(key >> 8) & 0xFF, uint32(key) & 0xFF);
+        guard.lock();
+
+        request.State = REQUEST_READY;
+        request.Age = 0;
+        request.Grid = grid;
+        _loaded.notify_all();
+    }
+}
+
+PrefetchedGrid* GridPrefetcher::Load(uint32 mapId, uint32 gx, uint32 gy)
+{
+    PrefetchedGrid* grid = new PrefetchedGrid();
+    std::string dataPath = sWorld->GetDataPath();
+
+    int len = dataPath.length() + strlen("maps/%04u_%02u_%02u.map") + 1;
+    char* fileName = new char[len];
+    snprintf(fileName, len, (dataPath + "maps/%04u_%02u_%02u.map").c_str(), mapId, gx, gy);
+
+    // a file that fails is loaded again by the map, which reports the error
+    grid->Terrain = new GridMap();
+    if (!grid->Terrain->loadData(fileName))
+    {
+        delete grid->Terrain;
+        grid->Terrain = NULL;
+    }
+    delete[] fileName;
+
+    ((VMAP::VMapManager2*)VMAP::VMapFactory::createOrGetVMapManager())->preloadMapTile((dataPath + "vmaps").c_str(), mapId, gx, gy, grid->Models);
+    grid->NavTile = MMAP::MMapFactory::createOrGetMMapManager()->LoadTile(mapId, gx, gy);
+
+    SF_LOG_DEBUG("maps", "GridPrefetcher: prefetched grid [%u, %u] of map %u", gx, gy, mapId);
+    return grid;
+}
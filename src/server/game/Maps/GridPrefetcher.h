@@ -0,0 +1,99 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef SF_GRID_PREFETCHER_H
+#define SF_GRID_PREFETCHER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Define.h"
+
+class GridMap;
+
+namespace MMAP
+{
+    struct PhasedTile;
+}
+
+/// Terrain of one grid read ahead of its creation, whatever is not taken by the map is freed with it.
+struct PrefetchedGrid
+{
+    PrefetchedGrid() : Terrain(NULL), NavTile(NULL) { }
+    ~PrefetchedGrid();
+
+    GridMap* Terrain;
+    MMAP::PhasedTile* NavTile;                              // handed to MMapManager::loadMap()
+    std::vector<std::string> Models;                        // vmap model references held until the tile is loaded
+
+private:
+    PrefetchedGrid(PrefetchedGrid const&) = delete;
+    PrefetchedGrid& operator=(PrefetchedGrid const&) = delete;
+};
+
+/*
+ * Loads the terrain of grids that players are about to enter on background threads.
+ *
+ * Continents request the grids ahead of moving and flying players from their
+ * update. The workers read the .map file into a GridMap, the models of the
+ * vmap tile and the mmap tile, none of which touches shared map state. The
+ * map picks the result up when it creates the grid, so only putting the data
+ * in place is left for its update thread.
+ */
+class GridPrefetcher
+{
+public:
+    GridPrefetcher();
+    ~GridPrefetcher();
+
+    void Activate(size_t threads);
+    void Deactivate();
+    bool IsActive() const { return !_threads.empty(); }
+
+    // queues the grid unless it is queued or loaded already
+    void Prefetch(uint32 mapId, uint32 gx, uint32 gy);
+    // the prefetched data of the grid or NULL, waits if it is being loaded right now
+    PrefetchedGrid* Take(uint32 mapId, uint32 gx, uint32 gy);
+    // frees data that was not taken in time, the prediction was wrong then
+    void Update(uint32 diff);
+
+private:
+    enum RequestState
+    {
+        REQUEST_QUEUED,
+        REQUEST_LOADING,
+        REQUEST_READY
+    };
+
+    struct Request
+    {
+        RequestState State;
+        uint32 Age;
+        PrefetchedGrid* Grid;
+    };
+
+    typedef std::unordered_map<uint64, Request> RequestMap;
+
+    static uint64 MakeKey(uint32 mapId, uint32 gx, uint32 gy) { return uint64(mapId) << 16 | gx << 8 | gy; }
+
+    void WorkerThread();
+    static PrefetchedGrid* Load(uint32 mapId, uint32 gx, uint32 gy);
+
+    std::vector<std::thread> _threads;
+    RequestMap _requests;
+    std::deque<uint64> _queue;
+    bool _cancelationToken;
+
+    std::mutex _lock;
+    std::condition_variable _workAvailable;
+    std::condition_variable _loaded;
+};
+
+#endif
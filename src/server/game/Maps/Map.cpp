@@ -8,6 +8,7 @@
 #include "DynamicTree.h"
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
+#include "GridPrefetcher.h"
 #include "GridStates.h"
 #include "Group.h"
 #include "InstanceScript.h"
@@ -22,6 +23,10 @@
 #include "Transport.h"
 #include "Vehicle.h"
 #include "VMapFactory.h"
+#include "WaypointMovementGenerator.h"
+
+#include <ace/Mem_Map.h>
+#include <memory>
 
 u_map_magic MapMagic = { {'M', 'A', 'P', 'S'} };
 u_map_magic MapVersionMagic = { {'v', '1', '.', '4'} };
@@ -31,6 +36,7 @@ u_map_magic MapLiquidMagic = { {'M', 'L', 'I', 'Q'} };
 
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
+#define GRID_PREFETCH_INTERVAL  1000
 #define MAX_CREATURE_ATTACK_RADIUS  (45.0f * sWorld->getRate(RATE_CREATURE_AGGRO))
 
 GridState* si_GridStates[MAX_GRID_STATE];
@@ -117,9 +123,13 @@ bool Map::ExistVMap(uint32 mapid, int gx, int gy)
     return true;
 }
 
-void Map::LoadMMap(int gx, int gy)
+void Map::LoadMMap(int gx, int gy, PrefetchedGrid* prefetch)
 {
-    bool mmapLoadResult = MMAP::MMapFactory::createOrGetMMapManager()->loadMap((sWorld->GetDataPath() + "mmaps").c_str(), GetId(), gx, gy);
+    MMAP::PhasedTile* tile = NULL;
+    if (prefetch)
+        std::swap(tile, prefetch->NavTile);
+
+    bool mmapLoadResult = MMAP::MMapFactory::createOrGetMMapManager()->loadMap((sWorld->GetDataPath() + "mmaps").c_str(), GetId(), gx, gy, tile);
 
     if (mmapLoadResult)
         SF_LOG_INFO("maps", "MMAP loaded name:%s, id:%d, x:%d, y:%d (mmap rep.: x:%d, y:%d)", GetMapName(), GetId(), gx, gy, gx, gy);
@@ -145,7 +155,7 @@ void Map::LoadVMap(int gx, int gy)
     }
 }
 
-void Map::LoadMap(int gx, int gy, bool reload)
+void Map::LoadMap(int gx, int gy, bool reload, PrefetchedGrid* prefetch)
 {
     if (i_InstanceId != 0)
     {
@@ -180,10 +190,15 @@ void Map::LoadMap(int gx, int gy, bool reload)
     tmp = new char[len];
     snprintf(tmp, len, (char*)(sWorld->GetDataPath() + "maps/%04u_%02u_%02u.map").c_str(), GetId(), gx, gy);
     SF_LOG_INFO("maps", "Loading map %s", tmp);
-    // loading data
-    GridMaps[gx][gy] = new GridMap();
-    if (!GridMaps[gx][gy]->loadData(tmp))
-        SF_LOG_ERROR("maps", "Error loading map file: \n %s\n", tmp);
+    // loading data, unless the prefetcher did already
+    if (prefetch && prefetch->Terrain)
+        std::swap(GridMaps[gx][gy], prefetch->Terrain);
+    else
+    {
+        GridMaps[gx][gy] = new GridMap();
+        if (!GridMaps[gx][gy]->loadData(tmp))
+            SF_LOG_ERROR("maps", "Error loading map file: \n %s\n", tmp);
+    }
     delete[] tmp;
 
     sScriptMgr->OnLoadGridMap(this, GridMaps[gx][gy], gx, gy);
@@ -191,13 +206,24 @@ void Map::LoadMap(int gx, int gy, bool reload)
 
 void Map::LoadMapAndVMap(int gx, int gy)
 {
-    LoadMap(gx, gy);
     // Only load the data for the base map
     if (i_InstanceId == 0)
     {
+        // data read ahead on the prefetch threads only has to be put in place
+        PrefetchedGrid* prefetch = sMapMgr->GetGridPrefetcher()->Take(GetId(), gx, gy);
+
+        LoadMap(gx, gy, false, prefetch);
         LoadVMap(gx, gy);
-        LoadMMap(gx, gy);
+        LoadMMap(gx, gy, prefetch);
+
+        // gives back the model references, the tile holds its own now
+        delete prefetch;
     }
+    else
+        LoadMap(gx, gy);
+
+    // queries answered without this grid are outdated now
+    _queryCache.InvalidateTerrain();
 }
 
 void Map::InitStateMachine()
@@ -223,8 +249,10 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _par
     m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
     m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
     i_gridExpiry(expiry),
-    i_scriptLock(false)
+    i_scriptLock(false), _lastUpdateCost(0)
 {
+    _gridPrefetchTimer.SetInterval(GRID_PREFETCH_INTERVAL);
+
     m_parentMap = (_parent ? _parent : this);
     for (unsigned int idx = 0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
     {
@@ -367,7 +395,7 @@ template<>
 void Map::DeleteFromWorld(Player* player)
 {
     sObjectAccessor->RemoveObject(player);
-    sObjectAccessor->RemoveUpdateObject(player); /// @todo I do not know why we need this, it should be removed in ~Object anyway
+    RemoveUpdateObject(player); /// @todo I do not know why we need this, it should be removed in ~Object anyway
     delete player;
 }
 
@@ -652,6 +680,8 @@ void Map::Update(const uint32 t_diff)
         VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
     }
 
+    PrefetchGrids(t_diff);
+
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
     {
         WorldObject* obj = *_transportsUpdateIter;
@@ -678,6 +708,107 @@ void Map::Update(const uint32 t_diff)
         ProcessRelocationNotifies(t_diff);
 
     sScriptMgr->OnMapUpdate(this, t_diff);
+
+    SendObjectUpdates();
+}
+
+void Map::PrefetchGrids(uint32 diff)
+{
+    // instances are small and share the terrain of their base map
+    if (Instanceable() || !sMapMgr->GetGridPrefetcher()->IsActive())
+        return;
+
+    _gridPrefetchTimer.Update(diff);
+    if (!_gridPrefetchTimer.Passed())
+        return;
+
+    _gridPrefetchTimer.Reset();
+
+    float lookAhead = float(sWorld->getIntConfig(WorldIntConfigs::CONFIG_GRID_PREFETCH_LOOKAHEAD));
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        // taxi flights follow a known path at the speed of the flight path generator
+        if (player->GetMotionMaster()->GetCurrentMovementGeneratorType() == FLIGHT_MOTION_TYPE)
+        {
+            FlightPathMovementGenerator* flight = static_cast<FlightPathMovementGenerator*>(player->GetMotionMaster()->top());
+            TaxiPathNodeList const& path = flight->GetPath();
+
+            float distance = 32.0f * lookAhead;
+            float x = player->GetPositionX();
+            float y = player->GetPositionY();
+            for (uint32 i = flight->GetCurrentNode(); i < path.size() && distance > 0.0f; ++i)
+            {
+                if (path[i].mapid != GetId())
+                    break;
+
+                distance -= std::sqrt((path[i].x - x) * (path[i].x - x) + (path[i].y - y) * (path[i].y - y));
+                x = path[i].x;
+                y = path[i].y;
+                PrefetchGrid(x, y);
+            }
+            continue;
+        }
+
+        if (!player->isMoving())
+            continue;
+
+        float forward = float(player->HasUnitMovementFlag(MOVEMENTFLAG_FORWARD)) - float(player->HasUnitMovementFlag(MOVEMENTFLAG_BACKWARD));
+        float strafe = float(player->HasUnitMovementFlag(MOVEMENTFLAG_STRAFE_LEFT)) - float(player->HasUnitMovementFlag(MOVEMENTFLAG_STRAFE_RIGHT));
+        if (!forward && !strafe)
+            continue;
+
+        // grids are created once they come into sight, so look that much further
+        float angle = player->GetOrientation() + std::atan2(strafe, forward);
+        float distance = player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN) * lookAhead + GetVisibilityRange();
+
+        // two probes per grid length do not skip a grid crossed on the way
+        for (float d = SIZE_OF_GRIDS / 2; d <= distance; d += SIZE_OF_GRIDS / 2)
+            PrefetchGrid(player->GetPositionX() + d * std::cos(angle), player->GetPositionY() + d * std::sin(angle));
+    }
+}
+
+void Map::PrefetchGrid(float x, float y)
+{
+    if (!Skyfire::IsValidMapCoord(x, y))
+        return;
+
+    GridCoord p = Skyfire::ComputeGridCoord(x, y);
+    int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+    if (!GridMaps[gx][gy])
+        sMapMgr->GetGridPrefetcher()->Prefetch(GetId(), gx, gy);
+}
+
+void Map::SendObjectUpdates()
+{
+    UpdateDataMapType update_players;
+    std::set<Object*> objects;
+
+    {
+        std::lock_guard<std::mutex> guard(_updateObjectsLock);
+        objects.swap(_updateObjects);
+    }
+
+    for (std::set<Object*>::const_iterator itr = objects.begin(); itr != objects.end(); ++itr)
+    {
+        Object* obj = *itr;
+        ASSERT(obj && obj->IsInWorld());
+        obj->BuildUpdate(update_players);
+    }
+
+    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
+    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    {
+        iter->second.BuildPacket(&packet);
+        iter->first->GetSession()->SendPacket(&packet);
+        packet.clear();                                     // clean the string
+    }
 }
 
 struct ResetNotifier
@@ -1328,6 +1459,7 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
 
         GridMaps[gx][gy] = NULL;
     }
+    _queryCache.InvalidateTerrain();
     SF_LOG_DEBUG("maps", "Unloading grid[%u, %u] for map %u finished", x, y, GetId());
     return true;
 }
@@ -1371,6 +1503,10 @@ bool GridMap::loadData(char* filename)
     // Unload old data if exist
     unloadData();
 
+    // Any file the mapping can't be used for is read below, which also reports the errors
+    if (sWorld->GetBoolConfig(WorldBoolConfigs::CONFIG_MAP_FILE_MAPPING) && mapData(filename))
+        return true;
+
     map_fileheader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
@@ -1418,12 +1554,22 @@ bool GridMap::loadData(char* filename)
 
 void GridMap::unloadData()
 {
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_areaMap;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquidMap;
+    if (m_fileMap)
+    {
+        // the arrays point into the file
+        delete m_fileMap;
+        m_fileMap = NULL;
+    }
+    else
+    {
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] m_areaMap;
+        delete[] m_liquidEntry;
+        delete[] m_liquidFlags;
+        delete[] m_liquidMap;
+    }
+
     m_V9 = NULL;
     m_V8 = NULL;
     m_areaMap = NULL;
@@ -1531,6 +1677,152 @@ bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
+namespace
+{
+    template<class T>
+    bool ReadMappedHeader(uint8 const* data, size_t size, size_t offset, T& header)
+    {
+        if (offset > size || size - offset < sizeof(T))
+            return false;
+
+        memcpy(&header, data + offset, sizeof(T));
+        return true;
+    }
+
+    // Arrays are used in place, so they have to be complete and aligned for their type
+    template<class T>
+    T* GetMappedArray(uint8 const* data, size_t size, size_t offset, size_t count)
+    {
+        if (offset > size || (size - offset) / sizeof(T) < count || uintptr_t(data + offset) % alignof(T))
+            return NULL;
+
+        return reinterpret_cast<T*>(const_cast<uint8*>(data + offset));
+    }
+}
+
+bool GridMap::mapData(char const* filename)
+{
+    // Pages are only read in when first used and the page cache shares them between all
+    // processes and restarts, the file must not be rewritten while the server runs
+    m_fileMap = new ACE_Mem_Map();
+    if (m_fileMap->map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == -1)
+    {
+        delete m_fileMap;
+        m_fileMap = NULL;
+        return false;
+    }
+
+    // an empty file still gets a page mapped, which must not be touched
+    uint8 const* data = static_cast<uint8 const*>(m_fileMap->addr());
+    size_t size = std::min<size_t>(m_fileMap->size(), ACE_OS::filesize(m_fileMap->handle()));
+
+    // the mapping stays valid without the descriptor, thousands of loaded tiles must not hold one each
+    m_fileMap->close_handle();
+
+    map_fileheader header;
+    if (!ReadMappedHeader(data, size, 0, header) ||
+        header.mapMagic.asUInt != MapMagic.asUInt || header.versionMagic.asUInt != MapVersionMagic.asUInt ||
+        (header.areaMapOffset && !mapAreaData(data, size, header.areaMapOffset)) ||
+        (header.heightMapOffset && !mapHeightData(data, size, header.heightMapOffset)) ||
+        (header.liquidMapOffset && !mapLiquidData(data, size, header.liquidMapOffset)))
+    {
+        unloadData();
+        return false;
+    }
+
+    return true;
+}
+
+bool GridMap::mapAreaData(uint8 const* data, size_t size, uint32 offset)
+{
+    map_areaHeader header;
+    if (!ReadMappedHeader(data, size, offset, header) || header.fourcc != MapAreaMagic.asUInt)
+        return false;
+
+    m_gridArea = header.gridArea;
+    if (!(header.flags & MAP_AREA_NO_AREA))
+    {
+        m_areaMap = GetMappedArray<uint16>(data, size, offset + sizeof(header), 16 * 16);
+        if (!m_areaMap)
+            return false;
+    }
+    return true;
+}
+
+bool GridMap::mapHeightData(uint8 const* data, size_t size, uint32 offset)
+{
+    map_heightHeader header;
+    if (!ReadMappedHeader(data, size, offset, header) || header.fourcc != MapHeightMagic.asUInt)
+        return false;
+
+    size_t v9 = offset + sizeof(header);
+
+    m_gridHeight = header.gridHeight;
+    if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
+    {
+        if ((header.flags & MAP_HEIGHT_AS_INT16))
+        {
+            m_uint16_V9 = GetMappedArray<uint16>(data, size, v9, 129 * 129);
+            m_uint16_V8 = GetMappedArray<uint16>(data, size, v9 + sizeof(uint16) * 129 * 129, 128 * 128);
+            if (!m_uint16_V9 || !m_uint16_V8)
+                return false;
+            m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
+            m_gridGetHeight = &GridMap::getHeightFromUint16;
+        }
+        else if ((header.flags & MAP_HEIGHT_AS_INT8))
+        {
+            m_uint8_V9 = GetMappedArray<uint8>(data, size, v9, 129 * 129);
+            m_uint8_V8 = GetMappedArray<uint8>(data, size, v9 + sizeof(uint8) * 129 * 129, 128 * 128);
+            if (!m_uint8_V9 || !m_uint8_V8)
+                return false;
+            m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
+            m_gridGetHeight = &GridMap::getHeightFromUint8;
+        }
+        else
+        {
+            m_V9 = GetMappedArray<float>(data, size, v9, 129 * 129);
+            m_V8 = GetMappedArray<float>(data, size, v9 + sizeof(float) * 129 * 129, 128 * 128);
+            if (!m_V9 || !m_V8)
+                return false;
+            m_gridGetHeight = &GridMap::getHeightFromFloat;
+        }
+    }
+    else
+        m_gridGetHeight = &GridMap::getHeightFromFlat;
+    return true;
+}
+
+bool GridMap::mapLiquidData(uint8 const* data, size_t size, uint32 offset)
+{
+    map_liquidHeader header;
+    if (!ReadMappedHeader(data, size, offset, header) || header.fourcc != MapLiquidMagic.asUInt)
+        return false;
+
+    m_liquidType = header.liquidType;
+    m_liquidOffX = header.offsetX;
+    m_liquidOffY = header.offsetY;
+    m_liquidWidth = header.width;
+    m_liquidHeight = header.height;
+    m_liquidLevel = header.liquidLevel;
+
+    size_t pos = offset + sizeof(header);
+    if (!(header.flags & MAP_LIQUID_NO_TYPE))
+    {
+        m_liquidEntry = GetMappedArray<uint16>(data, size, pos, 16 * 16);
+        m_liquidFlags = GetMappedArray<uint8>(data, size, pos + sizeof(uint16) * 16 * 16, 16 * 16);
+        if (!m_liquidEntry || !m_liquidFlags)
+            return false;
+        pos += (sizeof(uint16) + sizeof(uint8)) * 16 * 16;
+    }
+    if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
+    {
+        m_liquidMap = GetMappedArray<float>(data, size, pos, uint32(m_liquidWidth) * uint32(m_liquidHeight));
+        if (!m_liquidMap)
+            return false;
+    }
+    return true;
+}
+
 uint16 GridMap::getArea(float x, float y) const
 {
     if (!m_areaMap)
@@ -2196,27 +2488,136 @@ void Map::GetZoneAndAreaIdByAreaFlag(uint32& zoneid, uint32& areaid, uint16 area
 
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
-        && _dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask);
+    MapQueryKey key;
+    bool cache = MapQueryCache::IsEnabled() && key.Set(x1, y1, z1, x2, y2, z2, phasemask, 0);
+    MapQueryGeneration generation = _queryCache.GetGeneration();
+
+    MapQueryResult<bool> cached;
+    MapQueryLookup lookup = cache ? _queryCache.LineOfSight.Find(key, generation.Models, cached) : MAP_QUERY_MISS;
+    if (lookup == MAP_QUERY_HIT)
+        return cached.Result;
+
+    bool terrain = lookup == MAP_QUERY_TERRAIN_HIT ? cached.Terrain : VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2);
+    bool result = terrain && _dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask);
+
+    if (cache)
+        _queryCache.LineOfSight.Store(key, generation, terrain, result);
+    return result;
+}
+
+void Map::isInLineOfSight(LineOfSightCheck* checks, uint32 count) const
+{
+    // only the checks missing from the cache are traced
+    bool cache = MapQueryCache::IsEnabled();
+    MapQueryGeneration generation = _queryCache.GetGeneration();
+    std::vector<uint32> traced;
+    std::vector<MapQueryKey> keys;
+    std::unique_ptr<bool[]> terrain(new bool[count]);
+    traced.reserve(count);
+    keys.reserve(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        LineOfSightCheck& check = checks[i];
+        MapQueryKey key;
+        if (cache && key.Set(check.x1, check.y1, check.z1, check.x2, check.y2, check.z2, check.phasemask, 0))
+        {
+            MapQueryResult<bool> cached;
+            switch (_queryCache.LineOfSight.Find(key, generation.Models, cached))
+            {
+                case MAP_QUERY_HIT:
+                    check.result = cached.Result;
+                    continue;
+                case MAP_QUERY_TERRAIN_HIT:
+                    terrain[i] = cached.Terrain;
+                    check.result = cached.Terrain && _dynamicTree.isInLineOfSight(check.x1, check.y1, check.z1, check.x2, check.y2, check.z2, check.phasemask);
+                    _queryCache.LineOfSight.Store(key, generation, cached.Terrain, check.result);
+                    continue;
+                default:
+                    break;
+            }
+        }
+        else
+            key.Param = ~0u;                                // marks a check that is not cached
+
+        traced.push_back(i);
+        keys.push_back(key);
+    }
+
+    if (traced.empty())
+        return;
+
+    std::vector<G3D::Vector3> from(traced.size());
+    std::vector<G3D::Vector3> to(traced.size());
+    for (size_t i = 0; i < traced.size(); ++i)
+    {
+        LineOfSightCheck const& check = checks[traced[i]];
+        from[i] = G3D::Vector3(check.x1, check.y1, check.z1);
+        to[i] = G3D::Vector3(check.x2, check.y2, check.z2);
+    }
+
+    // static geometry of all checks is traced together, gameobjects only for the ones not blocked by it
+    std::unique_ptr<bool[]> results(new bool[traced.size()]);
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), from.data(), to.data(), results.get(), traced.size());
+
+    for (size_t i = 0; i < traced.size(); ++i)
+    {
+        LineOfSightCheck& check = checks[traced[i]];
+        check.result = results[i] && _dynamicTree.isInLineOfSight(check.x1, check.y1, check.z1, check.x2, check.y2, check.z2, check.phasemask);
+
+        if (keys[i].Param != ~0u)
+            _queryCache.LineOfSight.Store(keys[i], generation, results[i], check.result);
+    }
 }
 
 bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
 {
-    G3D::Vector3 startPos(x1, y1, z1);
-    G3D::Vector3 dstPos(x2, y2, z2);
+    MapQueryKey key;
+    bool cache = MapQueryCache::IsEnabled() && key.Set(x1, y1, z1, x2, y2, z2, phasemask, MapQueryKey::FloatBits(modifyDist));
+    MapQueryGeneration generation = _queryCache.GetGeneration();
 
-    G3D::Vector3 resultPos;
-    bool result = _dynamicTree.getObjectHitPos(phasemask, startPos, dstPos, resultPos, modifyDist);
+    // only gameobject models are looked at, a result of older models is of no use
+    MapQueryResult<MapQueryHitPos> cached;
+    MapQueryHitPos& hitPos = cached.Result;
+    if (!cache || _queryCache.ObjectHitPos.Find(key, generation.Models, cached) != MAP_QUERY_HIT)
+    {
+        G3D::Vector3 startPos(x1, y1, z1);
+        G3D::Vector3 dstPos(x2, y2, z2);
 
-    rx = resultPos.x;
-    ry = resultPos.y;
-    rz = resultPos.z;
-    return result;
+        G3D::Vector3 resultPos;
+        hitPos.Hit = _dynamicTree.getObjectHitPos(phasemask, startPos, dstPos, resultPos, modifyDist);
+        hitPos.X = resultPos.x;
+        hitPos.Y = resultPos.y;
+        hitPos.Z = resultPos.z;
+
+        if (cache)
+            _queryCache.ObjectHitPos.Store(key, generation, hitPos, hitPos);
+    }
+
+    rx = hitPos.X;
+    ry = hitPos.Y;
+    rz = hitPos.Z;
+    return hitPos.Hit;
 }
 
 float Map::GetHeight(uint32 phasemask, float x, float y, float z, bool vmap/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
 {
-    return std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask));
+    // the lowest bit of the search distance holds the vmap flag
+    MapQueryKey key;
+    bool cache = MapQueryCache::IsEnabled() && key.Set(x, y, z, 0.0f, 0.0f, 0.0f, phasemask, (MapQueryKey::FloatBits(maxSearchDist) & ~1u) | uint32(vmap));
+    MapQueryGeneration generation = _queryCache.GetGeneration();
+
+    MapQueryResult<float> cached;
+    MapQueryLookup lookup = cache ? _queryCache.Height.Find(key, generation.Models, cached) : MAP_QUERY_MISS;
+    if (lookup == MAP_QUERY_HIT)
+        return cached.Result;
+
+    float terrain = lookup == MAP_QUERY_TERRAIN_HIT ? cached.Terrain : GetHeight(x, y, z, vmap, maxSearchDist);
+    float height = std::max<float>(terrain, _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask));
+
+    if (cache)
+        _queryCache.Height.Store(key, generation, terrain, height);
+    return height;
 }
 
 bool Map::IsInWater(float x, float y, float pZ, LiquidData* data) const
@@ -2468,6 +2869,7 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    WorldPacketBroadcast broadcast(data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
         itr->GetSource()->GetSession()->SendPacket(data);
 }
@@ -14,6 +14,7 @@
 #include "GameObjectModel.h"
 #include "GridDefines.h"
 #include "GridRefManager.h"
+#include "MapQueryCache.h"
 #include "MapRefManager.h"
 #include "SharedDefines.h"
 #include "Timer.h"
@@ -22,6 +23,8 @@
 #include <list>
 #include <mutex>
 
+class ACE_Mem_Map;
+struct PrefetchedGrid;
 class Unit;
 class WorldPacket;
 class InstanceScript;
@@ -138,6 +141,15 @@ struct LiquidData
     float  depth_level;
 };
 
+// one pair of points for the batched Map::isInLineOfSight()
+struct LineOfSightCheck
+{
+    float  x1, y1, z1;
+    float  x2, y2, z2;
+    uint32 phasemask;
+    bool   result;
+};
+
 #define MAX_HEIGHT            100000.0f                     // can be use for find ground height at surface
 #define INVALID_HEIGHT       -100000.0f                     // for check, must be equal to VMAP_INVALID_HEIGHT, real value for unknown height is VMAP_INVALID_HEIGHT_VALUE
 #define MAX_FALL_DISTANCE     250000.0f                     // "unlimited fall" to find VMap ground if it is available, just larger than MAX_HEIGHT - INVALID_HEIGHT
@@ -176,11 +188,18 @@ class GridMap
     uint8 m_liquidWidth;
     uint8 m_liquidHeight;
 
+    // Read only view of the map file, set if the arrays above point into it instead of owning copies
+    ACE_Mem_Map* m_fileMap;
 
     bool loadAreaData(FILE* in, uint32 offset, uint32 size);
     bool loadHeightData(FILE* in, uint32 offset, uint32 size);
     bool loadLiquidData(FILE* in, uint32 offset, uint32 size);
 
+    bool mapData(char const* filename);
+    bool mapAreaData(uint8 const* data, size_t size, uint32 offset);
+    bool mapHeightData(uint8 const* data, size_t size, uint32 offset);
+    bool mapLiquidData(uint8 const* data, size_t size, uint32 offset);
+
     // Get height functions and pointers
     typedef float (GridMap::* GetHeightPtr) (float x, float y) const;
     GetHeightPtr m_gridGetHeight;
@@ -191,7 +210,7 @@ class GridMap
 
 public:
     GridMap() : m_flags(0), m_V9(NULL), m_V8(NULL), m_gridHeight(INVALID_HEIGHT), m_gridIntHeightMultiplier(0.0f), m_areaMap(NULL), m_liquidLevel(INVALID_HEIGHT),
-        m_liquidEntry(NULL), m_liquidFlags(NULL), m_liquidMap(NULL), m_gridArea(0), m_liquidType(0), m_liquidOffX(0), m_liquidOffY(0), m_liquidWidth(0), m_liquidHeight(0)
+        m_liquidEntry(NULL), m_liquidFlags(NULL), m_liquidMap(NULL), m_gridArea(0), m_liquidType(0), m_liquidOffX(0), m_liquidOffY(0), m_liquidWidth(0), m_liquidHeight(0), m_fileMap(NULL)
     {
         m_gridGetHeight = &GridMap::getHeightFromFlat;
     }
@@ -264,6 +283,23 @@ public:
     void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Skyfire::ObjectUpdater, GridTypeMapContainer>& gridVisitor, TypeContainerVisitor<Skyfire::ObjectUpdater, WorldTypeMapContainer>& worldVisitor);
     virtual void Update(const uint32);
 
+    // objects with value changes, their update blocks are built and sent at the end of Update
+    void AddUpdateObject(Object* obj)
+    {
+        std::lock_guard<std::mutex> guard(_updateObjectsLock);
+        _updateObjects.insert(obj);
+    }
+
+    void RemoveUpdateObject(Object* obj)
+    {
+        std::lock_guard<std::mutex> guard(_updateObjectsLock);
+        _updateObjects.erase(obj);
+    }
+
+    // time spent in the last Update, used by MapUpdater to schedule expensive maps first
+    uint32 GetLastUpdateCost() const { return _lastUpdateCost; }
+    void SetLastUpdateCost(uint32 cost) { _lastUpdateCost = cost; }
+
     float GetVisibilityRange() const { return m_VisibleDistance; }
     //function for setting up visibility distance for maps on per-type/per-Id basis
     virtual void InitVisibilityDistance();
@@ -442,9 +478,14 @@ public:
     float GetWaterOrGroundLevel(float x, float y, float z, float* ground = NULL, bool swim = false) const;
     float GetHeight(uint32 phasemask, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
     bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const;
+    void isInLineOfSight(LineOfSightCheck* checks, uint32 count) const;
     void Balance() { _dynamicTree.balance(); }
-    void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-    void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
+    void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); _queryCache.InvalidateModels(); }
+    void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); _queryCache.InvalidateModels(); }
+    void RelocateGameObjectModel(const GameObjectModel& model) { _dynamicTree.relocate(model); _queryCache.InvalidateModels(); }
+    void GetGameObjectModels(std::vector<const GameObjectModel*>& models) const { _dynamicTree.getModels(models); }
+    // collision of a model in the tree changed, e.g. a door opened
+    void InvalidateQueryCache() { _queryCache.InvalidateModels(); }
     bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model); }
     bool getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist);
 
@@ -486,8 +527,10 @@ public:
 private:
     void LoadMapAndVMap(int gx, int gy);
     void LoadVMap(int gx, int gy);
-    void LoadMap(int gx, int gy, bool reload = false);
-    void LoadMMap(int gx, int gy);
+    void LoadMap(int gx, int gy, bool reload = false, PrefetchedGrid* prefetch = NULL);
+    void LoadMMap(int gx, int gy, PrefetchedGrid* prefetch = NULL);
+    void PrefetchGrids(uint32 diff);
+    void PrefetchGrid(float x, float y);
     GridMap* GetGrid(float x, float y);
 
     void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
@@ -530,6 +573,10 @@ private:
     void ScriptsProcess();
 
     void UpdateActiveCells(const float& x, const float& y, const uint32 t_diff);
+    void SendObjectUpdates();
+
+    std::mutex _updateObjectsLock;
+    std::set<Object*> _updateObjects;
 
 protected:
     void SetUnloadReferenceLock(const GridCoord& p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadReferenceLock(on); }
@@ -543,6 +590,7 @@ protected:
     uint32 m_unloadTimer;
     float m_VisibleDistance;
     DynamicMapTree _dynamicTree;
+    mutable MapQueryCache _queryCache;                      // results of the collision queries above
 
     MapRefManager m_mapRefManager;
     MapRefManager::iterator m_mapRefIter;
@@ -583,6 +631,8 @@ private:
     void ProcessRelocationNotifies(const uint32 diff);
 
     bool i_scriptLock;
+    uint32 _lastUpdateCost;                                 // microseconds
+    IntervalTimer _gridPrefetchTimer;
     std::set<WorldObject*> i_objectsToRemove;
     std::map<WorldObject*, bool> i_objectsToSwitch;
     std::set<WorldObject*> i_worldObjects;
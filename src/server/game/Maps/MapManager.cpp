@@ -49,6 +49,9 @@ void MapManager::Initialize()
     // Start mtmaps if needed.
     if (num_threads > 0 && m_updater.activate(num_threads) == -1)
         abort();
+
+    m_gridPrefetcher.Activate(sWorld->getIntConfig(WorldIntConfigs::CONFIG_GRID_PREFETCH_THREADS));
+    m_pathfindingService.Activate(sWorld->getIntConfig(WorldIntConfigs::CONFIG_PATHFINDING_THREADS));
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -304,6 +307,8 @@ void MapManager::Update(uint32 diff)
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
 
+    m_gridPrefetcher.Update(uint32(i_timer.GetCurrent()));
+
     sObjectAccessor->Update(uint32(i_timer.GetCurrent()));
 
     i_timer.SetCurrent(0);
@@ -335,6 +340,10 @@ bool MapManager::IsValidMAP(uint32 mapid, bool startUp)
 
 void MapManager::UnloadAll()
 {
+    // prefetched grids give back their vmap models, so they go before the maps
+    m_gridPrefetcher.Deactivate();
+    m_pathfindingService.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end();)
     {
         iter->second->UnloadAll();
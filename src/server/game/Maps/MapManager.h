@@ -6,10 +6,12 @@
 #ifndef SKYFIRE_MAPMANAGER_H
 #define SKYFIRE_MAPMANAGER_H
 
+#include "GridPrefetcher.h"
 #include "GridStates.h"
 #include "Map.h"
 #include "MapUpdater.h"
 #include "Object.h"
+#include "PathfindingService.h"
 
 #include <ace/Singleton.h>
 #include <mutex>
@@ -111,6 +113,8 @@ public:
     void SetNextInstanceId(uint32 nextInstanceId) { _nextInstanceId = nextInstanceId; };
 
     MapUpdater* GetMapUpdater() { return &m_updater; }
+    GridPrefetcher* GetGridPrefetcher() { return &m_gridPrefetcher; }
+    PathfindingService* GetPathfindingService() { return &m_pathfindingService; }
 
 private:
     typedef UNORDERED_MAP<uint32, Map*> MapMapType;
@@ -141,6 +145,8 @@ private:
     InstanceIds _instanceIds;
     uint32 _nextInstanceId;
     MapUpdater m_updater;
+    GridPrefetcher m_gridPrefetcher;
+    PathfindingService m_pathfindingService;
 };
 #define sMapMgr ACE_Singleton<MapManager, ACE_Thread_Mutex>::instance()
 #endif
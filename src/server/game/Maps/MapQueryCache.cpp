@@ -0,0 +1,121 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include "MapQueryCache.h"
+#include "World.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // every thread counts its own lookups, only reading the stats takes the lock
+    struct LookupCounters
+    {
+        LookupCounters();
+        ~LookupCounters();
+
+        std::atomic<uint64> Lookups[MAX_MAP_QUERY_TYPES][MAP_QUERY_HIT + 1];   // written by the owning thread only
+    };
+
+    std::mutex sCountersLock;
+    std::vector<LookupCounters const*> sCounters;
+    uint64 sExitedLookups[MAX_MAP_QUERY_TYPES][MAP_QUERY_HIT + 1];          // threads that ended already
+
+    thread_local LookupCounters tCounters;
+
+    LookupCounters::LookupCounters()
+    {
+        for (uint32 i = 0; i < MAX_MAP_QUERY_TYPES; ++i)
+            for (uint32 j = 0; j <= MAP_QUERY_HIT; ++j)
+                Lookups[i][j].store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> guard(sCountersLock);
+        sCounters.push_back(this);
+    }
+
+    LookupCounters::~LookupCounters()
+    {
+        std::lock_guard<std::mutex> guard(sCountersLock);
+        for (uint32 i = 0; i < MAX_MAP_QUERY_TYPES; ++i)
+            for (uint32 j = 0; j <= MAP_QUERY_HIT; ++j)
+                sExitedLookups[i][j] += Lookups[i][j].load(std::memory_order_relaxed);
+
+        sCounters.erase(std::find(sCounters.begin(), sCounters.end(), this));
+    }
+
+    bool PackPosition(float x, float y, float z, uint64& packed)
+    {
+        int32 const offset = int32(1) << (MapQueryKey::COORDINATE_BITS - 1);
+        float const limit = float(offset) / MapQueryKey::QUANTIZATION_STEPS;
+
+        // written to fail for NaN as well
+        if (!(std::fabs(x) < limit && std::fabs(y) < limit && std::fabs(z) < limit))
+            return false;
+
+        uint64 qx = uint64(int32(std::floor(x * MapQueryKey::QUANTIZATION_STEPS)) + offset);
+        uint64 qy = uint64(int32(std::floor(y * MapQueryKey::QUANTIZATION_STEPS)) + offset);
+        uint64 qz = uint64(int32(std::floor(z * MapQueryKey::QUANTIZATION_STEPS)) + offset);
+        packed = qx << (2 * MapQueryKey::COORDINATE_BITS) | qy << MapQueryKey::COORDINATE_BITS | qz;
+        return true;
+    }
+}
+
+bool MapQueryKey::Set(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask, uint32 param)
+{
+    PhaseMask = phaseMask;
+    Param = param;
+    return PackPosition(x1, y1, z1, From) && PackPosition(x2, y2, z2, To);
+}
+
+size_t MapQueryKeyHash::operator()(MapQueryKey const& key) const
+{
+    uint64 hash = key.From * UI64LIT(0x9E3779B97F4A7C15);
+    hash ^= key.To + UI64LIT(0x9E3779B97F4A7C15) + (hash << 6) + (hash >> 2);
+    hash ^= (uint64(key.PhaseMask) << 32 | key.Param) + UI64LIT(0x9E3779B97F4A7C15) + (hash << 6) + (hash >> 2);
+    return size_t(hash);
+}
+
+MapQueryCache::MapQueryCache() :
+    LineOfSight(MAP_QUERY_LINE_OF_SIGHT, _terrainGeneration),
+    Height(MAP_QUERY_HEIGHT, _terrainGeneration),
+    ObjectHitPos(MAP_QUERY_OBJECT_HIT_POS, _terrainGeneration),
+    _terrainGeneration(0), _modelGeneration(0) { }
+
+bool MapQueryCache::IsEnabled()
+{
+    return sWorld->GetBoolConfig(WorldBoolConfigs::CONFIG_MAP_QUERY_CACHE);
+}
+
+MapQueryCacheStats MapQueryCache::GetStats()
+{
+    uint64 lookups[MAX_MAP_QUERY_TYPES][MAP_QUERY_HIT + 1];
+
+    {
+        std::lock_guard<std::mutex> guard(sCountersLock);
+        memcpy(lookups, sExitedLookups, sizeof(lookups));
+        for (std::vector<LookupCounters const*>::const_iterator itr = sCounters.begin(); itr != sCounters.end(); ++itr)
+            for (uint32 i = 0; i < MAX_MAP_QUERY_TYPES; ++i)
+                for (uint32 j = 0; j <= MAP_QUERY_HIT; ++j)
+                    lookups[i][j] += (*itr)->Lookups[i][j].load(std::memory_order_relaxed);
+    }
+
+    MapQueryCacheStats stats;
+    for (uint32 i = 0; i < MAX_MAP_QUERY_TYPES; ++i)
+    {
+        stats.Hits[i] = lookups[i][MAP_QUERY_HIT];
+        stats.TerrainHits[i] = lookups[i][MAP_QUERY_TERRAIN_HIT];
+        stats.Misses[i] = lookups[i][MAP_QUERY_MISS];
+    }
+    return stats;
+}
+
+void MapQueryCache::CountLookup(MapQueryType type, MapQueryLookup lookup)
+{
+    // no other thread writes it, a plain increment is enough
+    std::atomic<uint64>& counter = tCounters.Lookups[type][lookup];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
@@ -0,0 +1,218 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef SF_MAP_QUERY_CACHE_H
+#define SF_MAP_QUERY_CACHE_H
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "Define.h"
+
+enum MapQueryType
+{
+    MAP_QUERY_LINE_OF_SIGHT,
+    MAP_QUERY_HEIGHT,
+    MAP_QUERY_OBJECT_HIT_POS,
+    MAX_MAP_QUERY_TYPES
+};
+
+enum MapQueryLookup
+{
+    MAP_QUERY_MISS,
+    MAP_QUERY_TERRAIN_HIT,                                  // only the gameobject models have to be checked again
+    MAP_QUERY_HIT
+};
+
+struct MapQueryCacheStats
+{
+    uint64 Hits[MAX_MAP_QUERY_TYPES];                       // queries answered from a cache, all maps together
+    uint64 TerrainHits[MAX_MAP_QUERY_TYPES];                // queries that only traced the gameobject models
+    uint64 Misses[MAX_MAP_QUERY_TYPES];                     // queries that had to trace the whole geometry
+};
+
+/// Where the geometry of a map stands, each part counts its changes.
+struct MapQueryGeneration
+{
+    uint32 Terrain;                                         // grids with their terrain and vmap tiles
+    uint32 Models;                                          // gameobject models of the dynamic tree
+};
+
+/// A cached result, together with the part of it that does not depend on gameobjects.
+template<class T>
+struct MapQueryResult
+{
+    T Terrain;
+    T Result;
+    uint32 ModelGeneration;                                 // models the result was computed for
+};
+
+/// Input of a cached query, positions are quantized to QUANTIZATION_STEPS per yard.
+struct MapQueryKey
+{
+    static constexpr float QUANTIZATION_STEPS = 8.0f;
+    static constexpr uint32 COORDINATE_BITS = 21;
+
+    // false if a position is too far out to be packed, such queries are not cached
+    bool Set(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask, uint32 param);
+
+    static uint32 FloatBits(float value)
+    {
+        uint32 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    bool operator==(MapQueryKey const& right) const
+    {
+        return From == right.From && To == right.To && PhaseMask == right.PhaseMask && Param == right.Param;
+    }
+
+    uint64 From;
+    uint64 To;
+    uint32 PhaseMask;
+    uint32 Param;                                           // raw bits of the extra arguments of the query
+};
+
+struct MapQueryKeyHash
+{
+    size_t operator()(MapQueryKey const& key) const;
+};
+
+/// Results of one kind of query, dropped as a whole when the terrain of the map changes.
+/// Keys are spread over shards with their own lock, so concurrent lookups rarely wait on each other.
+template<class T>
+class MapQueryCacheTable
+{
+public:
+    static constexpr uint32 SHARDS = 16;
+    static constexpr size_t MAX_SHARD_ENTRIES = 512;        // cleared when full, the hot entries come back quickly
+
+    MapQueryCacheTable(MapQueryType type, std::atomic<uint32> const& terrainGeneration) : _type(type), _currentGeneration(terrainGeneration) { }
+
+    // result is only complete for MAP_QUERY_HIT, its terrain part is valid for MAP_QUERY_TERRAIN_HIT too
+    MapQueryLookup Find(MapQueryKey const& key, uint32 modelGeneration, MapQueryResult<T>& result);
+    // generation is the one read before the result was computed, results of outdated terrain are not kept
+    void Store(MapQueryKey const& key, MapQueryGeneration const& generation, T const& terrain, T const& result);
+
+private:
+    struct alignas(64) Shard
+    {
+        Shard() : Generation(0) { }
+
+        std::mutex Lock;
+        std::unordered_map<MapQueryKey, MapQueryResult<T>, MapQueryKeyHash> Entries;
+        uint32 Generation;                                  // terrain the entries were computed for
+    };
+
+    // higher bits than the ones picking the bucket inside the shard
+    Shard& GetShard(MapQueryKey const& key) { return _shards[(MapQueryKeyHash()(key) >> 24) % SHARDS]; }
+
+    MapQueryType _type;
+    std::atomic<uint32> const& _currentGeneration;
+    Shard _shards[SHARDS];
+};
+
+struct MapQueryHitPos
+{
+    bool Hit;
+    float X;
+    float Y;
+    float Z;
+};
+
+/*
+ * Cache of the line of sight, height and object hit position queries of one map.
+ *
+ * Casters re-casting from the same spot, creatures checking aggro every tick and
+ * chasing movement generators ask the same questions over and over, while the
+ * geometry behind them rarely changes. Loading or unloading a grid drops all
+ * results of the map. Gameobject models - doors toggling, transports moving -
+ * change much more often, so results remember the terrain part on its own and
+ * only the cheap dynamic tree is checked again after such a change. Queries may
+ * come from more than one thread, so the tables lock per shard and lookups
+ * are counted per thread.
+ */
+class MapQueryCache
+{
+public:
+    MapQueryCache();
+
+    static bool IsEnabled();
+    static MapQueryCacheStats GetStats();
+    static void CountLookup(MapQueryType type, MapQueryLookup lookup);
+
+    MapQueryGeneration GetGeneration() const
+    {
+        MapQueryGeneration generation;
+        generation.Terrain = _terrainGeneration.load(std::memory_order_acquire);
+        generation.Models = _modelGeneration.load(std::memory_order_acquire);
+        return generation;
+    }
+
+    void InvalidateTerrain() { _terrainGeneration.fetch_add(1, std::memory_order_acq_rel); }
+    void InvalidateModels() { _modelGeneration.fetch_add(1, std::memory_order_acq_rel); }
+
+    MapQueryCacheTable<bool> LineOfSight;
+    MapQueryCacheTable<float> Height;
+    MapQueryCacheTable<MapQueryHitPos> ObjectHitPos;        // gameobject models only, there is no terrain part
+
+private:
+    std::atomic<uint32> _terrainGeneration;
+    std::atomic<uint32> _modelGeneration;
+
+    MapQueryCache(MapQueryCache const&) = delete;
+    MapQueryCache& operator=(MapQueryCache const&) = delete;
+};
+
+template<class T>
+MapQueryLookup MapQueryCacheTable<T>::Find(MapQueryKey const& key, uint32 modelGeneration, MapQueryResult<T>& result)
+{
+    uint32 generation = _currentGeneration.load(std::memory_order_acquire);
+    MapQueryLookup lookup = MAP_QUERY_MISS;
+
+    Shard& shard = GetShard(key);
+    {
+        std::lock_guard<std::mutex> guard(shard.Lock);
+        if (shard.Generation != generation)
+        {
+            shard.Entries.clear();
+            shard.Generation = generation;
+        }
+        else
+        {
+            typename std::unordered_map<MapQueryKey, MapQueryResult<T>, MapQueryKeyHash>::const_iterator itr = shard.Entries.find(key);
+            if (itr != shard.Entries.end())
+            {
+                result = itr->second;
+                lookup = result.ModelGeneration == modelGeneration ? MAP_QUERY_HIT : MAP_QUERY_TERRAIN_HIT;
+            }
+        }
+    }
+
+    MapQueryCache::CountLookup(_type, lookup);
+    return lookup;
+}
+
+template<class T>
+void MapQueryCacheTable<T>::Store(MapQueryKey const& key, MapQueryGeneration const& generation, T const& terrain, T const& result)
+{
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.Lock);
+    if (generation.Terrain != shard.Generation || generation.Terrain != _currentGeneration.load(std::memory_order_acquire))
+        return;
+
+    if (shard.Entries.size() >= MAX_SHARD_ENTRIES)
+        shard.Entries.clear();
+
+    MapQueryResult<T>& entry = shard.Entries[key];
+    entry.Terrain = terrain;
+    entry.Result = result;
+    entry.ModelGeneration = generation.Models;
+}
+
+#endif
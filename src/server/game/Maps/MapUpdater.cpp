@@ -4,49 +4,22 @@
 */
 
 #include "DatabaseEnv.h"
-#include "DelayExecutor.h"
+#include "Log.h"
 #include "Map.h"
 #include "MapUpdater.h"
+#include "Timer.h"
 
-#include <ace/Method_Request.h>
+#include <algorithm>
+#include <chrono>
 
-class WDBThreadStartReq1 : public ACE_Method_Request
+namespace
 {
-public:
-    WDBThreadStartReq1() { }
-
-    virtual int call() { return 0; }
-};
-
-class WDBThreadEndReq1 : public ACE_Method_Request
-{
-public:
-    WDBThreadEndReq1() { }
-
-    virtual int call() { return 0; }
-};
-
-class MapUpdateRequest : public ACE_Method_Request
-{
-private:
-    Map& m_map;
-    MapUpdater& m_updater;
-    ACE_UINT32 m_diff;
-
-public:
-    MapUpdateRequest(Map& m, MapUpdater& u, ACE_UINT32 d)
-        : m_map(m), m_updater(u), m_diff(d) { }
-
-    virtual int call()
-    {
-        m_map.Update(m_diff);
-        m_updater.update_finished();
-        return 0;
-    }
-};
+    // index of the worker queue owned by the calling thread, -1 outside the pool
+    thread_local int32 sWorkerIndex = -1;
+}
 
 MapUpdater::MapUpdater() :
-    m_executor(), pending_requests(0) { }
+    _cancelationToken(false), _queuedRequests(0), pending_requests(0), _lastTickDuration(0) { }
 
 MapUpdater::~MapUpdater()
 {
@@ -55,17 +28,47 @@ MapUpdater::~MapUpdater()
 
 int MapUpdater::activate(size_t num_threads)
 {
-    return m_executor.start((int)num_threads, new WDBThreadStartReq1, new WDBThreadEndReq1);
+    if (activated() || num_threads < 1)
+        return -1;
+
+    _cancelationToken = false;
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
+
+    return 0;
 }
 
 int MapUpdater::deactivate()
 {
+    if (!activated())
+        return -1;
+
     wait();
-    return m_executor.deactivate();
+
+    {
+        std::lock_guard<std::mutex> guard(_idleLock);
+        _cancelationToken = true;
+    }
+    _workAvailable.notify_all();
+
+    for (std::thread& thread : _workerThreads)
+        thread.join();
+
+    _workerThreads.clear();
+    _queues.clear();
+    return 0;
 }
 
 int MapUpdater::wait()
 {
+    uint32 tickStart = getMSTime();
+
+    DispatchBatch();
+
     std::unique_lock<std::mutex> ulock(Lock);
 
     while (pending_requests > 0)
@@ -73,42 +76,165 @@ int MapUpdater::wait()
 
     ulock.unlock();
 
+    _lastTickDuration = GetMSTimeDiffToNow(tickStart);
+
+    std::lock_guard<std::mutex> guard(_timingLock);
+    if (_currentTimings.empty())
+        return 0;
+
+    std::sort(_currentTimings.begin(), _currentTimings.end(), [](MapUpdateTiming const& a, MapUpdateTiming const& b)
+    {
+        return a.Cost > b.Cost;
+    });
+
+    _lastTimings.swap(_currentTimings);
+    _currentTimings.clear();
+
+    MapUpdateTiming const& slowest = _lastTimings.front();
+    SF_LOG_DEBUG("maps.updater", "MapUpdater: %u maps updated in %u ms, slowest map %u (instance %u) took %u us",
+        uint32(_lastTimings.size()), _lastTickDuration.load(), slowest.MapId, slowest.InstanceId, slowest.Cost);
+
     return 0;
 }
 
-int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
+int MapUpdater::schedule_update(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> guard(Lock);
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        ++pending_requests;
+    }
+
+    MapUpdateRequest request = { &map, diff };
+
+    // scheduled from inside a map update (instances of a MapInstanced), keep it local
+    // and let idle workers steal it
+    if (sWorkerIndex >= 0)
+        Enqueue(size_t(sWorkerIndex), request);
+    else
+        _batch.push_back(request);
+
+    return 0;
+}
+
+bool MapUpdater::activated()
+{
+    return !_workerThreads.empty();
+}
 
-    ++pending_requests;
+MapUpdateTimings MapUpdater::GetLastTickTimings() const
+{
+    std::lock_guard<std::mutex> guard(_timingLock);
+    return _lastTimings;
+}
+
+void MapUpdater::DispatchBatch()
+{
+    if (_batch.empty())
+        return;
 
-    if (m_executor.execute(new MapUpdateRequest(map, *this, diff)) == -1)
+    // longest processing time first: the most expensive map of the previous tick starts first,
+    // each map goes to the worker with the least estimated work queued so far
+    std::stable_sort(_batch.begin(), _batch.end(), [](MapUpdateRequest const& a, MapUpdateRequest const& b)
     {
-        ACE_DEBUG((LM_ERROR, ACE_TEXT("(%t) \n"), ACE_TEXT("Failed to schedule Map Update")));
+        return a.map->GetLastUpdateCost() > b.map->GetLastUpdateCost();
+    });
 
-        --pending_requests;
-        return -1;
+    std::vector<uint64> load(_queues.size(), 0);
+    for (MapUpdateRequest const& request : _batch)
+    {
+        size_t target = std::min_element(load.begin(), load.end()) - load.begin();
+        // never seen maps count as cheap but still spread over the workers
+        load[target] += std::max<uint32>(request.map->GetLastUpdateCost(), 1);
+        Enqueue(target, request);
     }
 
-    return 0;
+    _batch.clear();
 }
 
-bool MapUpdater::activated()
+void MapUpdater::Enqueue(size_t index, MapUpdateRequest const& request)
 {
-    return m_executor.activated();
+    // counted before it becomes visible so a waking worker never misses it
+    ++_queuedRequests;
+
+    {
+        std::lock_guard<std::mutex> guard(_queues[index]->Lock);
+        _queues[index]->Requests.push_back(request);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(_idleLock);
+    }
+    _workAvailable.notify_one();
 }
 
-void MapUpdater::update_finished()
+bool MapUpdater::PopRequest(size_t index, MapUpdateRequest& request)
 {
+    // own queue first, then steal from the others starting with our neighbour;
+    // queues are ordered most expensive first so thieves also take from the front
+    for (size_t i = 0; i < _queues.size(); ++i)
+    {
+        WorkerQueue& queue = *_queues[(index + i) % _queues.size()];
+
+        std::lock_guard<std::mutex> guard(queue.Lock);
+        if (queue.Requests.empty())
+            continue;
+
+        request = queue.Requests.front();
+        queue.Requests.pop_front();
+        --_queuedRequests;
+        return true;
+    }
+
+    return false;
+}
+
+void MapUpdater::WorkerThread(size_t index)
+{
+    sWorkerIndex = int32(index);
+
+    for (;;)
+    {
+        MapUpdateRequest request;
+        if (PopRequest(index, request))
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            request.map->Update(request.diff);
+            uint32 cost = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+            update_finished(*request.map, cost);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> ulock(_idleLock);
+        _workAvailable.wait(ulock, [this] { return _cancelationToken || _queuedRequests > 0; });
+
+        if (_cancelationToken && _queuedRequests == 0)
+            break;
+    }
+
+    sWorkerIndex = -1;
+}
+
+void MapUpdater::update_finished(Map& map, uint32 cost)
+{
+    map.SetLastUpdateCost(cost);
+
+    {
+        std::lock_guard<std::mutex> guard(_timingLock);
+        MapUpdateTiming timing = { map.GetId(), map.GetInstanceId(), cost };
+        _currentTimings.push_back(timing);
+    }
+
     std::lock_guard<std::mutex> guard(Lock);
 
     if (pending_requests == 0)
     {
-        ACE_ERROR((LM_ERROR, ACE_TEXT("(%t)\n"), ACE_TEXT("MapUpdater::update_finished BUG, report to devs")));
+        SF_LOG_ERROR("maps", "MapUpdater::update_finished BUG, report to devs");
         return;
     }
 
     --pending_requests;
 
-    condition.notify_all();
+    if (pending_requests == 0)
+        condition.notify_all();
 }
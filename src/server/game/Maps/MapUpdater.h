@@ -6,33 +6,89 @@
 #ifndef SF_MAP_UPDATER_H_INCLUDED
 #define SF_MAP_UPDATER_H_INCLUDED
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
-#include "DelayExecutor.h"
+#include "Define.h"
 
 class Map;
 
+struct MapUpdateTiming
+{
+    uint32 MapId;
+    uint32 InstanceId;
+    uint32 Cost;                                            // microseconds spent in Map::Update
+};
+
+typedef std::vector<MapUpdateTiming> MapUpdateTimings;
+
+/*
+ * Runs map updates on a pool of worker threads.
+ *
+ * Maps scheduled from the world thread are buffered until wait() and then
+ * handed out longest-first (by the cost of their previous update) to the
+ * least loaded worker queue. Maps scheduled from inside a worker (instances
+ * of a MapInstanced) go straight to that worker's queue. An idle worker
+ * steals queued requests from the other workers so that one expensive
+ * continent does not leave the rest of the pool waiting.
+ */
 class MapUpdater
 {
 public:
     MapUpdater();
     virtual ~MapUpdater();
-    friend class MapUpdateRequest;
 
-    int schedule_update(Map& map, ACE_UINT32 diff);
+    int schedule_update(Map& map, uint32 diff);
     int wait();
     int activate(size_t num_threads);
     int deactivate();
     bool activated();
 
+    // per map costs of the last completed tick, most expensive first
+    MapUpdateTimings GetLastTickTimings() const;
+    uint32 GetLastTickDuration() const { return _lastTickDuration; }
+
 private:
-    DelayExecutor m_executor;
+    struct MapUpdateRequest
+    {
+        Map* map;
+        uint32 diff;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex Lock;
+        std::deque<MapUpdateRequest> Requests;
+    };
+
+    void WorkerThread(size_t index);
+    void Enqueue(size_t index, MapUpdateRequest const& request);
+    bool PopRequest(size_t index, MapUpdateRequest& request);
+    void DispatchBatch();
+    void update_finished(Map& map, uint32 cost);
+
+    std::vector<std::thread> _workerThreads;
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::vector<MapUpdateRequest> _batch;                  // world thread only
+    std::atomic<bool> _cancelationToken;
+
+    std::mutex _idleLock;
+    std::condition_variable _workAvailable;
+    std::atomic<size_t> _queuedRequests;
+
     std::mutex Lock;
     std::condition_variable condition;
     size_t pending_requests;
 
-    void update_finished();
+    mutable std::mutex _timingLock;
+    MapUpdateTimings _currentTimings;
+    MapUpdateTimings _lastTimings;
+    std::atomic<uint32> _lastTickDuration;
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
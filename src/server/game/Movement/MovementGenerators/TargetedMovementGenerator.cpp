@@ -79,8 +79,24 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T* owner, bool up
     bool forceDest = (owner->GetTypeId() == TypeID::TYPEID_UNIT && owner->ToCreature()->IsPet()
         && owner->HasUnitState(UNIT_STATE_FOLLOW));
 
-    bool result = i_path->CalculatePath(x, y, z, forceDest);
-    if (!result || (i_path->GetPathType() & PATHFIND_NOPATH))
+    if (!i_path->RequestPath(x, y, z, forceDest))
+    {
+        // Cant reach target
+        i_recalculateTravel = true;
+        return;
+    }
+
+    // launched by DoUpdate when the pathfinding threads are done with it
+    if (i_path->IsPathPending())
+        return;
+
+    _launchPath(owner);
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_launchPath(T* owner)
+{
+    if (i_path->GetPathType() & PATHFIND_NOPATH)
     {
         // Cant reach target
         i_recalculateTravel = true;
@@ -133,23 +149,29 @@ bool TargetedMovementGeneratorMedium<T, D>::DoUpdate(T* owner, uint32 time_diff)
         return true;
     }
 
-    bool targetMoved = false;
-    i_recheckDistance.Update(time_diff);
-    if (i_recheckDistance.Passed())
+    // the old spline goes on until the requested path is ready, asking again meanwhile would only replace it
+    if (i_path && i_path->CollectPath())
+        _launchPath(owner);
+    else if (!i_path || !i_path->IsPathPending())
     {
-        i_recheckDistance.Reset(100);
-        //More distance let have better performance, less distance let have more sensitive reaction at target move.
-        float allowed_dist = owner->GetCombatReach() + sWorld->getRate(Rates::RATE_TARGET_POS_RECALCULATION_RANGE);
-        G3D::Vector3 dest = owner->movespline->FinalDestination();
+        bool targetMoved = false;
+        i_recheckDistance.Update(time_diff);
+        if (i_recheckDistance.Passed())
+        {
+            i_recheckDistance.Reset(100);
+            //More distance let have better performance, less distance let have more sensitive reaction at target move.
+            float allowed_dist = owner->GetCombatReach() + sWorld->getRate(Rates::RATE_TARGET_POS_RECALCULATION_RANGE);
+            G3D::Vector3 dest = owner->movespline->FinalDestination();
 
-        if (owner->GetTypeId() == TypeID::TYPEID_UNIT && owner->ToCreature()->CanFly())
-            targetMoved = !i_target->IsWithinDist3d(dest.x, dest.y, dest.z, allowed_dist);
-        else
-            targetMoved = !i_target->IsWithinDist2d(dest.x, dest.y, allowed_dist);
-    }
+            if (owner->GetTypeId() == TypeID::TYPEID_UNIT && owner->ToCreature()->CanFly())
+                targetMoved = !i_target->IsWithinDist3d(dest.x, dest.y, dest.z, allowed_dist);
+            else
+                targetMoved = !i_target->IsWithinDist2d(dest.x, dest.y, allowed_dist);
+        }
 
-    if (i_recalculateTravel || targetMoved)
-        _setTargetLocation(owner, targetMoved);
+        if (i_recalculateTravel || targetMoved)
+            _setTargetLocation(owner, targetMoved);
+    }
 
     if (owner->movespline->Finalized())
     {
@@ -40,6 +40,7 @@ public:
     bool IsReachable() const { return (i_path) ? (i_path->GetPathType() & PATHFIND_NORMAL) : true; }
 protected:
     void _setTargetLocation(T* owner, bool updateDestination);
+    void _launchPath(T* owner);
 
     PathGenerator* i_path;
     TimeTrackerSmall i_recheckDistance;
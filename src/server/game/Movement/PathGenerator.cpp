@@ -6,9 +6,11 @@
 #include "Creature.h"
 #include "Log.h"
 #include "Map.h"
+#include "MapManager.h"
 #include "MMapFactory.h"
 #include "MMapManager.h"
 #include "PathGenerator.h"
+#include "PathfindingService.h"
 
 #include "DetourCommon.h"
 #include "DetourNavMeshQuery.h"
@@ -17,11 +19,12 @@
 PathGenerator::PathGenerator(const Unit* owner) :
     _polyLength(0), _type(PATHFIND_BLANK), _useStraightPath(false),
     _forceDestination(false), _pointPathLimit(MAX_POINT_PATH_LENGTH),
-    _endPosition(G3D::Vector3::zero()), _sourceUnit(owner), _navMesh(NULL),
-    _navMeshQuery(NULL)
+    _endPosition(G3D::Vector3::zero()), _sourceUnit(owner), _sourceGuidLow(owner->GetGUIDLow()),
+    _navMesh(NULL), _navMeshQuery(NULL), _usesNavMesh(false), _pointPath(false), _holeInMesh(false),
+    _detached(false), _shortcutAtStart(false), _shortcutAtEnd(false)
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
-    SF_LOG_DEBUG("maps", "++ PathGenerator::PathGenerator for %u \n", _sourceUnit->GetGUIDLow());
+    SF_LOG_DEBUG("maps", "++ PathGenerator::PathGenerator for %u \n", _sourceGuidLow);
 
     uint32 mapId = _sourceUnit->GetMapId();
     if (MMAP::MMapFactory::IsPathfindingEnabled(mapId))
@@ -36,10 +39,90 @@ PathGenerator::PathGenerator(const Unit* owner) :
 
 PathGenerator::~PathGenerator()
 {
-    SF_LOG_DEBUG("maps", "++ PathGenerator::~PathGenerator() for %u \n", _sourceUnit->GetGUIDLow());
+    SF_LOG_DEBUG("maps", "++ PathGenerator::~PathGenerator() for %u \n", _sourceGuidLow);
 }
 
 bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool forceDest)
+{
+    // a pending request is replaced by this path
+    _request.reset();
+
+    if (!InitPath(destX, destY, destZ, forceDest))
+        return false;
+
+    if (_usesNavMesh)
+        BuildPath(_navMeshQuery);
+
+    FinishPath();
+    return true;
+}
+
+bool PathGenerator::RequestPath(float destX, float destY, float destZ, bool forceDest)
+{
+    // terrain swaps add and remove tiles of the shared mesh, the pathfinding thread only knows the base mesh
+    PathfindingService* service = sMapMgr->GetPathfindingService();
+    if (!service->IsActive() || !_sourceUnit->GetTerrainSwaps().empty())
+        return CalculatePath(destX, destY, destZ, forceDest);
+
+    _request.reset();
+
+    if (!InitPath(destX, destY, destZ, forceDest))
+        return false;
+
+    if (!_usesNavMesh)
+    {
+        FinishPath();
+        return true;
+    }
+
+    // the pathfinding thread may not touch the unit or the map
+    _shortcutAtStart = AllowsShortcutAt(true);
+    _shortcutAtEnd = AllowsShortcutAt(false);
+
+    PathRequestKey key;
+    GetRequestKey(key);
+    _request = service->Request(*this, _sourceUnit->GetMapId(), key);
+    return true;
+}
+
+bool PathGenerator::IsPathPending() const
+{
+    return _request && !_request->Done.load(std::memory_order_acquire);
+}
+
+bool PathGenerator::CollectPath()
+{
+    if (!_request || !_request->Done.load(std::memory_order_acquire))
+        return false;
+
+    if (_request->Unserved)
+    {
+        G3D::Vector3 const& end = GetEndPosition();
+        return CalculatePath(end.x, end.y, end.z, _forceDestination);
+    }
+
+    PathGenerator const& result = _request->Path;
+    _polyLength = result._polyLength;
+    memcpy(_pathPolyRefs, result._pathPolyRefs, _polyLength * sizeof(dtPolyRef));
+    _pathPoints = result._pathPoints;
+    _type = result._type;
+    _pointPath = result._pointPath;
+    _holeInMesh = result._holeInMesh;
+
+    // the request may have been made by another unit up to a step away, straight lines run between our own points
+    _pathPoints[0] = GetStartPosition();
+    if (!_pointPath && result.GetActualEndPosition() == result.GetEndPosition())
+        _pathPoints[_pathPoints.size() - 1] = GetEndPosition();
+    else
+        SetActualEndPosition(result.GetActualEndPosition());
+
+    _request.reset();
+
+    FinishPath();
+    return true;
+}
+
+bool PathGenerator::InitPath(float destX, float destY, float destZ, bool forceDest)
 {
     float x, y, z;
     _sourceUnit->GetPosition(x, y, z);
@@ -55,7 +138,10 @@ bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool fo
 
     _forceDestination = forceDest;
 
-    SF_LOG_DEBUG("maps", "++ PathGenerator::CalculatePath() for %u \n", _sourceUnit->GetGUIDLow());
+    _pointPath = false;
+    _holeInMesh = false;
+
+    SF_LOG_DEBUG("maps", "++ PathGenerator::CalculatePath() for %u \n", _sourceGuidLow);
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
@@ -64,15 +150,110 @@ bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool fo
     {
         BuildShortcut();
         _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        _usesNavMesh = false;
         return true;
     }
 
     UpdateFilter();
 
-    BuildPolyPath(start, dest);
+    _usesNavMesh = true;
     return true;
 }
 
+void PathGenerator::BuildPath(dtNavMeshQuery const* navMeshQuery)
+{
+    // the map was unloaded while the request was queued
+    if (!navMeshQuery)
+    {
+        BuildShortcut();
+        _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        return;
+    }
+
+    _navMeshQuery = navMeshQuery;
+    _navMesh = navMeshQuery->getAttachedNavMesh();
+
+    BuildPolyPath(GetStartPosition(), GetEndPosition());
+}
+
+void PathGenerator::FinishPath()
+{
+    NormalizePath();
+
+    // we have a hole in our mesh
+    // make shortcut path and mark it as NOPATH ( with flying and swimming exception )
+    // its up to caller how he will use this info
+    if (_holeInMesh)
+    {
+        bool path = _sourceUnit->GetTypeId() == TypeID::TYPEID_UNIT && _sourceUnit->ToCreature()->CanFly();
+
+        bool waterPath = _sourceUnit->GetTypeId() == TypeID::TYPEID_UNIT && _sourceUnit->ToCreature()->CanSwim();
+        if (waterPath)
+        {
+            // Check both start and end points, if they're both in water, then we can *safely* let the creature move
+            for (uint32 i = 0; i < _pathPoints.size(); ++i)
+            {
+                ZLiquidStatus status = _sourceUnit->GetBaseMap()->getLiquidStatus(_pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z, MAP_ALL_LIQUIDS, NULL);
+                // One of the points is not in the water, cancel movement.
+                if (status == LIQUID_MAP_NO_WATER)
+                {
+                    waterPath = false;
+                    break;
+                }
+            }
+        }
+
+        _type = (path || waterPath) ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+        return;
+    }
+
+    if (!_pointPath)
+        return;
+
+    uint32 pointCount = _pathPoints.size();
+
+    // first point is always our current location - we need the next one
+    SetActualEndPosition(_pathPoints[pointCount - 1]);
+
+    // force the given destination, if needed
+    if (_forceDestination &&
+        (!(_type & PATHFIND_NORMAL) || !InRange(GetEndPosition(), GetActualEndPosition(), 1.0f, 1.0f)))
+    {
+        // we may want to keep partial subpath
+        if (Dist3DSqr(GetActualEndPosition(), GetEndPosition()) < 0.3f * Dist3DSqr(GetStartPosition(), GetEndPosition()))
+        {
+            SetActualEndPosition(GetEndPosition());
+            _pathPoints[_pathPoints.size() - 1] = GetEndPosition();
+        }
+        else
+        {
+            SetActualEndPosition(GetEndPosition());
+            BuildShortcut();
+            NormalizePath();
+        }
+
+        _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+    }
+
+    SF_LOG_DEBUG("maps", "++ PathGenerator::BuildPointPath path type %d size %d poly-size %d\n", _type, pointCount, _polyLength);
+}
+
+void PathGenerator::GetRequestKey(PathRequestKey& key) const
+{
+    key.MapId = _sourceUnit->GetMapId();
+
+    G3D::Vector3 const& start = GetStartPosition();
+    G3D::Vector3 const& end = GetEndPosition();
+    for (uint8 i = 0; i < 3; ++i)
+    {
+        key.Start[i] = int32(floor(start[i] * PATH_REQUEST_STEPS));
+        key.End[i] = int32(floor(end[i] * PATH_REQUEST_STEPS));
+    }
+
+    key.Options = uint64(_filter.getIncludeFlags()) | uint64(_filter.getExcludeFlags()) << 16 | uint64(_pointPathLimit) << 32 |
+        uint64(_useStraightPath) << 40 | uint64(_shortcutAtStart) << 41 | uint64(_shortcutAtEnd) << 42;
+}
+
 dtPolyRef PathGenerator::GetPathPolyByPosition(dtPolyRef const* polyPath, uint32 polyPathSize, float const* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -158,25 +339,8 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     {
         SF_LOG_DEBUG("maps", "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
-        bool path = _sourceUnit->GetTypeId() == TypeID::TYPEID_UNIT && _sourceUnit->ToCreature()->CanFly();
-
-        bool waterPath = _sourceUnit->GetTypeId() == TypeID::TYPEID_UNIT && _sourceUnit->ToCreature()->CanSwim();
-        if (waterPath)
-        {
-            // Check both start and end points, if they're both in water, then we can *safely* let the creature move
-            for (uint32 i = 0; i < _pathPoints.size(); ++i)
-            {
-                ZLiquidStatus status = _sourceUnit->GetBaseMap()->getLiquidStatus(_pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z, MAP_ALL_LIQUIDS, NULL);
-                // One of the points is not in the water, cancel movement.
-                if (status == LIQUID_MAP_NO_WATER)
-                {
-                    waterPath = false;
-                    break;
-                }
-            }
-        }
-
-        _type = (path || waterPath) ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+        _holeInMesh = true;
+        _type = PATHFIND_NOPATH;
         return;
     }
 
@@ -186,27 +350,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     {
         SF_LOG_DEBUG("maps", "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
-        bool buildShotrcut = false;
-        if (_sourceUnit->GetTypeId() == TypeID::TYPEID_UNIT)
-        {
-            Creature* owner = (Creature*)_sourceUnit;
-
-            G3D::Vector3 const& p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (_sourceUnit->GetBaseMap()->IsUnderWater(p.x, p.y, p.z))
-            {
-                SF_LOG_DEBUG("maps", "++ BuildPolyPath :: underWater case\n");
-                if (owner->CanSwim())
-                    buildShotrcut = true;
-            }
-            else
-            {
-                SF_LOG_DEBUG("maps", "++ BuildPolyPath :: flying case\n");
-                if (owner->CanFly())
-                    buildShotrcut = true;
-            }
-        }
-
-        if (buildShotrcut)
+        if (AllowsShortcutAt(distToStartPoly > 7.0f))
         {
             BuildShortcut();
             _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
@@ -338,7 +482,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
             // this is probably an error state, but we'll leave it
             // and hopefully recover on the next Update
             // we still need to copy our preffix
-            SF_LOG_ERROR("maps", "%u's Path Build failed: 0 length path", _sourceUnit->GetGUIDLow());
+            SF_LOG_ERROR("maps", "%u's Path Build failed: 0 length path", _sourceGuidLow);
         }
 
         SF_LOG_DEBUG("maps", "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n", _polyLength, prefixPolyLength, suffixPolyLength);
@@ -370,7 +514,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         if (!_polyLength || dtStatusFailed(dtResult))
         {
             // only happens if we passed bad data to findPath(), or navmesh is messed up
-            SF_LOG_ERROR("maps", "%u's Path Build failed: 0 length path", _sourceUnit->GetGUIDLow());
+            SF_LOG_ERROR("maps", "%u's Path Build failed: 0 length path", _sourceGuidLow);
             BuildShortcut();
             _type = PATHFIND_NOPATH;
             return;
@@ -439,31 +583,8 @@ void PathGenerator::BuildPointPath(const float* startPoint, const float* endPoin
     for (uint32 i = 0; i < pointCount; ++i)
         _pathPoints[i] = G3D::Vector3(pathPoints[i * VERTEX_SIZE + 2], pathPoints[i * VERTEX_SIZE], pathPoints[i * VERTEX_SIZE + 1]);
 
-    NormalizePath();
-
-    // first point is always our current location - we need the next one
-    SetActualEndPosition(_pathPoints[pointCount - 1]);
-
-    // force the given destination, if needed
-    if (_forceDestination &&
-        (!(_type & PATHFIND_NORMAL) || !InRange(GetEndPosition(), GetActualEndPosition(), 1.0f, 1.0f)))
-    {
-        // we may want to keep partial subpath
-        if (Dist3DSqr(GetActualEndPosition(), GetEndPosition()) < 0.3f * Dist3DSqr(GetStartPosition(), GetEndPosition()))
-        {
-            SetActualEndPosition(GetEndPosition());
-            _pathPoints[_pathPoints.size() - 1] = GetEndPosition();
-        }
-        else
-        {
-            SetActualEndPosition(GetEndPosition());
-            BuildShortcut();
-        }
-
-        _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-    }
-
-    SF_LOG_DEBUG("maps", "++ PathGenerator::BuildPointPath path type %d size %d poly-size %d\n", _type, pointCount, _polyLength);
+    // heights and the end position are left to FinishPath, they need the map
+    _pointPath = true;
 }
 
 void PathGenerator::NormalizePath()
@@ -485,11 +606,30 @@ void PathGenerator::BuildShortcut()
     _pathPoints[0] = GetStartPosition();
     _pathPoints[1] = GetActualEndPosition();
 
-    NormalizePath();
-
     _type = PATHFIND_SHORTCUT;
 }
 
+bool PathGenerator::AllowsShortcutAt(bool atStart) const
+{
+    if (_detached)
+        return atStart ? _shortcutAtStart : _shortcutAtEnd;
+
+    if (_sourceUnit->GetTypeId() != TypeID::TYPEID_UNIT)
+        return false;
+
+    Creature const* owner = _sourceUnit->ToCreature();
+
+    G3D::Vector3 const& p = atStart ? GetStartPosition() : GetEndPosition();
+    if (_sourceUnit->GetBaseMap()->IsUnderWater(p.x, p.y, p.z))
+    {
+        SF_LOG_DEBUG("maps", "++ BuildPolyPath :: underWater case\n");
+        return owner->CanSwim();
+    }
+
+    SF_LOG_DEBUG("maps", "++ BuildPolyPath :: flying case\n");
+    return owner->CanFly();
+}
+
 void PathGenerator::CreateFilter()
 {
     uint16 includeFlags = 0;
@@ -10,8 +10,11 @@
 #include "DetourNavMeshQuery.h"
 #include "MoveSplineInitArgs.h"
 #include "SharedDefines.h"
+#include <memory>
 
 class Unit;
+struct PathRequest;
+struct PathRequestKey;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
@@ -38,6 +41,9 @@ enum PathType
 
 class PathGenerator
 {
+    friend class PathfindingService;
+    friend struct PathRequest;
+
 public:
     explicit PathGenerator(Unit const* owner);
     ~PathGenerator();
@@ -46,6 +52,13 @@ public:
     // return: true if new path was calculated, false otherwise (no change needed)
     bool CalculatePath(float destX, float destY, float destZ, bool forceDest = false);
 
+    // Same as CalculatePath, but the path is calculated by the pathfinding threads if they run
+    // return: false if no path could be started, IsPathPending() tells whether it is ready
+    bool RequestPath(float destX, float destY, float destZ, bool forceDest = false);
+    bool IsPathPending() const;
+    // takes over the path calculated for RequestPath, false while it is still pending
+    bool CollectPath();
+
     // option setters - use optional
     void SetUseStraightPath(bool useStraightPath) { _useStraightPath = useStraightPath; }
     void SetPathLengthLimit(float distance) { _pointPathLimit = std::min<uint32>(uint32(distance / SMOOTH_PATH_STEP_SIZE), MAX_POINT_PATH_LENGTH); }
@@ -74,12 +87,21 @@ private:
     G3D::Vector3 _endPosition;          // {x, y, z} of the destination
     G3D::Vector3 _actualEndPosition;    // {x, y, z} of the closest possible point to given destination
 
-    Unit const* const _sourceUnit;          // the unit that is moving
+    Unit const* const _sourceUnit;          // the unit that is moving, never touched by a detached copy
+    uint32 _sourceGuidLow;                  // for logging, the unit may be gone when a detached copy is freed
     dtNavMesh const* _navMesh;              // the nav mesh
     dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path
 
     dtQueryFilter _filter;  // use single filter for all movements, update it when needed
 
+    bool _usesNavMesh;      // the path is built on the nav mesh, not a straight line
+    bool _pointPath;        // _pathPoints came from the mesh, the end is set when the path is finished
+    bool _holeInMesh;       // start or end is off the mesh, whether the unit gets there is decided when finished
+    bool _detached;         // copy calculated on a pathfinding thread
+    bool _shortcutAtStart;  // AllowsShortcutAt() of a detached copy, answered in advance
+    bool _shortcutAtEnd;
+    std::shared_ptr<PathRequest> _request;  // set while a path calculated by the pathfinding threads is pending
+
     void SetStartPosition(G3D::Vector3 const& point) { _startPosition = point; }
     void SetEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; _endPosition = point; }
     void SetActualEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; }
@@ -99,9 +121,16 @@ private:
     dtPolyRef GetPolyByLocation(float const* Point, float* Distance) const;
     bool HaveTile(G3D::Vector3 const& p) const;
 
+    // CalculatePath is split in InitPath and FinishPath on the map thread and BuildPath, which only uses Detour
+    bool InitPath(float destX, float destY, float destZ, bool forceDest);
+    void BuildPath(dtNavMeshQuery const* navMeshQuery);
+    void FinishPath();
+    void GetRequestKey(PathRequestKey& key) const;
+
     void BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos);
     void BuildPointPath(float const* startPoint, float const* endPoint);
     void BuildShortcut();
+    bool AllowsShortcutAt(bool atStart) const;
 
     NavTerrain GetNavTerrain(float x, float y, float z);
     void CreateFilter();
@@ -0,0 +1,177 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include "Log.h"
+#include "MMapFactory.h"
+#include "MMapManager.h"
+#include "PathfindingService.h"
+
+std::size_t PathRequestKeyHash::operator()(PathRequestKey const& key) const
+{
+    uint64 hash = uint64(key.MapId) * 0x9E3779B97F4A7C15ULL ^ key.Options;
+    for (uint8 i = 0; i < 3; ++i)
+    {
+        hash = (hash ^ uint32(key.Start[i])) * 0x100000001B3ULL;
+        hash = (hash ^ uint32(key.End[i])) * 0x100000001B3ULL;
+    }
+
+    return std::size_t(hash ^ (hash >> 32));
+}
+
+PathRequest::PathRequest(PathGenerator const& path, uint32 mapId, PathRequestKey const& key) :
+    Path(path), MapId(mapId), Key(key), Unserved(false), Done(false)
+{
+    // shared with other units, so it cannot build on the poly path of the unit that asked first
+    Path._detached = true;
+    Path.Clear();
+}
+
+PathfindingService::PathfindingService() : _cancelationToken(false), _requests(0), _shared(0), _dropped(0) { }
+
+PathfindingService::~PathfindingService()
+{
+    Deactivate();
+}
+
+void PathfindingService::Activate(size_t threads)
+{
+    if (IsActive())
+        return;
+
+    _cancelationToken = false;
+
+    for (size_t i = 0; i < threads; ++i)
+        _threads.push_back(std::thread(&PathfindingService::WorkerThread, this));
+}
+
+void PathfindingService::Deactivate()
+{
+    if (!IsActive())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _cancelationToken = true;
+    }
+    _workAvailable.notify_all();
+
+    for (std::thread& thread : _threads)
+        thread.join();
+
+    _threads.clear();
+
+    // only done on shutdown, requests left in the queue are never finished
+    _inFlight.clear();
+    _queue.clear();
+}
+
+std::shared_ptr<PathRequest> PathfindingService::Request(PathGenerator const& path, uint32 mapId, PathRequestKey const& key)
+{
+    std::shared_ptr<PathRequest> request;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++_requests;
+
+        RequestMap::iterator itr = _inFlight.find(key);
+        if (itr != _inFlight.end())
+        {
+            request = itr->second.lock();
+            if (request)
+            {
+                ++_shared;
+                return request;
+            }
+        }
+
+        request = std::make_shared<PathRequest>(path, mapId, key);
+        _inFlight[key] = request;
+        _queue.push_back(request);
+    }
+    _workAvailable.notify_one();
+
+    return request;
+}
+
+PathfindingStats PathfindingService::GetStats()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    PathfindingStats stats = { _requests, _shared, _dropped, uint32(_queue.size()) };
+    return stats;
+}
+
+void PathfindingService::WorkerThread()
+{
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    NavMeshQueryMap queries;
+
+    std::unique_lock<std::mutex> guard(_lock);
+    while (true)
+    {
+        while (_queue.empty() && !_cancelationToken)
+            _workAvailable.wait(guard);
+
+        if (_cancelationToken)
+            break;
+
+        std::shared_ptr<PathRequest> request = _queue.front();
+        _queue.pop_front();
+
+        // joining takes the lock too, only the queue holds a request nobody waits for
+        if (request.use_count() == 1)
+        {
+            ++_dropped;
+            _inFlight.erase(request->Key);
+            continue;
+        }
+
+        guard.unlock();
+
+        {
+            dtNavMesh const* navMesh = NULL;
+            bool swapped = false;
+            std::shared_lock<std::shared_mutex> meshGuard = mmap->LockNavMesh(request->MapId, navMesh, swapped);
+            if (swapped)
+                request->Unserved = true;
+            else
+                request->Path.BuildPath(navMesh ? GetNavMeshQuery(queries, request->MapId, navMesh) : NULL);
+        }
+
+        guard.lock();
+
+        // a request that was dropped on shutdown is not in there
+        RequestMap::iterator itr = _inFlight.find(request->Key);
+        if (itr != _inFlight.end() && itr->second.lock() == request)
+            _inFlight.erase(itr);
+
+        request->Done.store(true, std::memory_order_release);
+    }
+
+    guard.unlock();
+
+    for (NavMeshQueryMap::iterator itr = queries.begin(); itr != queries.end(); ++itr)
+        dtFreeNavMeshQuery(itr->second);
+}
+
+dtNavMeshQuery* PathfindingService::GetNavMeshQuery(NavMeshQueryMap& queries, uint32 mapId, dtNavMesh const* navMesh)
+{
+    dtNavMeshQuery*& query = queries[mapId];
+    if (query && query->getAttachedNavMesh() == navMesh)
+        return query;
+
+    // a query of a map that was loaded again is attached to the new mesh
+    if (!query)
+        query = dtAllocNavMeshQuery();
+
+    if (dtStatusFailed(query->init(navMesh, 1024)))
+    {
+        SF_LOG_ERROR("maps", "PathfindingService: failed to initialize dtNavMeshQuery for map %u", mapId);
+        dtFreeNavMeshQuery(query);
+        queries.erase(mapId);
+        return NULL;
+    }
+
+    return query;
+}
@@ -0,0 +1,109 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef SF_PATHFINDING_SERVICE_H
+#define SF_PATHFINDING_SERVICE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "PathGenerator.h"
+
+/// Identifies paths that come out the same, positions are compared in steps of 1 / PATH_REQUEST_STEPS yards.
+/// Units in terrain swaps never queue requests, so the key has no swap set.
+struct PathRequestKey
+{
+    uint32 MapId;
+    int32 Start[3];
+    int32 End[3];
+    uint64 Options;                                         // query filter, path options and the shortcuts the unit may take
+
+    bool operator==(PathRequestKey const& right) const
+    {
+        return MapId == right.MapId && Options == right.Options &&
+            Start[0] == right.Start[0] && Start[1] == right.Start[1] && Start[2] == right.Start[2] &&
+            End[0] == right.End[0] && End[1] == right.End[1] && End[2] == right.End[2];
+    }
+};
+
+struct PathRequestKeyHash
+{
+    std::size_t operator()(PathRequestKey const& key) const;
+};
+
+#define PATH_REQUEST_STEPS 2.0f
+
+/// A path being calculated, shared by every unit that asked for the same one.
+struct PathRequest
+{
+    PathRequest(PathGenerator const& path, uint32 mapId, PathRequestKey const& key);
+
+    PathGenerator Path;                                     // detached copy, the result once Done is set
+    uint32 MapId;
+    PathRequestKey Key;
+    bool Unserved;                                          // terrain swap tiles were in the mesh, the map thread calculates it; set before Done
+    std::atomic<bool> Done;
+};
+
+struct PathfindingStats
+{
+    uint64 Requests;
+    uint64 Shared;                                          // joined a request for the same path that was in flight
+    uint64 Dropped;                                         // nobody waited for the result any more
+    uint32 Queued;
+};
+
+/*
+ * Calculates the paths of chasing and following units on background threads.
+ *
+ * The map thread fills in everything that needs the unit or the map (filter,
+ * tiles, what shortcuts the unit may take), a worker only runs the Detour
+ * queries on a copy of the generator and the map thread finishes the path
+ * (ground heights, forced destinations) when it collects it on a later update.
+ * Each worker keeps a dtNavMeshQuery per map, queries are not thread safe.
+ * Units chasing the same target from about the same spot share one request.
+ */
+class PathfindingService
+{
+public:
+    PathfindingService();
+    ~PathfindingService();
+
+    void Activate(size_t threads);
+    void Deactivate();
+    bool IsActive() const { return !_threads.empty(); }
+
+    // queues the path, or returns the request for the same path already queued
+    std::shared_ptr<PathRequest> Request(PathGenerator const& path, uint32 mapId, PathRequestKey const& key);
+
+    PathfindingStats GetStats();
+
+private:
+    typedef std::unordered_map<PathRequestKey, std::weak_ptr<PathRequest>, PathRequestKeyHash> RequestMap;
+    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQueryMap;
+
+    void WorkerThread();
+    static dtNavMeshQuery* GetNavMeshQuery(NavMeshQueryMap& queries, uint32 mapId, dtNavMesh const* navMesh);
+
+    std::vector<std::thread> _threads;
+    RequestMap _inFlight;
+    std::deque<std::shared_ptr<PathRequest>> _queue;
+    bool _cancelationToken;
+
+    uint64 _requests;
+    uint64 _shared;
+    uint64 _dropped;
+
+    std::mutex _lock;
+    std::condition_variable _workAvailable;
+};
+
+#endif
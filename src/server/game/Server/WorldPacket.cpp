@@ -5,8 +5,53 @@
 
 #include "World.h"
 #include "WorldPacket.h"
+#include <ace/Lock_Adapter_T.h>
+#include <ace/Message_Block.h>
+#include <ace/Thread_Mutex.h>
 #include <zlib.h>
 
+namespace
+{
+    // shared payloads are duplicated by map threads and released by network threads
+    ACE_Lock_Adapter<ACE_Thread_Mutex> sSharedPayloadLock;
+}
+
+WorldPacket::~WorldPacket()
+{
+    ReleaseSharedPayload();
+}
+
+ACE_Message_Block* WorldPacket::GetSharedPayload() const
+{
+    if (!_shareCount || empty())
+        return NULL;
+
+    if (!_sharedPayload)
+    {
+        // sockets hold their own references, the block outlives the packet if they need it to
+        _sharedPayload = new ACE_Message_Block(size(), ACE_Message_Block::MB_DATA, NULL, NULL, NULL, &sSharedPayloadLock);
+        _sharedPayload->copy((char const*)contents(), size());
+    }
+
+    return _sharedPayload;
+}
+
+void WorldPacket::EndBroadcast() const
+{
+    ASSERT(_shareCount);
+    if (--_shareCount == 0)
+        ReleaseSharedPayload();
+}
+
+void WorldPacket::ReleaseSharedPayload() const
+{
+    if (_sharedPayload)
+    {
+        _sharedPayload->release();
+        _sharedPayload = NULL;
+    }
+}
+
 //! Compresses packet in place
 void WorldPacket::Compress(z_stream* compressionStream)
 {
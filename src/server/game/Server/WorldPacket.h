@@ -10,26 +10,51 @@
 #include "Common.h"
 #include "Opcodes.h"
 
+class ACE_Message_Block;
 struct z_stream_s;
 
 class WorldPacket : public ByteBuffer
 {
 public:
+    // most packets are a few dozen bytes, they are built without touching the heap
+    static size_t const INLINE_SIZE = 256;
+
     // just container for later use
-    WorldPacket() : ByteBuffer(0), m_opcode(UNKNOWN_OPCODE), m_rcvdOpcodeNumber(0), _compressionStream(NULL)
+    WorldPacket() : ByteBuffer(0, _inlineBody, INLINE_SIZE), m_opcode(UNKNOWN_OPCODE), m_rcvdOpcodeNumber(0), _compressionStream(NULL),
+        _shareCount(0), _sharedPayload(NULL)
     {
     }
 
-    WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(res), m_opcode(opcode), m_rcvdOpcodeNumber(0), _compressionStream(NULL)
+    WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(res, _inlineBody, INLINE_SIZE), m_opcode(opcode), m_rcvdOpcodeNumber(0), _compressionStream(NULL),
+        _shareCount(0), _sharedPayload(NULL)
     {
     }
     // copy constructor
-    WorldPacket(WorldPacket const& packet) : ByteBuffer(packet), m_opcode(packet.m_opcode), m_rcvdOpcodeNumber(0), _compressionStream(NULL)
+    WorldPacket(WorldPacket const& packet) : ByteBuffer(packet, _inlineBody, INLINE_SIZE), m_opcode(packet.m_opcode), m_rcvdOpcodeNumber(0),
+        _compressionStream(NULL), _shareCount(0), _sharedPayload(NULL)
     {
     }
 
+    // the inline body belongs to this packet, only the contents are copied
+    WorldPacket& operator=(WorldPacket const& packet)
+    {
+        if (this == &packet)
+            return *this;
+
+        ASSERT(!_shareCount);
+        ReleaseSharedPayload();
+        ByteBuffer::operator=(packet);
+        m_opcode = packet.m_opcode;
+        m_rcvdOpcodeNumber = packet.m_rcvdOpcodeNumber;
+        return *this;
+    }
+
+    ~WorldPacket();
+
     void Initialize(Opcodes opcode, size_t newres = 200)
     {
+        ASSERT(!_shareCount);
+        ReleaseSharedPayload();
         clear();
         _storage.reserve(newres);
         m_opcode = opcode;
@@ -42,10 +67,41 @@ public:
     void SetReceivedOpcode(uint16 opcode) { m_rcvdOpcodeNumber = opcode; }
     uint16 GetReceivedOpcode() { return m_rcvdOpcodeNumber; }
 
+    /// Body of the packet in a reference counted block that any number of sockets can queue
+    /// without copying it, NULL unless the packet is being broadcast (see WorldPacketBroadcast).
+    /// Built on first use, the caller must duplicate() it to keep a reference.
+    ACE_Message_Block* GetSharedPayload() const;
+
 protected:
+    friend class WorldPacketBroadcast;
+
+    void BeginBroadcast() const { ++_shareCount; }
+    void EndBroadcast() const;
+    void ReleaseSharedPayload() const;
+
     Opcodes m_opcode;
     uint16 m_rcvdOpcodeNumber;
     void Compress(void* dst, uint32* dst_size, const void* src, int src_size);
     z_stream_s* _compressionStream;
+
+    mutable uint32 _shareCount;
+    mutable ACE_Message_Block* _sharedPayload;
+
+    uint8 _inlineBody[INLINE_SIZE];
+};
+
+/// Marks a packet as immutable while it is sent to many sessions, their sockets then share
+/// one copy of its body instead of copying it each. The packet must not change meanwhile.
+class WorldPacketBroadcast
+{
+public:
+    explicit WorldPacketBroadcast(WorldPacket const* packet) : _packet(packet) { _packet->BeginBroadcast(); }
+    ~WorldPacketBroadcast() { _packet->EndBroadcast(); }
+
+private:
+    WorldPacketBroadcast(WorldPacketBroadcast const&);
+    WorldPacketBroadcast& operator=(WorldPacketBroadcast const&);
+
+    WorldPacket const* _packet;
 };
 #endif
@@ -4,6 +4,7 @@
 */
 
 #include <ace/Message_Block.h>
+#include <ace/OS_NS_sys_socket.h>
 #include <ace/os_include/arpa/os_inet.h>
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_socket.h>
@@ -26,6 +27,7 @@
 #include "Player.h"
 #include "ScriptMgr.h"
 #include "SharedDefines.h"
+#include "Timer.h"
 #include "Util.h"
 #include "World.h"
 #include "WorldPacket.h"
@@ -88,14 +90,12 @@ WorldSocket::WorldSocket(void) : WorldHandler(),
 m_LastPingTime(ACE_Time_Value::zero), m_OverSpeedPings(0), m_Session(0),
 m_RecvWPct(0), m_RecvPct(), m_Header(sizeof(AuthClientPktHeader)),
 m_WorldHeader(sizeof(WorldClientPktHeader)), m_OutBuffer(0),
-m_OutBufferSize(65536), m_OutActive(false)
+m_OutBufferSize(65536), m_OutQueueBytes(0), m_OutQueueTailOpen(false),
+m_OutPendingSince(0), m_CorkWindow(0), m_OutActive(false)
 {
     SkyFire::Crypto::GetRandomBytes(m_Seed);
 
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
-
-    msg_queue()->high_water_mark(8 * 1024 * 1024);
-    msg_queue()->low_water_mark(8 * 1024 * 1024);
 }
 
 WorldSocket::~WorldSocket(void)
@@ -105,6 +105,9 @@ WorldSocket::~WorldSocket(void)
     if (m_OutBuffer)
         m_OutBuffer->release();
 
+    for (OutputQueue::iterator itr = m_OutQueue.begin(); itr != m_OutQueue.end(); ++itr)
+        (*itr)->release();
+
     closing_ = true;
 
     peer().close();
@@ -170,37 +173,130 @@ int WorldSocket::SendPacket(WorldPacket const& pct)
 
     ServerPktHeader header(!m_Crypt.IsInitialized() ? pkt->size() + 2 : pct.size(), opcodeNumber, &m_Crypt);
 
-    if (m_OutBuffer->space() >= pkt->size() + header.getHeaderLength() && msg_queue()->is_empty())
+    // broadcast bodies are queued by reference, only the per connection header is copied
+    if (pkt->size() >= SHARED_PAYLOAD_MIN_SIZE)
+        if (ACE_Message_Block* payload = pkt->GetSharedPayload())
+            return SendSharedPayload(header.header, header.getHeaderLength(), payload);
+
+    if (AppendOutput((char const*)header.header, header.getHeaderLength()) == -1)
+        return -1;
+
+    if (!pkt->empty())
+        if (AppendOutput((char const*)pkt->contents(), pkt->size()) == -1)
+            return -1;
+
+    return 0;
+}
+
+int WorldSocket::SendSharedPayload(uint8 const* header, size_t headerLength, ACE_Message_Block* payload)
+{
+    if (AppendOutput((char const*)header, headerLength) == -1)
+        return -1;
+
+    return EnqueueOutput(payload->duplicate());
+}
+
+int WorldSocket::AppendOutput(char const* data, size_t length)
+{
+    if (!HasPendingOutput())
+        m_OutPendingSince = getMSTime();
+
+    // the out buffer is always flushed before the queue, it can only take data while nothing is queued behind it
+    if (m_OutQueue.empty())
     {
-        // Put the packet on the buffer.
-        if (m_OutBuffer->copy((char*)header.header, header.getHeaderLength()) == -1)
+        size_t chunk = std::min(length, m_OutBuffer->space());
+        if (chunk && m_OutBuffer->copy(data, chunk) == -1)
             ACE_ASSERT(false);
 
-        if (!pkt->empty())
-            if (m_OutBuffer->copy((char*)pkt->contents(), pkt->size()) == -1)
-                ACE_ASSERT(false);
+        data += chunk;
+        length -= chunk;
     }
-    else
+    // small packets queued in the same tick share one block
+    else if (m_OutQueueTailOpen)
+    {
+        ACE_Message_Block* tail = m_OutQueue.back();
+        size_t chunk = std::min(length, tail->space());
+        if (chunk && tail->copy(data, chunk) == -1)
+            ACE_ASSERT(false);
+
+        m_OutQueueBytes += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+
+    if (!length)
+        return 0;
+
+    // a socket that is only a little behind gets an exact block, room to coalesce grows with its backlog
+    size_t size = std::max(length, std::min(m_OutQueueBytes, OUT_QUEUE_BLOCK_SIZE));
+
+    ACE_Message_Block* mb;
+    ACE_NEW_RETURN(mb, ACE_Message_Block(size), -1);
+    mb->copy(data, length);
+
+    if (EnqueueOutput(mb) == -1)
+        return -1;
+
+    m_OutQueueTailOpen = true;
+    return 0;
+}
+
+int WorldSocket::EnqueueOutput(ACE_Message_Block* mb)
+{
+    if (!HasPendingOutput())
+        m_OutPendingSince = getMSTime();
+
+    size_t length = mb->total_length();
+    if (m_OutQueueBytes + length > OUT_QUEUE_MAX_BYTES)
     {
-        // Enqueue the packet.
-        ACE_Message_Block* mb;
+        SF_LOG_ERROR("network", "WorldSocket::EnqueueOutput: output queue of %s is full", GetRemoteAddress().c_str());
+        mb->release();
+        return -1;
+    }
 
-        ACE_NEW_RETURN(mb, ACE_Message_Block(pkt->size() + header.getHeaderLength()), -1);
+    m_OutQueue.push_back(mb);
+    m_OutQueueBytes += length;
+    m_OutQueueTailOpen = false;
+    return 0;
+}
+
+void WorldSocket::ConsumeOutput(size_t length)
+{
+    size_t chunk = std::min(length, m_OutBuffer->length());
+    m_OutBuffer->rd_ptr(chunk);
+    length -= chunk;
 
-        mb->copy((char*)header.header, header.getHeaderLength());
+    if (m_OutBuffer->length() == 0)
+        m_OutBuffer->reset();
 
-        if (!pkt->empty())
-            mb->copy((const char*)pkt->contents(), pkt->size());
+    while (length)
+    {
+        ACE_ASSERT(!m_OutQueue.empty());
 
-        if (msg_queue()->enqueue_tail(mb, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
+        ACE_Message_Block* front = m_OutQueue.front();
+        for (ACE_Message_Block* mb = front; mb && length; mb = mb->cont())
         {
-            SF_LOG_ERROR("network", "WorldSocket::SendPacket enqueue_tail failed");
-            mb->release();
-            return -1;
+            chunk = std::min(length, mb->length());
+            mb->rd_ptr(chunk);
+            m_OutQueueBytes -= chunk;
+            length -= chunk;
         }
+
+        // partially sent, the rest goes out with the next write
+        if (front->total_length())
+            break;
+
+        front->release();
+        m_OutQueue.pop_front();
     }
 
-    return 0;
+    if (m_OutQueue.empty())
+        m_OutQueueTailOpen = false;
+}
+
+bool WorldSocket::HasPendingOutput() const
+{
+    return m_OutBuffer->length() != 0 || !m_OutQueue.empty();
 }
 
 long WorldSocket::AddReference(void)
@@ -318,104 +414,68 @@ int WorldSocket::handle_output(ACE_HANDLE)
     if (closing_)
         return -1;
 
-    size_t send_len = m_OutBuffer->length();
-
-    if (send_len == 0)
-        return handle_output_queue(Guard);
-
-#ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
-#else
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len);
-#endif // MSG_NOSIGNAL
+    // everything pending leaves in one gathered write: the out buffer, then the queued blocks and their chains
+    iovec iov[MAX_OUTPUT_IOV];
+    int count = 0;
+    size_t send_len = 0;
 
-    if (n == 0)
-        return -1;
-    else if (n == -1)
+    if (m_OutBuffer->length())
     {
-        if (errno == EWOULDBLOCK || errno == EAGAIN)
-            return schedule_wakeup_output(Guard);
-
-        return -1;
+        iov[count].iov_base = m_OutBuffer->rd_ptr();
+        iov[count].iov_len = m_OutBuffer->length();
+        send_len += m_OutBuffer->length();
+        ++count;
     }
-    else if (n < (ssize_t)send_len) //now n > 0
-    {
-        m_OutBuffer->rd_ptr(static_cast<size_t> (n));
-
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch();
 
-        return schedule_wakeup_output(Guard);
-    }
-    else //now n == send_len
+    for (OutputQueue::const_iterator itr = m_OutQueue.begin(); itr != m_OutQueue.end() && count < MAX_OUTPUT_IOV; ++itr)
     {
-        m_OutBuffer->reset();
-
-        return handle_output_queue(Guard);
-    }
-
-    ACE_NOTREACHED(return 0);
-}
-
-int WorldSocket::handle_output_queue(GuardType& g)
-{
-    if (msg_queue()->is_empty())
-        return cancel_wakeup_output(g);
-
-    ACE_Message_Block* mblk;
+        for (ACE_Message_Block* mb = *itr; mb && count < MAX_OUTPUT_IOV; mb = mb->cont())
+        {
+            if (!mb->length())
+                continue;
 
-    if (msg_queue()->dequeue_head(mblk, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
-    {
-        SF_LOG_ERROR("network", "WorldSocket::handle_output_queue dequeue_head");
-        return -1;
+            iov[count].iov_base = mb->rd_ptr();
+            iov[count].iov_len = mb->length();
+            send_len += mb->length();
+            ++count;
+        }
     }
 
-    const size_t send_len = mblk->length();
+    if (!count)
+        return cancel_wakeup_output(Guard);
 
 #ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(mblk->rd_ptr(), send_len, MSG_NOSIGNAL);
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+
+    ssize_t n = ACE_OS::sendmsg(get_handle(), &msg, MSG_NOSIGNAL);
 #else
-    ssize_t n = peer().send(mblk->rd_ptr(), send_len);
+    ssize_t n = peer().sendv(iov, count);
 #endif // MSG_NOSIGNAL
 
     if (n == 0)
-    {
-        mblk->release();
-
         return -1;
-    }
     else if (n == -1)
     {
         if (errno == EWOULDBLOCK || errno == EAGAIN)
-        {
-            msg_queue()->enqueue_head(mblk, (ACE_Time_Value*)&ACE_Time_Value::zero);
-            return schedule_wakeup_output(g);
-        }
+            return schedule_wakeup_output(Guard);
 
-        mblk->release();
         return -1;
     }
-    else if (n < (ssize_t)send_len) //now n > 0
-    {
-        mblk->rd_ptr(static_cast<size_t> (n));
 
-        if (msg_queue()->enqueue_head(mblk, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
-        {
-            SF_LOG_ERROR("network", "WorldSocket::handle_output_queue enqueue_head");
-            mblk->release();
-            return -1;
-        }
+    ConsumeOutput(static_cast<size_t>(n));
 
-        return schedule_wakeup_output(g);
-    }
-    else //now n == send_len
-    {
-        mblk->release();
+    // the kernel buffer is full, wait until the socket is writable again
+    if (n < (ssize_t)send_len)
+        return schedule_wakeup_output(Guard);
 
-        return msg_queue()->is_empty() ? cancel_wakeup_output(g) : ACE_Event_Handler::WRITE_MASK;
-    }
+    // more than MAX_OUTPUT_IOV blocks were pending
+    if (HasPendingOutput())
+        return ACE_Event_Handler::WRITE_MASK;
 
-    ACE_NOTREACHED(return -1);
+    return cancel_wakeup_output(Guard);
 }
 
 int WorldSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask)
@@ -451,7 +511,11 @@ int WorldSocket::Update(void)
 
     {
         ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, 0);
-        if (m_OutBuffer->length() == 0 && msg_queue()->is_empty())
+        if (!HasPendingOutput())
+            return 0;
+
+        // corked: let packets of the next ticks join the write unless it is already large
+        if (m_CorkWindow && GetMSTimeDiffToNow(m_OutPendingSince) < m_CorkWindow && m_OutBuffer->length() + m_OutQueueBytes < m_OutBufferSize)
             return 0;
     }
 
@@ -21,6 +21,8 @@
 #include <ace/Thread_Mutex.h>
 #include <ace/Unbounded_Queue.h>
 
+#include <deque>
+
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
 #endif /* ACE_LACKS_PRAGMA_ONCE */
@@ -136,8 +138,19 @@ private:
     int cancel_wakeup_output(GuardType& g);
     int schedule_wakeup_output(GuardType& g);
 
-    /// Drain the queue if its not empty.
-    int handle_output_queue(GuardType& g);
+    /// Queue a header and a reference to a body shared with other sockets, m_OutBufferLock must be held.
+    int SendSharedPayload(uint8 const* header, size_t headerLength, ACE_Message_Block* payload);
+
+    /// Copy data behind the pending output, into m_OutBuffer while nothing is queued, else into the open tail block.
+    int AppendOutput(char const* data, size_t length);
+
+    /// Queue a block as is, takes ownership of mb. Nothing is appended to it afterwards.
+    int EnqueueOutput(ACE_Message_Block* mb);
+
+    /// Drop length bytes that were written from the front of the pending output.
+    void ConsumeOutput(size_t length);
+
+    bool HasPendingOutput() const;
 
     /// process one incoming packet.
     /// @param new_pct received packet, note that you need to delete it.
@@ -193,6 +206,34 @@ private:
     /// Size of the m_OutBuffer.
     size_t m_OutBufferSize;
 
+    /// Output behind m_OutBuffer, written together with it by one gathered write.
+    typedef std::deque<ACE_Message_Block*> OutputQueue;
+    OutputQueue m_OutQueue;
+
+    /// Bytes waiting in m_OutQueue.
+    size_t m_OutQueueBytes;
+
+    /// True if the back of m_OutQueue is a private block more packets can be copied into.
+    bool m_OutQueueTailOpen;
+
+    /// getMSTime() of the moment output became pending.
+    uint32 m_OutPendingSince;
+
+    /// Milliseconds Update() holds back a small pending output, 0 flushes every tick.
+    uint32 m_CorkWindow;
+
+    /// Most buffers handed to one gathered write.
+    static int const MAX_OUTPUT_IOV = 64;
+
+    /// Most room a queued block reserves for coalescing the small packets behind it.
+    static size_t const OUT_QUEUE_BLOCK_SIZE = 16 * 1024;
+
+    /// Sockets with more output queued are closed.
+    static size_t const OUT_QUEUE_MAX_BYTES = 8 * 1024 * 1024;
+
+    /// Broadcast bodies from this size on are queued by reference, smaller ones are cheaper to copy.
+    static size_t const SHARED_PAYLOAD_MIN_SIZE = 512;
+
     /// True if the socket is registered with the reactor for output
     bool m_OutActive;
 
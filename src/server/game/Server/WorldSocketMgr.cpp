@@ -202,6 +202,7 @@ WorldSocketMgr::WorldSocketMgr() :
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
     m_UseNoDelay(true),
+    m_CorkWindow(0),
     m_Acceptor(0) { }
 
 WorldSocketMgr::~WorldSocketMgr()
@@ -240,6 +241,14 @@ WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
         return -1;
     }
 
+    m_CorkWindow = sConfigMgr->GetIntDefault("Network.CorkWindow", 0);
+
+    if (m_CorkWindow < 0)
+    {
+        SF_LOG_ERROR("misc", "Network.CorkWindow is wrong in your config file");
+        return -1;
+    }
+
     m_Acceptor = new WorldSocketAcceptor;
 
     ACE_INET_Addr listen_addr(port, address);
@@ -259,7 +268,7 @@ WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
 int
 WorldSocketMgr::StartNetwork(ACE_UINT16 port, const char* address)
 {
-    if (!sLog->ShouldLog("misc", LogLevel::LOG_LEVEL_DEBUG))
+    if (!SF_LOG_ENABLED("misc", LogLevel::LOG_LEVEL_DEBUG))
         ACE_Log_Msg::instance()->priority_mask(LM_ERROR, ACE_Log_Msg::PROCESS);
 
     if (StartReactiveIO(port, address) == -1)
@@ -331,6 +340,7 @@ WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     }
 
     sock->m_OutBufferSize = static_cast<size_t> (m_SockOutUBuff);
+    sock->m_CorkWindow = static_cast<uint32> (m_CorkWindow);
 
     // we skip the Acceptor Thread
     size_t min = 1;
@@ -51,6 +51,7 @@ private:
     int m_SockOutKBuff;
     int m_SockOutUBuff;
     bool m_UseNoDelay;
+    int m_CorkWindow;
 
     class WorldSocketAcceptor* m_Acceptor;
 };
@@ -725,7 +725,10 @@ void AuraEffect::ChangeAmount(int32 newAmount, bool mark, bool onStackOrReapply)
     if (handleMask & AURA_EFFECT_HANDLE_CHANGE_AMOUNT)
     {
         if (!mark)
+        {
             m_amount = newAmount;
+            InvalidateTargetModifiers();
+        }
         else
             SetAmount(newAmount);
         CalculateSpellMod();
@@ -736,6 +739,13 @@ void AuraEffect::ChangeAmount(int32 newAmount, bool mark, bool onStackOrReapply)
             HandleEffect(*apptItr, handleMask, true);
 }
 
+void AuraEffect::InvalidateTargetModifiers()
+{
+    Aura::ApplicationMap const& applications = GetBase()->GetApplicationMap();
+    for (Aura::ApplicationMap::const_iterator itr = applications.begin(); itr != applications.end(); ++itr)
+        itr->second->GetTarget()->InvalidateAuraModifiers(GetAuraType());
+}
+
 void AuraEffect::HandleEffect(AuraApplication* aurApp, uint8 mode, bool apply)
 {
     // check if call is correct, we really don't want using bitmasks here (with 1 exception)
@@ -40,7 +40,7 @@ public:
     int32 GetMiscValue() const { return m_spellInfo->Effects[m_effIndex].MiscValue; }
     AuraType GetAuraType() const { return (AuraType)m_spellInfo->Effects[m_effIndex].ApplyAuraName; }
     int32 GetAmount() const { return m_amount; }
-    void SetAmount(int32 amount) { m_amount = amount; m_canBeRecalculated = false; }
+    void SetAmount(int32 amount) { m_amount = amount; m_canBeRecalculated = false; InvalidateTargetModifiers(); }
 
     int32 GetPeriodicTimer() const { return m_periodicTimer; }
     void SetPeriodicTimer(int32 periodicTimer) { m_periodicTimer = periodicTimer; }
@@ -48,6 +48,8 @@ public:
     int32 CalculateAmount(Unit* caster);
     void CalculatePeriodic(Unit* caster, bool resetPeriodicTimer = true, bool load = false);
     void CalculateSpellMod();
+    // the targets calculate their aura modifiers again with the new amount
+    void InvalidateTargetModifiers();
     void ChangeAmount(int32 newAmount, bool mark = true, bool onStackOrReapply = false);
     void RecalculateAmount() { if (!CanBeRecalculated()) return; ChangeAmount(CalculateAmount(GetCaster()), false); }
     void RecalculateAmount(Unit* caster) { if (!CanBeRecalculated()) return; ChangeAmount(CalculateAmount(caster), false); }
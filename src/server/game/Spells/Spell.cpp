@@ -1357,8 +1357,10 @@ void Spell::SelectImplicitAreaTargets(SpellEffIndex effIndex, SpellImplicitTarge
         if (uint32 maxTargets = m_spellValue->MaxAffectedTargets)
             Skyfire::Containers::RandomResizeList(unitTargets, maxTargets);
 
+        PrepareTargetLOS(unitTargets);
         for (std::list<Unit*>::iterator itr = unitTargets.begin(); itr != unitTargets.end(); ++itr)
             AddUnitTarget(*itr, effMask, false);
+        m_targetLOS.clear();
     }
 
     if (!gObjTargets.empty())
@@ -7304,14 +7306,53 @@ bool Spell::CheckEffectTarget(Unit const* target, uint32 eff) const
                 caster = m_caster->GetMap()->GetGameObject(m_originalCasterGUID);
             if (!caster)
                 caster = m_caster;
-            if (target != m_caster && !target->IsWithinLOSInMap(caster))
-                return false;
+            if (target != m_caster)
+            {
+                std::unordered_map<uint64, bool>::const_iterator los = m_targetLOS.find(target->GetGUID());
+                if (los != m_targetLOS.end() ? !los->second : !target->IsWithinLOSInMap(caster))
+                    return false;
+            }
             break;
     }
 
     return true;
 }
 
+void Spell::PrepareTargetLOS(std::list<Unit*> const& targets)
+{
+    if (targets.size() < 2 || IsTriggered() || m_spellInfo->AttributesEx2 & SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, NULL, SPELL_DISABLE_LOS))
+        return;
+
+    // same caster as in CheckEffectTarget()
+    WorldObject* caster = NULL;
+    if (IS_GAMEOBJECT_GUID(m_originalCasterGUID))
+        caster = m_caster->GetMap()->GetGameObject(m_originalCasterGUID);
+    if (!caster)
+        caster = m_caster;
+
+    // the checks of WorldObject::IsWithinLOSInMap(), targets it does not trace are left to it
+    std::vector<Unit*> units;
+    std::vector<LineOfSightCheck> checks;
+    for (std::list<Unit*>::const_iterator itr = targets.begin(); itr != targets.end(); ++itr)
+    {
+        Unit* target = *itr;
+        if (target == m_caster || !target->IsInWorld() || !target->IsInMap(caster))
+            continue;
+
+        LineOfSightCheck check = { target->GetPositionX(), target->GetPositionY(), target->GetPositionZ() + 2.f,
+            caster->GetPositionX(), caster->GetPositionY(), caster->GetPositionZ() + 2.f, target->GetPhaseMask(), true };
+        checks.push_back(check);
+        units.push_back(target);
+    }
+
+    if (checks.size() < 2)
+        return;
+
+    caster->GetMap()->isInLineOfSight(&checks[0], checks.size());
+    for (size_t i = 0; i < checks.size(); ++i)
+        m_targetLOS[units[i]->GetGUID()] = checks[i].result;
+}
+
 bool Spell::IsNextMeleeSwingSpell() const
 {
     return m_spellInfo->Attributes & SPELL_ATTR0_ON_NEXT_SWING;
@@ -631,6 +631,9 @@ protected:
     void AddGOTarget(GameObject* target, uint32 effectMask);
     void AddItemTarget(Item* item, uint32 effectMask);
     void AddDestTarget(SpellDestination const& dest, uint32 effIndex);
+    // checks the line of sight of several area targets at once, used by CheckEffectTarget() until the list is cleared
+    void PrepareTargetLOS(std::list<Unit*> const& targets);
+    std::unordered_map<uint64, bool> m_targetLOS;
 
     void DoAllEffectOnTarget(TargetInfo* target);
     SpellMissInfo DoSpellHitOnUnit(Unit* unit, uint32 effectMask, bool scaleAura);
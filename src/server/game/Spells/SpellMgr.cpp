@@ -307,7 +307,7 @@ bool IsDiminishingReturnsGroupDurationLimited(DiminishingGroup group)
     }
 }
 
-SpellMgr::SpellMgr() { }
+SpellMgr::SpellMgr() : mProcLoadCount(0) { }
 
 SpellMgr::~SpellMgr()
 {
@@ -730,6 +730,20 @@ SpellProcEventEntry const* SpellMgr::GetSpellProcEvent(uint32 spellId) const
     return NULL;
 }
 
+uint32 SpellMgr::GetSpellProcEventFlags(SpellInfo const* spellInfo) const
+{
+    // handled by the new proc system
+    if (GetSpellProcEntry(spellInfo->Id))
+        return 0;
+
+    // custom procFlags of the proc event, else the ones of the spell
+    SpellProcEventEntry const* spellProcEvent = GetSpellProcEvent(spellInfo->Id);
+    if (spellProcEvent && spellProcEvent->procFlags)
+        return spellProcEvent->procFlags;
+
+    return spellInfo->ProcFlags;
+}
+
 bool SpellMgr::IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellProcEvent, uint32 EventProcFlag, SpellInfo const* procSpell, uint32 procFlags, uint32 procExtra, bool active) const
 {
     // No extra req need
@@ -1744,6 +1758,7 @@ void SpellMgr::LoadSpellProcEvents()
     uint32 oldMSTime = getMSTime();
 
     mSpellProcEventMap.clear();                             // need for reload case
+    ++mProcLoadCount;
 
     //                                                0      1           2                3                 4                 5                6                 7          8        9       10            11
     QueryResult result = WorldDatabase.Query("SELECT entry, SchoolMask, SpellFamilyName, SpellFamilyMask0, SpellFamilyMask1, SpellFamilyMask2, SpellFamilyMask3, procFlags, procEx, ppmRate, CustomChance, Cooldown FROM spell_proc_event");
@@ -1832,6 +1847,7 @@ void SpellMgr::LoadSpellProcs()
     uint32 oldMSTime = getMSTime();
 
     mSpellProcMap.clear();                             // need for reload case
+    ++mProcLoadCount;
 
     //                                                 0        1           2                3                 4                 5                 6         7              8               9        10              11             12      13        14
     QueryResult result = WorldDatabase.Query("SELECT spellId, schoolMask, spellFamilyName, spellFamilyMask0, spellFamilyMask1, spellFamilyMask2, typeMask, spellTypeMask, spellPhaseMask, hitMask, attributesMask, ratePerMinute, chance, cooldown, charges FROM spell_proc");
@@ -644,10 +644,14 @@ public:
 
     // Spell proc event table
     SpellProcEventEntry const* GetSpellProcEvent(uint32 spellId) const;
+    // proc flags an aura of the spell procs on in Unit::ProcDamageAndSpellFor, 0 if it never does there
+    uint32 GetSpellProcEventFlags(SpellInfo const* spellInfo) const;
     bool IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellProcEvent, uint32 EventProcFlag, SpellInfo const* procSpell, uint32 procFlags, uint32 procExtra, bool active) const;
 
     // Spell proc table
     SpellProcEntry const* GetSpellProcEntry(uint32 spellId) const;
+    // raised every time spell_proc_event or spell_proc is loaded
+    uint32 GetProcLoadCount() const { return mProcLoadCount; }
     bool CanSpellTriggerProcOnEvent(SpellProcEntry const& procEntry, ProcEventInfo& eventInfo) const;
 
     // Spell bonus data table
@@ -725,6 +729,7 @@ private:
     SpellGroupStackMap         mSpellGroupStack;
     SpellProcEventMap          mSpellProcEventMap;
     SpellProcMap               mSpellProcMap;
+    uint32                     mProcLoadCount;
     SpellBonusMap              mSpellBonusMap;
     SpellThreatMap             mSpellThreatMap;
     SpellPetAuraMap            mSpellPetAuraMap;
@@ -0,0 +1,177 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include <algorithm>
+#include <thread>
+
+#include "DatabaseEnv.h"
+#include "Errors.h"
+#include "Log.h"
+#include "MySQLThreading.h"
+#include "StartupLoader.h"
+#include "Timer.h"
+
+void StartupLoader::Add(char const* name, std::initializer_list<char const*> dependencies, LoadFunction function)
+{
+    Task task;
+    task.Name = name;
+    task.Function = function;
+    task.Waiting = 0;
+    task.Start = 0;
+    task.Duration = 0;
+
+    uint32 index = uint32(_tasks.size());
+    for (char const* dependency : dependencies)
+    {
+        uint32 i = 0;
+        while (i < index && _tasks[i].Name != dependency)
+            ++i;
+
+        // a dependency that is not known (yet) would be a silent race
+        ASSERT(i < index);
+        task.Dependencies.push_back(i);
+        _tasks[i].Dependents.push_back(index);
+    }
+
+    _tasks.push_back(task);
+}
+
+void StartupLoader::AddBarrier(char const* name, LoadFunction function)
+{
+    Task task;
+    task.Name = name;
+    task.Function = function;
+    task.Waiting = 0;
+    task.Start = 0;
+    task.Duration = 0;
+
+    uint32 index = uint32(_tasks.size());
+    for (uint32 i = 0; i < index; ++i)
+    {
+        task.Dependencies.push_back(i);
+        _tasks[i].Dependents.push_back(index);
+    }
+
+    _tasks.push_back(task);
+}
+
+void StartupLoader::Run(uint32 threads)
+{
+    threads = std::max<uint32>(threads, 1);
+
+    _startTime = getMSTime();
+    _remaining = uint32(_tasks.size());
+    for (uint32 i = 0; i < _tasks.size(); ++i)
+    {
+        _tasks[i].Waiting = uint32(_tasks[i].Dependencies.size());
+        if (!_tasks[i].Waiting)
+            _ready.insert(i);
+    }
+
+    std::vector<std::thread> workers;
+    for (uint32 i = 1; i < threads; ++i)
+    {
+        workers.push_back(std::thread([this]()
+        {
+            MySQL::Thread_Init();
+            WorkerThread();
+            MySQL::Thread_End();
+        }));
+    }
+
+    WorkerThread();
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    Report(GetMSTimeDiffToNow(_startTime), threads);
+}
+
+void StartupLoader::WorkerThread()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    while (_remaining)
+    {
+        if (_ready.empty())
+        {
+            _taskDone.wait(guard);
+            continue;
+        }
+
+        uint32 index = *_ready.begin();
+        _ready.erase(_ready.begin());
+
+        // nothing else touches a task that is running
+        Task& task = _tasks[index];
+        guard.unlock();
+
+        task.Start = GetMSTimeDiffToNow(_startTime);
+        task.Function();
+        task.Duration = GetMSTimeDiffToNow(_startTime) - task.Start;
+
+        guard.lock();
+        --_remaining;
+        for (uint32 dependent : task.Dependents)
+            if (!--_tasks[dependent].Waiting)
+                _ready.insert(dependent);
+
+        _taskDone.notify_all();
+    }
+}
+
+void StartupLoader::Report(uint32 duration, uint32 threads) const
+{
+    uint32 total = 0;
+    uint32 last = 0;
+    for (uint32 i = 0; i < _tasks.size(); ++i)
+    {
+        total += _tasks[i].Duration;
+        if (_tasks[i].Start + _tasks[i].Duration > _tasks[last].Start + _tasks[last].Duration)
+            last = i;
+    }
+
+    SF_LOG_INFO("server.loading", ">> Ran %u startup loaders in %u ms on %u threads, %u ms one after the other",
+        uint32(_tasks.size()), duration, threads, total);
+
+    if (_tasks.empty())
+        return;
+
+    // walk back from the loader that finished last, always through the dependency that finished last
+    std::vector<uint32> criticalPath(1, last);
+    while (!_tasks[criticalPath.back()].Dependencies.empty())
+    {
+        std::vector<uint32> const& dependencies = _tasks[criticalPath.back()].Dependencies;
+        uint32 latest = dependencies.front();
+        for (uint32 dependency : dependencies)
+            if (_tasks[dependency].Start + _tasks[dependency].Duration > _tasks[latest].Start + _tasks[latest].Duration)
+                latest = dependency;
+
+        criticalPath.push_back(latest);
+    }
+
+    std::string path;
+    uint32 pathDuration = 0;
+    for (std::vector<uint32>::const_reverse_iterator itr = criticalPath.rbegin(); itr != criticalPath.rend(); ++itr)
+    {
+        if (!path.empty())
+            path += " -> ";
+
+        char step[128];
+        snprintf(step, sizeof(step), "%s (%u ms)", _tasks[*itr].Name.c_str(), _tasks[*itr].Duration);
+        path += step;
+        pathDuration += _tasks[*itr].Duration;
+    }
+
+    SF_LOG_INFO("server.loading", ">> Critical path, %u ms: %s", pathDuration, path.c_str());
+
+    std::vector<uint32> order;
+    for (uint32 i = 0; i < _tasks.size(); ++i)
+        order.push_back(i);
+
+    std::sort(order.begin(), order.end(), [this](uint32 left, uint32 right) { return _tasks[left].Duration > _tasks[right].Duration; });
+
+    for (uint32 index : order)
+        SF_LOG_INFO("server.loading", "   %-28s %6u ms, started at %u ms", _tasks[index].Name.c_str(), _tasks[index].Duration, _tasks[index].Start);
+}
@@ -0,0 +1,67 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef SF_STARTUP_LOADER_H
+#define SF_STARTUP_LOADER_H
+
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Define.h"
+
+/*
+ * Runs the loaders of the world startup as a graph of tasks.
+ *
+ * Every task names the tasks whose data it reads or changes, tasks that do
+ * not depend on each other run at the same time. The database queries of a
+ * thread take their own synchronous connection of the pool. With a single
+ * thread the tasks run in the order they were added, which is the order
+ * World::SetInitialWorldSettings always loaded them in.
+ */
+class StartupLoader
+{
+public:
+    typedef std::function<void()> LoadFunction;
+
+    StartupLoader() : _remaining(0), _startTime(0) { }
+
+    // dependencies must have been added before
+    void Add(char const* name, std::initializer_list<char const*> dependencies, LoadFunction function);
+    // adds a task that waits for every task added before it
+    void AddBarrier(char const* name, LoadFunction function);
+
+    // runs the tasks on the calling thread and threads - 1 more, returns when all are done
+    void Run(uint32 threads);
+
+private:
+    struct Task
+    {
+        std::string Name;
+        LoadFunction Function;
+        std::vector<uint32> Dependencies;
+        std::vector<uint32> Dependents;
+        uint32 Waiting;                                     // dependencies that are not done yet
+        uint32 Start;                                       // ms since Run was called
+        uint32 Duration;
+    };
+
+    void WorkerThread();
+    void Report(uint32 duration, uint32 threads) const;
+
+    std::vector<Task> _tasks;
+    std::set<uint32> _ready;                                // by index, the task that was added first goes first
+    uint32 _remaining;
+    uint32 _startTime;
+
+    std::mutex _lock;
+    std::condition_variable _taskDone;
+};
+
+#endif
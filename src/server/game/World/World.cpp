@@ -57,6 +57,7 @@
 #include "SkillExtraItems.h"
 #include "SmartAI.h"
 #include "SpellMgr.h"
+#include "StartupLoader.h"
 #include "SystemConfig.h"
 #include "TemporarySummon.h"
 #include "TicketMgr.h"
@@ -1203,10 +1204,15 @@ void World::LoadConfigSettings(bool reload)
         SF_LOG_INFO("server.loading", "Using DataDir %s", m_dataPath.c_str());
     }
 
+    SetBoolConfig(WorldBoolConfigs::CONFIG_WORLD_SNAPSHOTS, sConfigMgr->GetBoolDefault("WorldSnapshots", true));
+
+    SetBoolConfig(WorldBoolConfigs::CONFIG_MAP_FILE_MAPPING, sConfigMgr->GetBoolDefault("map.memoryMapped", false));
+
     SetBoolConfig(WorldBoolConfigs::CONFIG_ENABLE_MMAPS, sConfigMgr->GetBoolDefault("mmap.enablePathFinding", false));
     SF_LOG_INFO("server.loading", "WORLD: MMap data directory is: %smmaps", m_dataPath.c_str());
 
     SetBoolConfig(WorldBoolConfigs::CONFIG_VMAP_INDOOR_CHECK, sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", 0));
+    SetBoolConfig(WorldBoolConfigs::CONFIG_MAP_QUERY_CACHE, sConfigMgr->GetBoolDefault("vmap.queryCache", true));
     bool enableIndoor = sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", true);
     bool enableLOS = sConfigMgr->GetBoolDefault("vmap.enableLOS", true);
     bool enableHeight = sConfigMgr->GetBoolDefault("vmap.enableHeight", true);
@@ -1239,6 +1245,10 @@ void World::LoadConfigSettings(bool reload)
     setIntConfig(WorldIntConfigs::CONFIG_INTERVAL_LOG_UPDATE, sConfigMgr->GetIntDefault("RecordUpdateTimeDiffInterval", 60000));
     setIntConfig(WorldIntConfigs::CONFIG_MIN_LOG_UPDATE, sConfigMgr->GetIntDefault("MinRecordUpdateTimeDiff", 100));
     setIntConfig(WorldIntConfigs::CONFIG_NUMTHREADS, sConfigMgr->GetIntDefault("MapUpdate.Threads", 1));
+    setIntConfig(WorldIntConfigs::CONFIG_GRID_PREFETCH_THREADS, sConfigMgr->GetIntDefault("MapUpdate.Prefetch.Threads", 1));
+    setIntConfig(WorldIntConfigs::CONFIG_GRID_PREFETCH_LOOKAHEAD, sConfigMgr->GetIntDefault("MapUpdate.Prefetch.LookAhead", 20));
+    setIntConfig(WorldIntConfigs::CONFIG_PATHFINDING_THREADS, sConfigMgr->GetIntDefault("MapUpdate.Pathfinding.Threads", 1));
+    setIntConfig(WorldIntConfigs::CONFIG_STARTUP_LOAD_THREADS, sConfigMgr->GetIntDefault("Startup.LoadThreads", 4));
     setIntConfig(WorldIntConfigs::CONFIG_MAX_RESULTS_LOOKUP_COMMANDS, sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0));
 
     // chat logging
@@ -1414,435 +1424,609 @@ void World::SetInitialWorldSettings()
     stmt->setUInt32(0, 3 * DAY);
     CharacterDatabase.Execute(stmt);
 
-    ///- Load the DBC files
-    SF_LOG_INFO("server.loading", "Initialize data stores...");
-    LoadDBCStores(m_dataPath);
-    LoadDB2Stores(m_dataPath);
+    ///- Load the world data. Every loader names the ones whose data it reads or changes,
+    ///- the "must be after" rules are those dependencies and loaders without one between them run in parallel.
+    StartupLoader loader;
 
-    SF_LOG_INFO("server.loading", "Loading SpellInfo store...");
-    sSpellMgr->LoadSpellInfoStore();
+    loader.Add("dbc stores", { }, [this]()
+    {
+        SF_LOG_INFO("server.loading", "Initialize data stores...");
+        LoadDBCStores(m_dataPath);
+    });
 
-    SF_LOG_INFO("server.loading", "Loading SpellInfo corrections...");
-    sSpellMgr->LoadSpellInfoCorrections();
+    loader.Add("db2 stores", { "dbc stores" }, [this]()
+    {
+        LoadDB2Stores(m_dataPath);
+    });
 
-    SF_LOG_INFO("server.loading", "Loading SkillLineAbilityMultiMap Data...");
-    sSpellMgr->LoadSkillLineAbilityMap();
+    loader.Add("spell info", { "dbc stores", "db2 stores" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading SpellInfo store...");
+        sSpellMgr->LoadSpellInfoStore();
 
-    SF_LOG_INFO("server.loading", "Loading SpellInfo custom attributes...");
-    sSpellMgr->LoadSpellInfoCustomAttributes();
+        SF_LOG_INFO("server.loading", "Loading SpellInfo corrections...");
+        sSpellMgr->LoadSpellInfoCorrections();
 
-    SF_LOG_INFO("server.loading", "Loading GameObject models...");
-    LoadGameObjectModelList(m_dataPath);
+        SF_LOG_INFO("server.loading", "Loading SkillLineAbilityMultiMap Data...");
+        sSpellMgr->LoadSkillLineAbilityMap();
 
-    SF_LOG_INFO("server.loading", "Loading Script Names...");
-    sObjectMgr->LoadScriptNames();
+        SF_LOG_INFO("server.loading", "Loading SpellInfo custom attributes...");
+        sSpellMgr->LoadSpellInfoCustomAttributes();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Instance Template...");
-    sObjectMgr->LoadInstanceTemplate();
+    loader.Add("gameobject models", { }, [this]()
+    {
+        SF_LOG_INFO("server.loading", "Loading GameObject models...");
+        LoadGameObjectModelList(m_dataPath);
+    });
 
-    // Must be called before `creature_respawn`/`gameobject_respawn` tables
-    SF_LOG_INFO("server.loading", "Loading instances...");
-    sInstanceSaveMgr->LoadInstances();
+    loader.Add("script names", { }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Script Names...");
+        sObjectMgr->LoadScriptNames();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Localization strings...");
-    uint32 oldMSTime = getMSTime();
-    sObjectMgr->LoadCreatureLocales();
-    sObjectMgr->LoadGameObjectLocales();
-    sObjectMgr->LoadItemLocales();
-    sObjectMgr->LoadQuestLocales();
-    sObjectMgr->LoadNpcTextLocales();
-    sObjectMgr->LoadPageTextLocales();
-    sObjectMgr->LoadGossipMenuItemsLocales();
-    sObjectMgr->LoadPointOfInterestLocales();
+    loader.Add("instances", { "dbc stores", "script names" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Instance Template...");
+        sObjectMgr->LoadInstanceTemplate();
 
-    sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
-    SF_LOG_INFO("server.loading", ">> Localization strings loaded in %u ms", GetMSTimeDiffToNow(oldMSTime));
+        // Must be called before `creature_respawn`/`gameobject_respawn` tables
+        SF_LOG_INFO("server.loading", "Loading instances...");
+        sInstanceSaveMgr->LoadInstances();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Account Roles and Permissions...");
-    sAccountMgr->LoadRBAC();
+    loader.Add("locales", { }, [this]()
+    {
+        SF_LOG_INFO("server.loading", "Loading Localization strings...");
+        uint32 oldMSTime = getMSTime();
+        sObjectMgr->LoadCreatureLocales();
+        sObjectMgr->LoadGameObjectLocales();
+        sObjectMgr->LoadItemLocales();
+        sObjectMgr->LoadQuestLocales();
+        sObjectMgr->LoadNpcTextLocales();
+        sObjectMgr->LoadPageTextLocales();
+        sObjectMgr->LoadGossipMenuItemsLocales();
+        sObjectMgr->LoadPointOfInterestLocales();
 
-    SF_LOG_INFO("server.loading", "Loading Page Texts...");
-    sObjectMgr->LoadPageTexts();
+        sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
+        SF_LOG_INFO("server.loading", ">> Localization strings loaded in %u ms", GetMSTimeDiffToNow(oldMSTime));
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Game Object Templates...");         // must be after LoadPageTexts
-    sObjectMgr->LoadGameObjectTemplate();
+    loader.Add("rbac", { }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Account Roles and Permissions...");
+        sAccountMgr->LoadRBAC();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Transport templates...");
-    sTransportMgr->LoadTransportTemplates();
+    loader.Add("page texts", { }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Page Texts...");
+        sObjectMgr->LoadPageTexts();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Spell Rank Data...");
-    sSpellMgr->LoadSpellRanks();
+    loader.Add("gameobject templates", { "dbc stores", "spell info", "script names", "page texts" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Game Object Templates...");         // must be after LoadPageTexts
+        sObjectMgr->LoadGameObjectTemplate();
 
-    SF_LOG_INFO("server.loading", "Loading Spell Required Data...");
-    sSpellMgr->LoadSpellRequired();
+        SF_LOG_INFO("server.loading", "Loading Transport templates...");
+        sTransportMgr->LoadTransportTemplates();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Spell Group types...");
-    sSpellMgr->LoadSpellGroups();
+    loader.Add("spell data", { "spell info" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Spell Rank Data...");
+        sSpellMgr->LoadSpellRanks();
 
-    SF_LOG_INFO("server.loading", "Loading Spell Learn Skills...");
-    sSpellMgr->LoadSpellLearnSkills();                           // must be after LoadSpellRanks
+        SF_LOG_INFO("server.loading", "Loading Spell Required Data...");
+        sSpellMgr->LoadSpellRequired();
 
-    SF_LOG_INFO("server.loading", "Loading Spell Learn Spells...");
-    sSpellMgr->LoadSpellLearnSpells();
+        SF_LOG_INFO("server.loading", "Loading Spell Group types...");
+        sSpellMgr->LoadSpellGroups();
 
-    SF_LOG_INFO("server.loading", "Loading Spell Proc Event conditions...");
-    sSpellMgr->LoadSpellProcEvents();
+        SF_LOG_INFO("server.loading", "Loading Spell Learn Skills...");
+        sSpellMgr->LoadSpellLearnSkills();                           // must be after LoadSpellRanks
 
-    SF_LOG_INFO("server.loading", "Loading Spell Proc conditions and data...");
-    sSpellMgr->LoadSpellProcs();
+        SF_LOG_INFO("server.loading", "Loading Spell Learn Spells...");
+        sSpellMgr->LoadSpellLearnSpells();
 
-    SF_LOG_INFO("server.loading", "Loading Spell Bonus Data...");
-    sSpellMgr->LoadSpellBonusess();
+        SF_LOG_INFO("server.loading", "Loading Spell Proc Event conditions...");
+        sSpellMgr->LoadSpellProcEvents();
 
-    SF_LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
-    sSpellMgr->LoadSpellThreats();
+        SF_LOG_INFO("server.loading", "Loading Spell Proc conditions and data...");
+        sSpellMgr->LoadSpellProcs();
 
-    SF_LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
-    sSpellMgr->LoadSpellGroupStackRules();
+        SF_LOG_INFO("server.loading", "Loading Spell Bonus Data...");
+        sSpellMgr->LoadSpellBonusess();
 
-    SF_LOG_INFO("server.loading", "Loading NPC Texts...");
-    sObjectMgr->LoadGossipText();
+        SF_LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
+        sSpellMgr->LoadSpellThreats();
 
-    SF_LOG_INFO("server.loading", "Loading Enchant Spells Proc datas...");
-    sSpellMgr->LoadSpellEnchantProcData();
+        SF_LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
+        sSpellMgr->LoadSpellGroupStackRules();
 
-    SF_LOG_INFO("server.loading", "Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
+        SF_LOG_INFO("server.loading", "Loading Enchant Spells Proc datas...");
+        sSpellMgr->LoadSpellEnchantProcData();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Disables");                         // must be before loading quests and items
-    DisableMgr::LoadDisables();
+    loader.Add("npc texts", { }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading NPC Texts...");
+        sObjectMgr->LoadGossipText();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Items...");                         // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr->LoadItemTemplates();
+    loader.Add("items", { "dbc stores", "db2 stores", "spell info", "script names", "page texts" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Item Random Enchantments Table...");
+        LoadRandomEnchantmentsTable();
 
-    SF_LOG_INFO("server.loading", "Loading Item set names...");                // must be after LoadItemPrototypes
-    sObjectMgr->LoadItemTemplateAddon();
+        SF_LOG_INFO("server.loading", "Loading Disables");                         // must be before loading quests and items
+        DisableMgr::LoadDisables();
 
-    SF_LOG_INFO("misc", "Loading Item Scripts...");                 // must be after LoadItemPrototypes
-    sObjectMgr->LoadItemScriptNames();
+        SF_LOG_INFO("server.loading", "Loading Items...");                         // must be after LoadRandomEnchantmentsTable and LoadPageTexts
+        sObjectMgr->LoadItemTemplates();
 
-    SF_LOG_INFO("server.loading", "Loading Creature Model Based Info Data...");
-    sObjectMgr->LoadCreatureModelInfo();
+        SF_LOG_INFO("server.loading", "Loading Item set names...");                // must be after LoadItemPrototypes
+        sObjectMgr->LoadItemTemplateAddon();
 
-    SF_LOG_INFO("server.loading", "Loading Creature templates...");
-    sObjectMgr->LoadCreatureTemplates();
+        SF_LOG_INFO("misc", "Loading Item Scripts...");                 // must be after LoadItemPrototypes
+        sObjectMgr->LoadItemScriptNames();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Equipment templates...");           // must be after LoadCreatureTemplates
-    sObjectMgr->LoadEquipmentTemplates();
+    loader.Add("creature templates", { "dbc stores", "spell info", "script names", "items" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Creature Model Based Info Data...");
+        sObjectMgr->LoadCreatureModelInfo();
 
-    SF_LOG_INFO("server.loading", "Loading Creature template addons...");
-    sObjectMgr->LoadCreatureTemplateAddons();
+        SF_LOG_INFO("server.loading", "Loading Creature templates...");
+        sObjectMgr->LoadCreatureTemplates();
 
-    SF_LOG_INFO("server.loading", "Loading Reputation Reward Rates...");
-    sObjectMgr->LoadReputationRewardRate();
+        SF_LOG_INFO("server.loading", "Loading Equipment templates...");           // must be after LoadCreatureTemplates
+        sObjectMgr->LoadEquipmentTemplates();
 
-    SF_LOG_INFO("server.loading", "Loading Creature Reputation OnKill Data...");
-    sObjectMgr->LoadReputationOnKill();
+        SF_LOG_INFO("server.loading", "Loading Creature template addons...");
+        sObjectMgr->LoadCreatureTemplateAddons();
 
-    SF_LOG_INFO("server.loading", "Loading Reputation Spillover Data...");
-    sObjectMgr->LoadReputationSpilloverTemplate();
+        SF_LOG_INFO("server.loading", "Loading Reputation Reward Rates...");
+        sObjectMgr->LoadReputationRewardRate();
 
-    SF_LOG_INFO("server.loading", "Loading Points Of Interest Data...");
-    sObjectMgr->LoadPointsOfInterest();
+        SF_LOG_INFO("server.loading", "Loading Creature Reputation OnKill Data...");
+        sObjectMgr->LoadReputationOnKill();
 
-    SF_LOG_INFO("server.loading", "Loading Creature Base Stats...");
-    sObjectMgr->LoadCreatureClassLevelStats();
+        SF_LOG_INFO("server.loading", "Loading Reputation Spillover Data...");
+        sObjectMgr->LoadReputationSpilloverTemplate();
 
-    SF_LOG_INFO("server.loading", "Loading Creature Data...");
-    sObjectMgr->LoadCreatures();
+        SF_LOG_INFO("server.loading", "Loading Creature Base Stats...");
+        sObjectMgr->LoadCreatureClassLevelStats();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Temporary Summon Data...");
-    sObjectMgr->LoadTempSummons();                               // must be after LoadCreatureTemplates() and LoadGameObjectTemplates()
+    loader.Add("points of interest", { }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Points Of Interest Data...");
+        sObjectMgr->LoadPointsOfInterest();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading pet levelup spells...");
-    sSpellMgr->LoadPetLevelupSpellMap();
+    // creatures, gameobjects and corpses share the grid cell store
+    loader.Add("spawns", { "instances", "gameobject templates", "spell data", "creature templates" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Creature Data...");
+        sObjectMgr->LoadCreatures();
 
-    SF_LOG_INFO("server.loading", "Loading pet default spells additional to levelup spells...");
-    sSpellMgr->LoadPetDefaultSpells();
+        SF_LOG_INFO("server.loading", "Loading Temporary Summon Data...");
+        sObjectMgr->LoadTempSummons();                               // must be after LoadCreatureTemplates() and LoadGameObjectTemplates()
 
-    SF_LOG_INFO("server.loading", "Loading Creature Addon Data...");
-    sObjectMgr->LoadCreatureAddons();                            // must be after LoadCreatureTemplates() and LoadCreatures()
+        SF_LOG_INFO("server.loading", "Loading pet levelup spells...");
+        sSpellMgr->LoadPetLevelupSpellMap();
 
-    SF_LOG_INFO("server.loading", "Loading Gameobject Data...");
-    sObjectMgr->LoadGameobjects();
+        SF_LOG_INFO("server.loading", "Loading pet default spells additional to levelup spells...");
+        sSpellMgr->LoadPetDefaultSpells();
 
-    SF_LOG_INFO("server.loading", "Loading Creature Linked Respawn...");
-    sObjectMgr->LoadLinkedRespawn();                             // must be after LoadCreatures(), LoadGameObjects()
+        SF_LOG_INFO("server.loading", "Loading Creature Addon Data...");
+        sObjectMgr->LoadCreatureAddons();                            // must be after LoadCreatureTemplates() and LoadCreatures()
 
-    SF_LOG_INFO("server.loading", "Loading Weather Data...");
-    WeatherMgr::LoadWeatherData();
+        SF_LOG_INFO("server.loading", "Loading Gameobject Data...");
+        sObjectMgr->LoadGameobjects();
 
-    SF_LOG_INFO("server.loading", "Loading SceneTemplate Data..");
-    sObjectMgr->LoadSceneTemplates();
+        SF_LOG_INFO("server.loading", "Loading Creature Linked Respawn...");
+        sObjectMgr->LoadLinkedRespawn();                             // must be after LoadCreatures(), LoadGameObjects()
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Quests...");
-    sObjectMgr->LoadQuests();                                    // must be loaded after DBCs, creature_template, item_template, gameobject tables
+    loader.Add("world misc", { "dbc stores", "script names" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Weather Data...");
+        WeatherMgr::LoadWeatherData();
 
-    SF_LOG_INFO("server.loading", "Checking Quest Disables");
-    DisableMgr::CheckQuestDisables();                           // must be after loading quests
+        SF_LOG_INFO("server.loading", "Loading SceneTemplate Data..");
+        sObjectMgr->LoadSceneTemplates();
 
-    SF_LOG_INFO("server.loading", "Loading Quest Objectives...");
-    sObjectMgr->LoadQuestObjectives();
+        SF_LOG_INFO("server.loading", "Loading Exploration BaseXP Data...");
+        sObjectMgr->LoadExplorationBaseXP();
 
-    SF_LOG_INFO("server.loading", "Loading Quest Objective Locales...");
-    sObjectMgr->LoadQuestObjectiveLocales();
+        SF_LOG_INFO("server.loading", "Loading Pet Name Parts...");
+        sObjectMgr->LoadPetNames();
 
-    SF_LOG_INFO("server.loading", "Loading Quest Objective Visual Effects...");
-    sObjectMgr->LoadQuestObjectiveVisualEffects();
+        SF_LOG_INFO("server.loading", "Loading ReservedNames...");
+        sObjectMgr->LoadReservedPlayersNames();
 
-    SF_LOG_INFO("server.loading", "Loading Quest POI");
-    sObjectMgr->LoadQuestPOI();
+        SF_LOG_INFO("server.loading", "Loading GameTeleports...");
+        sObjectMgr->LoadGameTele();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Quests Starters and Enders...");
-    sObjectMgr->LoadQuestStartersAndEnders();                    // must be after quest load
+    loader.Add("quests", { "items", "spell data", "spawns" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Quests...");
+        sObjectMgr->LoadQuests();                                    // must be loaded after DBCs, creature_template, item_template, gameobject tables
 
-    SF_LOG_INFO("server.loading", "Loading Objects Pooling Data...");
-    sPoolMgr->LoadFromDB();
+        SF_LOG_INFO("server.loading", "Checking Quest Disables");
+        DisableMgr::CheckQuestDisables();                           // must be after loading quests
 
-    SF_LOG_INFO("server.loading", "Loading Game Event Data...");               // must be after loading pools fully
-    sGameEventMgr->LoadFromDB();
+        SF_LOG_INFO("server.loading", "Loading Quest Objectives...");
+        sObjectMgr->LoadQuestObjectives();
 
-    SF_LOG_INFO("server.loading", "Loading UNIT_NPC_FLAG_SPELLCLICK Data..."); // must be after LoadQuests
-    sObjectMgr->LoadNPCSpellClickSpells();
+        SF_LOG_INFO("server.loading", "Loading Quest Objective Locales...");
+        sObjectMgr->LoadQuestObjectiveLocales();
 
-    SF_LOG_INFO("server.loading", "Loading Vehicle Template Accessories...");
-    sObjectMgr->LoadVehicleTemplateAccessories();                // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
+        SF_LOG_INFO("server.loading", "Loading Quest Objective Visual Effects...");
+        sObjectMgr->LoadQuestObjectiveVisualEffects();
 
-    SF_LOG_INFO("server.loading", "Loading Vehicle Accessories...");
-    sObjectMgr->LoadVehicleAccessories();                       // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
+        SF_LOG_INFO("server.loading", "Loading Quest POI");
+        sObjectMgr->LoadQuestPOI();
 
-    SF_LOG_INFO("server.loading", "Loading SpellArea Data...");                // must be after quest load
-    sSpellMgr->LoadSpellAreas();
+        SF_LOG_INFO("server.loading", "Loading Quests Starters and Enders...");
+        sObjectMgr->LoadQuestStartersAndEnders();                    // must be after quest load
+    });
 
-    SF_LOG_INFO("server.loading", "Loading AreaTrigger definitions...");
-    sObjectMgr->LoadAreaTriggerTeleports();
+    loader.Add("pools and events", { "quests" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Objects Pooling Data...");
+        sPoolMgr->LoadFromDB();
 
-    SF_LOG_INFO("server.loading", "Loading Access Requirements...");
-    sObjectMgr->LoadAccessRequirements();                        // must be after item template load
+        SF_LOG_INFO("server.loading", "Loading Game Event Data...");               // must be after loading pools fully
+        sGameEventMgr->LoadFromDB();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Quest Area Triggers...");
-    sObjectMgr->LoadQuestAreaTriggers();                         // must be after LoadQuests
+    // clears UNIT_NPC_FLAG_SPELLCLICK of creature templates, loaders checking npcflag go before or after it
+    loader.Add("spell clicks", { "quests", "pools and events" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading UNIT_NPC_FLAG_SPELLCLICK Data..."); // must be after LoadQuests
+        sObjectMgr->LoadNPCSpellClickSpells();
 
-    SF_LOG_INFO("server.loading", "Loading Tavern Area Triggers...");
-    sObjectMgr->LoadTavernAreaTriggers();
+        SF_LOG_INFO("server.loading", "Loading Vehicle Template Accessories...");
+        sObjectMgr->LoadVehicleTemplateAccessories();                // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
 
-    SF_LOG_INFO("server.loading", "Loading AreaTrigger script names...");
-    sObjectMgr->LoadAreaTriggerScripts();
+        SF_LOG_INFO("server.loading", "Loading Vehicle Accessories...");
+        sObjectMgr->LoadVehicleAccessories();                       // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
+    });
 
-    SF_LOG_INFO("server.loading", "Loading LFG entrance positions..."); // Must be after areatriggers
-    sLFGMgr->LoadLFGDungeons();
+    // changes spell attributes, every loader reading spells is either before it or after it
+    loader.Add("spell areas", { "spell data", "quests", "spell clicks" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading SpellArea Data...");                // must be after quest load
+        sSpellMgr->LoadSpellAreas();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Dungeon boss data...");
-    sObjectMgr->LoadInstanceEncounters();
+    loader.Add("area triggers", { "items", "quests", "script names" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading AreaTrigger definitions...");
+        sObjectMgr->LoadAreaTriggerTeleports();
 
-    SF_LOG_INFO("server.loading", "Loading LFG rewards...");
-    sLFGMgr->LoadRewards();
+        SF_LOG_INFO("server.loading", "Loading Access Requirements...");
+        sObjectMgr->LoadAccessRequirements();                        // must be after item template load
 
-    SF_LOG_INFO("server.loading", "Loading Graveyard-zone links...");
-    sObjectMgr->LoadGraveyardZones();
+        SF_LOG_INFO("server.loading", "Loading Quest Area Triggers...");
+        sObjectMgr->LoadQuestAreaTriggers();                         // must be after LoadQuests
 
-    SF_LOG_INFO("server.loading", "Loading Graveyard Orientations...");
-    sObjectMgr->LoadGraveyardOrientations();
+        SF_LOG_INFO("server.loading", "Loading Tavern Area Triggers...");
+        sObjectMgr->LoadTavernAreaTriggers();
 
-    SF_LOG_INFO("server.loading", "Loading spell pet auras...");
-    sSpellMgr->LoadSpellPetAuras();
+        SF_LOG_INFO("server.loading", "Loading AreaTrigger script names...");
+        sObjectMgr->LoadAreaTriggerScripts();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Spell target coordinates...");
-    sSpellMgr->LoadSpellTargetPositions();
+    loader.Add("lfg", { "creature templates", "area triggers" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading LFG entrance positions..."); // Must be after areatriggers
+        sLFGMgr->LoadLFGDungeons();
 
-    SF_LOG_INFO("server.loading", "Loading enchant custom attributes...");
-    sSpellMgr->LoadEnchantCustomAttr();
+        SF_LOG_INFO("server.loading", "Loading Dungeon boss data...");
+        sObjectMgr->LoadInstanceEncounters();
 
-    SF_LOG_INFO("server.loading", "Loading linked spells...");
-    sSpellMgr->LoadSpellLinked();
+        SF_LOG_INFO("server.loading", "Loading LFG rewards...");
+        sLFGMgr->LoadRewards();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Player Create Data...");
-    sObjectMgr->LoadPlayerInfo();
+    loader.Add("graveyards", { "dbc stores" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Graveyard-zone links...");
+        sObjectMgr->LoadGraveyardZones();
 
-    SF_LOG_INFO("server.loading", "Loading Exploration BaseXP Data...");
-    sObjectMgr->LoadExplorationBaseXP();
+        SF_LOG_INFO("server.loading", "Loading Graveyard Orientations...");
+        sObjectMgr->LoadGraveyardOrientations();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Pet Name Parts...");
-    sObjectMgr->LoadPetNames();
+    loader.Add("spell extras", { "creature templates", "spell areas" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading spell pet auras...");
+        sSpellMgr->LoadSpellPetAuras();
 
-    CharacterDatabaseCleaner::CleanDatabase();
+        SF_LOG_INFO("server.loading", "Loading Spell target coordinates...");
+        sSpellMgr->LoadSpellTargetPositions();
 
-    SF_LOG_INFO("server.loading", "Loading the max pet number...");
-    sObjectMgr->LoadPetNumber();
+        SF_LOG_INFO("server.loading", "Loading enchant custom attributes...");
+        sSpellMgr->LoadEnchantCustomAttr();
 
-    SF_LOG_INFO("server.loading", "Loading pet level stats...");
-    sObjectMgr->LoadPetLevelInfo();
+        SF_LOG_INFO("server.loading", "Loading linked spells...");
+        sSpellMgr->LoadSpellLinked();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Player Corpses...");
-    sObjectMgr->LoadCorpses();
+    loader.Add("player create data", { "items", "spell areas" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Player Create Data...");
+        sObjectMgr->LoadPlayerInfo();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Player level dependent mail rewards...");
-    sObjectMgr->LoadMailLevelRewards();
+    // every loader of the characters database goes after it
+    loader.Add("character cleanup", { "dbc stores", "spell areas" }, []()
+    {
+        CharacterDatabaseCleaner::CleanDatabase();
+    });
 
-    // Loot tables
-    LoadLootTables();
+    loader.Add("pets", { "creature templates", "character cleanup" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading the max pet number...");
+        sObjectMgr->LoadPetNumber();
 
-    SF_LOG_INFO("server.loading", "Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
+        SF_LOG_INFO("server.loading", "Loading pet level stats...");
+        sObjectMgr->LoadPetLevelInfo();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
+    loader.Add("corpses", { "spawns", "character cleanup" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Player Corpses...");
+        sObjectMgr->LoadCorpses();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Skill Fishing base level requirements...");
-    sObjectMgr->LoadFishingBaseSkillLevel();
+    loader.Add("mail level rewards", { "creature templates" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Player level dependent mail rewards...");
+        sObjectMgr->LoadMailLevelRewards();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Achievements...");
-    sAchievementMgr->LoadAchievementReferenceList();
-    SF_LOG_INFO("server.loading", "Loading Achievement Criteria Lists...");
-    sAchievementMgr->LoadAchievementCriteriaList();
-    SF_LOG_INFO("server.loading", "Loading Achievement Criteria Data...");
-    sAchievementMgr->LoadAchievementCriteriaData();
-    SF_LOG_INFO("server.loading", "Loading Achievement Rewards...");
-    sAchievementMgr->LoadRewards();
-    SF_LOG_INFO("server.loading", "Loading Achievement Reward Locales...");
-    sAchievementMgr->LoadRewardLocales();
-    SF_LOG_INFO("server.loading", "Loading Completed Achievements...");
-    sAchievementMgr->LoadCompletedAchievements();
+    loader.Add("loot", { "items", "creature templates", "gameobject templates", "quests", "spell areas" }, []()
+    {
+        // Loot tables
+        LoadLootTables();
+    });
 
-    // Delete expired auctions before loading
-    SF_LOG_INFO("server.loading", "Deleting expired auctions...");
-    sAuctionMgr->DeleteExpiredAuctionsAtStartup();
+    loader.Add("skills", { "spell areas" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Skill Discovery Table...");
+        LoadSkillDiscoveryTable();
 
-    ///- Load dynamic data tables from the database
-    SF_LOG_INFO("server.loading", "Loading Item Auctions...");
-    sAuctionMgr->LoadAuctionItems();
+        SF_LOG_INFO("server.loading", "Loading Skill Extra Item Table...");
+        LoadSkillExtraItemTable();
 
-    SF_LOG_INFO("server.loading", "Loading Auctions...");
-    sAuctionMgr->LoadAuctions();
+        SF_LOG_INFO("server.loading", "Loading Skill Fishing base level requirements...");
+        sObjectMgr->LoadFishingBaseSkillLevel();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Guild XP for level...");
-    sGuildMgr->LoadGuildXpForLevel();
+    loader.Add("achievements", { "script names", "items", "creature templates", "quests", "spell areas", "character cleanup" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Achievements...");
+        sAchievementMgr->LoadAchievementReferenceList();
+        SF_LOG_INFO("server.loading", "Loading Achievement Criteria Lists...");
+        sAchievementMgr->LoadAchievementCriteriaList();
+        SF_LOG_INFO("server.loading", "Loading Achievement Criteria Data...");
+        sAchievementMgr->LoadAchievementCriteriaData();
+        SF_LOG_INFO("server.loading", "Loading Achievement Rewards...");
+        sAchievementMgr->LoadRewards();
+        SF_LOG_INFO("server.loading", "Loading Achievement Reward Locales...");
+        sAchievementMgr->LoadRewardLocales();
+        SF_LOG_INFO("server.loading", "Loading Completed Achievements...");
+        sAchievementMgr->LoadCompletedAchievements();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Guild rewards...");
-    sGuildMgr->LoadGuildRewards();
+    loader.Add("auctions", { "items", "character cleanup" }, []()
+    {
+        // Delete expired auctions before loading
+        SF_LOG_INFO("server.loading", "Deleting expired auctions...");
+        sAuctionMgr->DeleteExpiredAuctionsAtStartup();
 
-    SF_LOG_INFO("server.loading", "Loading Guilds...");
-    sGuildMgr->LoadGuilds();
+        ///- Load dynamic data tables from the database
+        SF_LOG_INFO("server.loading", "Loading Item Auctions...");
+        sAuctionMgr->LoadAuctionItems();
 
-    sGuildFinderMgr->LoadFromDB();
+        SF_LOG_INFO("server.loading", "Loading Auctions...");
+        sAuctionMgr->LoadAuctions();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Groups...");
-    sGroupMgr->LoadGroups();
+    // guild bank items are created after the auction items, not next to them
+    loader.Add("guilds", { "achievements", "auctions" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Guild XP for level...");
+        sGuildMgr->LoadGuildXpForLevel();
 
-    SF_LOG_INFO("server.loading", "Loading ReservedNames...");
-    sObjectMgr->LoadReservedPlayersNames();
+        SF_LOG_INFO("server.loading", "Loading Guild rewards...");
+        sGuildMgr->LoadGuildRewards();
 
-    SF_LOG_INFO("server.loading", "Loading GameObjects for quests...");
-    sObjectMgr->LoadGameObjectForQuests();
+        SF_LOG_INFO("server.loading", "Loading Guilds...");
+        sGuildMgr->LoadGuilds();
 
-    SF_LOG_INFO("server.loading", "Loading BattleMasters...");
-    sBattlegroundMgr->LoadBattleMastersEntry();
+        sGuildFinderMgr->LoadFromDB();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading GameTeleports...");
-    sObjectMgr->LoadGameTele();
+    loader.Add("groups", { "instances", "character cleanup" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Groups...");
+        sGroupMgr->LoadGroups();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Gossip menu...");
-    sObjectMgr->LoadGossipMenu();
+    loader.Add("gameobjects for quests", { "gameobject templates", "quests", "loot" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading GameObjects for quests...");
+        sObjectMgr->LoadGameObjectForQuests();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Gossip menu options...");
-    sObjectMgr->LoadGossipMenuItems();
+    loader.Add("battlemasters", { "creature templates" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading BattleMasters...");
+        sBattlegroundMgr->LoadBattleMastersEntry();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Vendors...");
-    sObjectMgr->LoadVendors();                                   // must be after load CreatureTemplate and ItemTemplate
+    loader.Add("gossip", { "npc texts", "points of interest" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Gossip menu...");
+        sObjectMgr->LoadGossipMenu();
 
-    SF_LOG_INFO("server.loading", "Loading Trainers...");
-    sObjectMgr->LoadTrainerSpell();                              // must be after load CreatureTemplate
+        SF_LOG_INFO("server.loading", "Loading Gossip menu options...");
+        sObjectMgr->LoadGossipMenuItems();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Waypoints...");
-    sWaypointMgr->Load();
+    loader.Add("vendors and trainers", { "creature templates", "items", "spell areas" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Vendors...");
+        sObjectMgr->LoadVendors();                                   // must be after load CreatureTemplate and ItemTemplate
+
+        SF_LOG_INFO("server.loading", "Loading Trainers...");
+        sObjectMgr->LoadTrainerSpell();                              // must be after load CreatureTemplate
+    });
+
+    loader.Add("waypoints", { "spawns" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Waypoints...");
+        sWaypointMgr->Load();
 
-    SF_LOG_INFO("server.loading", "Loading SmartAI Waypoints...");
-    sSmartWaypointMgr->LoadFromDB();
+        SF_LOG_INFO("server.loading", "Loading SmartAI Waypoints...");
+        sSmartWaypointMgr->LoadFromDB();
 
-    SF_LOG_INFO("server.loading", "Loading Creature Formations...");
-    sFormationMgr->LoadCreatureFormations();
+        SF_LOG_INFO("server.loading", "Loading Creature Formations...");
+        sFormationMgr->LoadCreatureFormations();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading World States...");              // must be loaded before battleground, outdoor PvP and conditions
-    LoadWorldStates();
+    loader.Add("world states", { }, [this]()
+    {
+        SF_LOG_INFO("server.loading", "Loading World States...");              // must be loaded before battleground, outdoor PvP and conditions
+        LoadWorldStates();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Terrain Phase definitions...");
-    sObjectMgr->LoadTerrainPhaseInfo();
+    loader.Add("terrain phases", { "dbc stores" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Terrain Phase definitions...");
+        sObjectMgr->LoadTerrainPhaseInfo();
 
-    SF_LOG_INFO("server.loading", "Loading Terrain Swap Default definitions...");
-    sObjectMgr->LoadTerrainSwapDefaults();
+        SF_LOG_INFO("server.loading", "Loading Terrain Swap Default definitions...");
+        sObjectMgr->LoadTerrainSwapDefaults();
 
-    SF_LOG_INFO("server.loading", "Loading Terrain World Map definitions...");
-    sObjectMgr->LoadTerrainWorldMaps();
+        SF_LOG_INFO("server.loading", "Loading Terrain World Map definitions...");
+        sObjectMgr->LoadTerrainWorldMaps();
 
-    SF_LOG_INFO("server.loading", "Loading Phase Area definitions...");
-    sObjectMgr->LoadAreaPhases();
+        SF_LOG_INFO("server.loading", "Loading Phase Area definitions...");
+        sObjectMgr->LoadAreaPhases();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Conditions...");
-    sConditionMgr->LoadConditions();
+    // attaches conditions to loot, gossip, vendors, spell clicks and spells
+    loader.Add("conditions", { "loot", "gossip", "vendors and trainers", "spell extras", "area triggers", "achievements",
+        "gameobjects for quests", "world states", "terrain phases" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Conditions...");
+        sConditionMgr->LoadConditions();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading faction change achievement pairs...");
-    sObjectMgr->LoadFactionChangeAchievements();
+    loader.Add("faction change pairs", { "items", "spell areas" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading faction change achievement pairs...");
+        sObjectMgr->LoadFactionChangeAchievements();
 
-    SF_LOG_INFO("server.loading", "Loading faction change spell pairs...");
-    sObjectMgr->LoadFactionChangeSpells();
+        SF_LOG_INFO("server.loading", "Loading faction change spell pairs...");
+        sObjectMgr->LoadFactionChangeSpells();
 
-    SF_LOG_INFO("server.loading", "Loading faction change item pairs...");
-    sObjectMgr->LoadFactionChangeItems();
+        SF_LOG_INFO("server.loading", "Loading faction change item pairs...");
+        sObjectMgr->LoadFactionChangeItems();
 
-    SF_LOG_INFO("server.loading", "Loading faction change reputation pairs...");
-    sObjectMgr->LoadFactionChangeReputations();
+        SF_LOG_INFO("server.loading", "Loading faction change reputation pairs...");
+        sObjectMgr->LoadFactionChangeReputations();
 
-    SF_LOG_INFO("server.loading", "Loading faction change title pairs...");
-    sObjectMgr->LoadFactionChangeTitles();
+        SF_LOG_INFO("server.loading", "Loading faction change title pairs...");
+        sObjectMgr->LoadFactionChangeTitles();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading GM tickets...");
-    sTicketMgr->LoadGmTickets();
+    loader.Add("tickets", { "character cleanup" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading GM tickets...");
+        sTicketMgr->LoadGmTickets();
 
-    SF_LOG_INFO("server.loading", "Loading Support bugs tickets...");
-    sTicketMgr->LoadBugTickets();
+        SF_LOG_INFO("server.loading", "Loading Support bugs tickets...");
+        sTicketMgr->LoadBugTickets();
 
-    SF_LOG_INFO("server.loading", "Loading Support suggest tickets...");
-    sTicketMgr->LoadSuggestTickets();
+        SF_LOG_INFO("server.loading", "Loading Support suggest tickets...");
+        sTicketMgr->LoadSuggestTickets();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading client addons...");
-    AddonMgr::LoadFromDB();
+    loader.Add("addons", { "character cleanup" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading client addons...");
+        AddonMgr::LoadFromDB();
+    });
 
-    ///- Handle outdated emails (delete/return)
-    SF_LOG_INFO("server.loading", "Returning old mails...");
-    sObjectMgr->ReturnOrDeleteOldMails(false);
+    loader.Add("old mails", { "items", "guilds" }, []()
+    {
+        ///- Handle outdated emails (delete/return)
+        SF_LOG_INFO("server.loading", "Returning old mails...");
+        sObjectMgr->ReturnOrDeleteOldMails(false);
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Autobroadcasts...");
-    LoadAutobroadcasts();
+    loader.Add("autobroadcasts", { }, [this]()
+    {
+        SF_LOG_INFO("server.loading", "Loading Autobroadcasts...");
+        LoadAutobroadcasts();
+    });
 
-    ///- Load and initialize scripts
-    sObjectMgr->LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    sObjectMgr->LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    sObjectMgr->LoadWaypointScripts();
+    loader.Add("db scripts", { "script names", "spawns", "spell areas", "area triggers" }, []()
+    {
+        ///- Load and initialize scripts
+        sObjectMgr->LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
+        sObjectMgr->LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
+        sObjectMgr->LoadWaypointScripts();
 
-    SF_LOG_INFO("server.loading", "Loading Scripts text locales...");      // must be after Load*Scripts calls
-    sObjectMgr->LoadDbScriptStrings();
+        SF_LOG_INFO("server.loading", "Loading Scripts text locales...");      // must be after Load*Scripts calls
+        sObjectMgr->LoadDbScriptStrings();
 
-    SF_LOG_INFO("server.loading", "Loading spell script names...");
-    sObjectMgr->LoadSpellScriptNames();
+        SF_LOG_INFO("server.loading", "Loading spell script names...");
+        sObjectMgr->LoadSpellScriptNames();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Creature Texts...");
-    sCreatureTextMgr->LoadCreatureTexts();
+    loader.Add("creature texts", { "creature templates" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Creature Texts...");
+        sCreatureTextMgr->LoadCreatureTexts();
 
-    SF_LOG_INFO("server.loading", "Loading Creature Text Locales...");
-    sCreatureTextMgr->LoadCreatureTextLocales();
+        SF_LOG_INFO("server.loading", "Loading Creature Text Locales...");
+        sCreatureTextMgr->LoadCreatureTextLocales();
+    });
 
-    SF_LOG_INFO("server.loading", "Initializing Scripts...");
-    sScriptMgr->Initialize();
-    sScriptMgr->OnConfigLoad(false);                                // must be done after the ScriptMgr has been properly initialized
+    // scripts may look at anything loaded so far
+    loader.AddBarrier("scripts", []()
+    {
+        SF_LOG_INFO("server.loading", "Initializing Scripts...");
+        sScriptMgr->Initialize();
+        sScriptMgr->OnConfigLoad(false);                                // must be done after the ScriptMgr has been properly initialized
 
-    SF_LOG_INFO("server.loading", "Validating spell scripts...");
-    sObjectMgr->ValidateSpellScripts();
+        SF_LOG_INFO("server.loading", "Validating spell scripts...");
+        sObjectMgr->ValidateSpellScripts();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading SmartAI scripts...");
-    sSmartScriptMgr->LoadSmartAIFromDB();
+    loader.Add("smart scripts", { "scripts" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading SmartAI scripts...");
+        sSmartScriptMgr->LoadSmartAIFromDB();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Calendar data...");
-    sCalendarMgr->LoadFromDB();
+    loader.Add("calendar", { "guilds" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Calendar data...");
+        sCalendarMgr->LoadFromDB();
+    });
 
     //SF_LOG_INFO("server.loading", "Loading Research Digsite info...");
     //sObjectMgr->LoadResearchDigsiteInfo();
@@ -1853,15 +2037,22 @@ void World::SetInitialWorldSettings()
     //SF_LOG_INFO("server.loading", "Loading Research Project requirements...");
     //sObjectMgr->LoadResearchProjectRequirements();
 
-    SF_LOG_INFO("server.loading", "Loading Battle Pet breed data...");
-    sObjectMgr->LoadBattlePetBreedData();
+    loader.Add("battle pets", { "db2 stores" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Battle Pet breed data...");
+        sObjectMgr->LoadBattlePetBreedData();
 
-    SF_LOG_INFO("server.loading", "Loading Battle Pet quality data...");
-    sObjectMgr->LoadBattlePetQualityData();
+        SF_LOG_INFO("server.loading", "Loading Battle Pet quality data...");
+        sObjectMgr->LoadBattlePetQualityData();
+    });
 
+    loader.Add("cinematics", { "dbc stores" }, []()
+    {
+        SF_LOG_INFO("server.loading", "Loading Cinematic path ...");
+        sCinematicSequenceMgr->Load();
+    });
 
-    SF_LOG_INFO("server.loading", "Loading Cinematic path ...");
-    sCinematicSequenceMgr->Load();
+    loader.Run(getIntConfig(WorldIntConfigs::CONFIG_STARTUP_LOAD_THREADS));
 
     ///- Initialize game time and timers
     SF_LOG_INFO("server.loading", "Initialize game time and timers");
@@ -2282,6 +2473,7 @@ void World::ForceGameEventUpdate()
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    WorldPacketBroadcast broadcast(packet);
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2299,6 +2491,7 @@ void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 te
 /// Send a packet to all GMs (except self if mentioned)
 void World::SendGlobalGMMessage(WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    WorldPacketBroadcast broadcast(packet);
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
         // check if session and can receive global GM Messages and its not self
@@ -2428,6 +2621,7 @@ void World::SendGlobalText(const char* text, WorldSession* self)
 /// Send a packet to all players (or players selected team) in the zone (except self if mentioned)
 void World::SendZoneMessage(uint32 zone, WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    WorldPacketBroadcast broadcast(packet);
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -166,6 +166,9 @@ enum class WorldBoolConfigs
     CONFIG_TICKETS_GM_ENABLED,
     CONFIG_TICKETS_FEEDBACK_SYSTEM_ENABLED,
     CONFIG_BOOST_NEW_ACCOUNT,
+    CONFIG_MAP_FILE_MAPPING,
+    CONFIG_MAP_QUERY_CACHE,
+    CONFIG_WORLD_SNAPSHOTS,
     BOOL_CONFIG_VALUE_COUNT
 };
 
@@ -360,6 +363,10 @@ enum class WorldIntConfigs
     CONFIG_BLACK_MARKET_AUCTION_DELAY_MOD,
     CONFIG_BOOST_START_MONEY,
     CONFIG_BOOST_START_LEVEL,
+    CONFIG_GRID_PREFETCH_THREADS,
+    CONFIG_GRID_PREFETCH_LOOKAHEAD,
+    CONFIG_PATHFINDING_THREADS,
+    CONFIG_STARTUP_LOAD_THREADS,
     INT_CONFIG_VALUE_COUNT
 };
 
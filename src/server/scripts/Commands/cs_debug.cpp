@@ -18,9 +18,14 @@ EndScriptData */
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
 #include "Language.h"
+#include "LFGQueue.h"
 #include "ObjectMgr.h"
 #include "ScriptMgr.h"
 #include "Transport.h"
+#include "UpdateMask.h"
+
+#include <chrono>
+#include <random>
 
 class debug_commandscript : public CommandScript
 {
@@ -76,6 +81,11 @@ public:
             { "los",           rbac::RBAC_PERM_COMMAND_DEBUG_LOS,           false, &HandleDebugLoSCommand,              "", },
             { "moveflags",     rbac::RBAC_PERM_COMMAND_DEBUG_MOVEFLAGS,     false, &HandleDebugMoveflagsCommand,        "", },
             { "transport",     rbac::RBAC_PERM_COMMAND_DEBUG_TRANSPORT,     false, &HandleDebugTransportCommand,        "", },
+            { "updatemask",    rbac::RBAC_PERM_COMMAND_DEBUG_UPDATEMASK,    false, &HandleDebugUpdateMaskCommand,       "", },
+            { "dyntree",       rbac::RBAC_PERM_COMMAND_DEBUG_DYNTREE,       false, &HandleDebugDynamicTreeCommand,      "", },
+            { "lfgqueue",      rbac::RBAC_PERM_COMMAND_DEBUG_LFGQUEUE,      true,  &HandleDebugLfgQueueCommand,         "", },
+            { "procs",         rbac::RBAC_PERM_COMMAND_DEBUG_PROCS,         true,  &HandleDebugProcsCommand,            "", },
+            { "events",        rbac::RBAC_PERM_COMMAND_DEBUG_EVENTS,        true,  &HandleDebugEventsCommand,           "", },
         };
         static std::vector<ChatCommand> commandTable =
         {
@@ -1196,6 +1206,168 @@ public:
         handler->PSendSysMessage("Transport %s %s", transport->GetName().c_str(), start ? "started" : "stopped");
         return true;
     }
+
+    // USAGE: .debug updatemask [#iterations]
+    // times selecting the values update fields of the selected unit (or the own player) field by field vs per mask block,
+    // for its pending changes and for a creation, both through Object::BuildValuesUpdateMaskFor
+    static bool HandleDebugUpdateMaskCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 iterations = *args ? uint32(atoi(args)) : 10000;
+        if (!iterations)
+            iterations = 10000;
+
+        Player* player = handler->GetSession()->GetPlayer();
+        Unit* object = handler->getSelectedUnit();
+        if (!object)
+            object = player;
+
+        static uint8 const updateTypes[] = { UPDATETYPE_VALUES, UPDATETYPE_CREATE_OBJECT };
+        for (uint8 updateType : updateTypes)
+        {
+            UpdateMask perField;
+            UpdateMask perBlock;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint32 n = 0; n < iterations; ++n)
+                object->BuildValuesUpdateMaskFor(player, updateType, perField, true);
+            uint64 perFieldTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+            for (uint32 n = 0; n < iterations; ++n)
+                object->BuildValuesUpdateMaskFor(player, updateType, perBlock);
+            uint64 perBlockTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            uint32 sent = 0;
+            perBlock.ForEachSetBit([&sent](uint32 /*index*/) { ++sent; });
+
+            bool same = perField.GetBlockCount() == perBlock.GetBlockCount();
+            for (uint32 block = 0; same && block < perField.GetBlockCount(); ++block)
+                same = perField.GetBlock(block) == perBlock.GetBlock(block);
+
+            handler->PSendSysMessage("%s update mask of %s, %u of %u fields, %u iterations: per field " UI64FMTD " us, per block " UI64FMTD " us, results %s",
+                updateType == UPDATETYPE_VALUES ? "Values" : "Create", object->GetName().c_str(), sent, object->GetValuesCount(), iterations,
+                perFieldTime, perBlockTime, same ? "match" : "DIFFER");
+        }
+        return true;
+    }
+
+    // USAGE: .debug dyntree [#iterations]
+    // times moving every gameobject model of the own map by rebuilding its cell vs refitting it, and the tree update after the moves
+    static bool HandleDebugDynamicTreeCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 iterations = *args ? uint32(atoi(args)) : 100;
+        if (!iterations)
+            iterations = 100;
+
+        Map* map = handler->GetSession()->GetPlayer()->GetMap();
+
+        std::vector<const GameObjectModel*> models;
+        map->GetGameObjectModels(models);
+        if (models.empty())
+        {
+            handler->PSendSysMessage("Map %u has no gameobject models", map->GetId());
+            return true;
+        }
+
+        // private trees of the same models, the map's own tree is left alone
+        DynamicTreeBenchmark result;
+        DynamicMapTree::benchmark(models, iterations, result);
+
+        handler->PSendSysMessage("Dynamic tree of map %u, %u models, %u iterations: rebuild " UI64FMTD " us, refit " UI64FMTD " us, update " UI64FMTD " us",
+            map->GetId(), uint32(models.size()), iterations, result.RebuildTime, result.RefitTime, result.UpdateTime);
+        return true;
+    }
+
+    // USAGE: .debug lfgqueue [#entries]
+    // times matching fake solo players with random roles and dungeons in a queue of its own, joining a batch per update like the LFG update does
+    static bool HandleDebugLfgQueueCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 entries = *args ? uint32(atoi(args)) : 5000;
+        if (!entries)
+            entries = 5000;
+
+        static uint8 const roleChoices[] =
+        {
+            lfg::PLAYER_ROLE_TANK, lfg::PLAYER_ROLE_HEALER, lfg::PLAYER_ROLE_DAMAGE, lfg::PLAYER_ROLE_DAMAGE, lfg::PLAYER_ROLE_DAMAGE,
+            lfg::PLAYER_ROLE_TANK | lfg::PLAYER_ROLE_DAMAGE, lfg::PLAYER_ROLE_HEALER | lfg::PLAYER_ROLE_DAMAGE,
+            lfg::PLAYER_ROLE_TANK | lfg::PLAYER_ROLE_HEALER | lfg::PLAYER_ROLE_DAMAGE
+        };
+        uint32 const dungeonPool = 30;
+        uint32 const batchSize = 50;
+
+        // the same seed every time, runs before and after a change see the same players
+        std::mt19937 generator(entries);
+        std::uniform_int_distribution<uint32> roleDistribution(0, sizeof(roleChoices) - 1);
+        std::uniform_int_distribution<uint32> dungeonCountDistribution(1, 3);
+        std::uniform_int_distribution<uint32> dungeonDistribution(1, dungeonPool);
+
+        lfg::LFGQueue queue;
+        queue.SetReplay(true);
+
+        uint32 matches = 0;
+        uint32 updates = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32 joined = 0; joined < entries; ++updates)
+        {
+            for (uint32 i = 0; i < batchSize && joined < entries; ++i, ++joined)
+            {
+                // far above any real character, nothing is looked up for them in replay
+                uint64 guid = MAKE_NEW_GUID(0x7F000000 + joined, 0, HIGHGUID_PLAYER);
+
+                lfg::LfgRolesMap roles;
+                roles[guid] = lfg::PLAYER_ROLE_LEADER | roleChoices[roleDistribution(generator)];
+
+                lfg::LfgDungeonSet dungeons;
+                for (uint32 n = dungeonCountDistribution(generator); n; --n)
+                    dungeons.insert(dungeonDistribution(generator));
+
+                queue.AddQueueData(guid, time(NULL), dungeons, roles);
+            }
+
+            queue.FindGroups();
+            matches += uint32(queue.TakeReplayMatches().size());
+        }
+        uint64 matchTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        handler->PSendSysMessage("LFG queue, %u players in %u updates: " UI64FMTD " us, %u groups formed, " UI64FMTD " combinations pruned, %u cached",
+            entries, updates, matchTime, matches, queue.GetPrunedCount(), queue.GetCompatibleCount());
+        return true;
+    }
+
+    // USAGE: .debug procs [reset]
+    // the auras ProcDamageAndSpellFor examined since the start or the last reset, against the auras the units had applied
+    static bool HandleDebugProcsCommand(ChatHandler* handler, char const* args)
+    {
+        UnitProcStats stats = Unit::GetProcStats();
+        handler->PSendSysMessage("Procs, " UI64FMTD " events: " UI64FMTD " auras applied, " UI64FMTD " examined, " UI64FMTD " triggered",
+            stats.events, stats.applied, stats.examined, stats.triggered);
+
+        if (*args && !strncmp(args, "reset", 5))
+        {
+            Unit::ResetProcStats();
+            handler->SendSysMessage("Proc counters reset");
+        }
+        return true;
+    }
+
+    // USAGE: .debug events [#units]
+    // times 30 s of unit timers in event processors of its own against the multimap queue they replaced,
+    // then compares both call by call in randomized runs; blocks the world for several seconds at 100k units
+    static bool HandleDebugEventsCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 units = *args ? uint32(atoi(args)) : 100000;
+        if (!units)
+            units = 100000;
+
+        EventProcessorBenchmark result;
+        EventProcessor::Benchmark(units, result);
+
+        handler->PSendSysMessage("Event processors, %u units, " UI64FMTD " events: multimap " UI64FMTD " us, timing wheel " UI64FMTD " us",
+            units, result.WheelExecuted, result.MultimapTime, result.WheelTime);
+        handler->PSendSysMessage("%u randomized runs against the multimap: %u differ%s", result.Scenarios, result.Mismatches,
+            result.MultimapExecuted != result.WheelExecuted ? ", benchmark runs executed different events" : "");
+        return true;
+    }
 };
 
 void AddSC_debug_commandscript()
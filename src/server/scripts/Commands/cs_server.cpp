@@ -12,7 +12,9 @@ EndScriptData */
 
 #include "Chat.h"
 #include "Config.h"
+#include "DatabaseEnv.h"
 #include "Language.h"
+#include "MapManager.h"
 #include "ObjectAccessor.h"
 #include "Player.h"
 #include "ScriptMgr.h"
@@ -104,6 +106,35 @@ public:
         handler->PSendSysMessage(LANG_UPTIME, uptime.c_str());
         handler->PSendSysMessage(LANG_UPDATE_DIFF, updateTime);
 
+        if (sMapMgr->GetMapUpdater()->activated())
+        {
+            MapUpdateTimings timings = sMapMgr->GetMapUpdater()->GetLastTickTimings();
+            handler->PSendSysMessage("Map update: %u ms for %u maps", sMapMgr->GetMapUpdater()->GetLastTickDuration(), uint32(timings.size()));
+            for (size_t i = 0; i < timings.size() && i < 5; ++i)
+                handler->PSendSysMessage("  map %u instance %u: %u us", timings[i].MapId, timings[i].InstanceId, timings[i].Cost);
+        }
+
+        ByteBufferPoolStats bufferStats = ByteBufferPool::GetStats();
+        handler->PSendSysMessage("Packet buffers: " UI64FMTD " inline, " UI64FMTD " pool hits, " UI64FMTD " shared hits, " UI64FMTD " pool misses",
+            bufferStats.Inline, bufferStats.Hits, bufferStats.Shared, bufferStats.Misses);
+
+        MapQueryCacheStats queryStats = MapQueryCache::GetStats();
+        handler->PSendSysMessage("Map query cache hits: line of sight %.1f%% (%.1f%% terrain only), height %.1f%% (%.1f%% terrain only), object hit pos %.1f%%",
+            GetHitRate(queryStats, queryStats.Hits, MAP_QUERY_LINE_OF_SIGHT), GetHitRate(queryStats, queryStats.TerrainHits, MAP_QUERY_LINE_OF_SIGHT),
+            GetHitRate(queryStats, queryStats.Hits, MAP_QUERY_HEIGHT), GetHitRate(queryStats, queryStats.TerrainHits, MAP_QUERY_HEIGHT),
+            GetHitRate(queryStats, queryStats.Hits, MAP_QUERY_OBJECT_HIT_POS));
+
+        if (sMapMgr->GetPathfindingService()->IsActive())
+        {
+            PathfindingStats pathStats = sMapMgr->GetPathfindingService()->GetStats();
+            handler->PSendSysMessage("Pathfinding: " UI64FMTD " requests, " UI64FMTD " shared, " UI64FMTD " dropped, %u queued",
+                pathStats.Requests, pathStats.Shared, pathStats.Dropped, pathStats.Queued);
+        }
+
+        SendDatabaseQueueStats(handler, "Login", LoginDatabase.GetQueueStats());
+        SendDatabaseQueueStats(handler, "World", WorldDatabase.GetQueueStats());
+        SendDatabaseQueueStats(handler, "Character", CharacterDatabase.GetQueueStats());
+
         // Can't use sWorld->ShutdownMsg here in case of console command
         if (sWorld->IsShuttingDown())
             handler->PSendSysMessage(LANG_SHUTDOWN_TIMELEFT, secsToTimeString(sWorld->GetShutDownTimeLeft()).c_str());
@@ -118,6 +149,22 @@ public:
         return true;
     }
 
+    static float GetHitRate(MapQueryCacheStats const& stats, uint64 const* hits, MapQueryType type)
+    {
+        uint64 lookups = stats.Hits[type] + stats.TerrainHits[type] + stats.Misses[type];
+        return lookups ? float(hits[type]) * 100.0f / lookups : 0.0f;
+    }
+
+    static void SendDatabaseQueueStats(ChatHandler* handler, char const* name, SQLOperationQueueStats const& stats)
+    {
+        handler->PSendSysMessage("%s database queue: %u waiting (max %u), " UI64FMTD " processed, wait p50 < %u ms, p99 < %u ms",
+            name, stats.Depth, stats.MaxDepth, stats.Processed, stats.GetWaitPercentile(0.5f), stats.GetWaitPercentile(0.99f));
+
+        if (stats.BatchRoundTrips)
+            handler->PSendSysMessage("  " UI64FMTD " batches, %.2f statements per round trip, flush p50 < %u ms, p99 < %u ms",
+                stats.Batches, float(stats.BatchedStatements) / stats.BatchRoundTrips, stats.GetFlushPercentile(0.5f), stats.GetFlushPercentile(0.99f));
+    }
+
     // Display the 'Message of the day' for the realm
     static bool HandleServerMotdCommand(ChatHandler* handler, char const* /*args*/)
     {
@@ -19,6 +19,7 @@ public:
     ~BasicStatementTask();
 
     bool Execute();
+    bool IsBatchable() const { return !m_has_result; }
 
 private:
     const char* m_sql;      //- Raw query to be executed
@@ -8,8 +8,12 @@
 #include "MySQLConnection.h"
 #include "MySQLThreading.h"
 #include "SQLOperation.h"
+#include "SQLOperationQueue.h"
+#include "Timer.h"
 
-DatabaseWorker::DatabaseWorker(ACE_Activation_Queue* new_queue, MySQLConnection* con) :
+#include <mysqld_error.h>
+
+DatabaseWorker::DatabaseWorker(SQLOperationQueue* new_queue, MySQLConnection* con) :
     m_queue(new_queue),
     m_conn(con)
 {
@@ -23,12 +27,27 @@ int DatabaseWorker::svc()
         return -1;
 
     SQLOperation* request = NULL;
+    SQLOperation* next = NULL;
     while (1)
     {
-        request = (SQLOperation*)(m_queue->dequeue());
+        request = next ? next : m_queue->Dequeue();
+        next = NULL;
         if (!request)
             break;
 
+        if (m_queue->GetBatchMaxStatements() > 1 && request->IsBatchable())
+        {
+            m_batch.push_back(request);
+            next = CollectBatch(m_batch);
+            ExecuteBatch(m_batch);
+
+            for (size_t i = 0; i < m_batch.size(); ++i)
+                delete m_batch[i];
+
+            m_batch.clear();
+            continue;
+        }
+
         request->SetConnection(m_conn);
         request->call();
 
@@ -37,3 +56,102 @@ int DatabaseWorker::svc()
 
     return 0;
 }
+
+SQLOperation* DatabaseWorker::CollectBatch(std::vector<SQLOperation*>& batch)
+{
+    uint32 window = m_queue->GetBatchWindow();
+    uint32 start = getMSTime();
+
+    while (batch.size() < m_queue->GetBatchMaxStatements())
+    {
+        uint32 elapsed = GetMSTimeDiffToNow(start);
+        SQLOperation* op = elapsed < window ? m_queue->Dequeue(window - elapsed) : m_queue->TryDequeue();
+        if (!op)
+            break;
+
+        if (!op->IsBatchable())
+            return op;
+
+        batch.push_back(op);
+    }
+
+    return NULL;
+}
+
+void DatabaseWorker::ExecuteBatch(std::vector<SQLOperation*>& batch)
+{
+    uint32 start = getMSTime();
+    uint32 roundTrips = 0;
+    bool transaction = batch.size() > 1;
+
+    m_batchStatements.resize(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        batch[i]->SetConnection(m_conn);
+        m_batchStatements[i] = batch[i]->GetBatchStatement();
+    }
+
+    if (transaction)
+    {
+        m_conn->BeginTransaction();
+        ++roundTrips;
+    }
+
+    bool replay = false;
+    for (size_t i = 0; i < batch.size() && !replay;)
+    {
+        int32 rows = transaction ? m_conn->ExecuteMultiRow(&m_batchStatements[i], uint32(batch.size() - i)) : 0;
+        ++roundTrips;
+
+        if (rows > 0)
+        {
+            i += rows;
+            continue;
+        }
+
+        // a failed multi-row statement is retried row by row, unless it took the transaction with it
+        if (rows < 0)
+        {
+            if (m_conn->GetLastError() == ER_LOCK_DEADLOCK || m_conn->IsTransactionLost())
+            {
+                replay = true;
+                break;
+            }
+
+            ++roundTrips;
+        }
+
+        // a statement failing on its own fails as it would outside the batch,
+        // a deadlock or a lost connection rolls back all of them
+        if (!batch[i]->Execute() && transaction && (m_conn->GetLastError() == ER_LOCK_DEADLOCK || m_conn->IsTransactionLost()))
+            replay = true;
+
+        ++i;
+    }
+
+    if (transaction && !replay)
+    {
+        m_conn->CommitTransaction();
+        ++roundTrips;
+        replay = m_conn->IsTransactionLost();
+    }
+
+    if (replay)
+    {
+        bool lost = m_conn->IsTransactionLost();
+        SF_LOG_WARN("sql.sql", "%s in a batch of %u statements, executing them one by one.", lost ? "Lost connection" : "Deadlock", uint32(batch.size()));
+        if (!lost)
+        {
+            m_conn->RollbackTransaction();
+            ++roundTrips;
+        }
+
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            batch[i]->Execute();
+            ++roundTrips;
+        }
+    }
+
+    m_queue->RecordBatch(uint32(batch.size()), roundTrips, GetMSTimeDiffToNow(start));
+}
@@ -7,23 +7,34 @@
 #define _WORKERTHREAD_H
 
 #include "Define.h"
-#include <ace/Activation_Queue.h>
 #include <ace/Task.h>
 
+#include <vector>
+
 class MySQLConnection;
+class PreparedStatement;
+class SQLOperation;
+class SQLOperationQueue;
 
 class DatabaseWorker : protected ACE_Task_Base
 {
 public:
-    DatabaseWorker(ACE_Activation_Queue* new_queue, MySQLConnection* con);
+    DatabaseWorker(SQLOperationQueue* new_queue, MySQLConnection* con);
 
     ///- Inherited from ACE_Task_Base
     int svc();
     int wait() { return ACE_Task_Base::wait(); }
 
 private:
-    ACE_Activation_Queue* m_queue;
+    /// Appends the one-way operations following the first one in batch, returns the operation that ended the batch if any.
+    SQLOperation* CollectBatch(std::vector<SQLOperation*>& batch);
+    /// Runs the batch in one transaction, rows of the same INSERT or REPLACE as multi-row statements.
+    void ExecuteBatch(std::vector<SQLOperation*>& batch);
+
+    SQLOperationQueue* m_queue;
     MySQLConnection* m_conn;
+    std::vector<SQLOperation*> m_batch;
+    std::vector<PreparedStatement*> m_batchStatements;
     DatabaseWorker(DatabaseWorker const& right) = delete;
     DatabaseWorker& operator=(DatabaseWorker const& right) = delete;
 };
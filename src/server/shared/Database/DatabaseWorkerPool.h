@@ -17,6 +17,7 @@
 #include "PreparedStatement.h"
 #include "QueryHolder.h"
 #include "QueryResult.h"
+#include "SQLOperationQueue.h"
 #include "Transaction.h"
 
 #define MIN_MYSQL_SERVER_VERSION 50100u
@@ -37,7 +38,7 @@ class DatabaseWorkerPool
 {
 public:
     /* Activity state */
-    DatabaseWorkerPool() : _queue(new ACE_Activation_Queue()), _connectionInfo(NULL)
+    DatabaseWorkerPool() : _connectionInfo(NULL), _batchMaxStatements(0), _batchWindow(0)
     {
         memset(_connectionCount, 0, sizeof(_connectionCount));
         _connections.resize(IDX_SIZE);
@@ -55,14 +56,24 @@ public:
         bool res = true;
         _connectionInfo = new MySQLConnectionInfo(host, port, user, password, database);
 
+        //! Enqueue() spreads the operations over the asynchronous connections, there has to be one
+        if (!async_threads)
+        {
+            SF_LOG_ERROR("sql.driver", "DatabasePool '%s' needs at least one asynchronous connection, opening one.", GetDatabaseName());
+            async_threads = 1;
+        }
+
         SF_LOG_INFO("sql.driver", "Opening DatabasePool '%s'. Asynchronous connections: %u, synchronous connections: %u.",
             GetDatabaseName(), async_threads, synch_threads);
 
         //! Open asynchronous connections (delayed operations)
         _connections[IDX_ASYNC].resize(async_threads);
+        _queues.resize(async_threads);
         for (uint8 i = 0; i < async_threads; ++i)
         {
-            T* t = new T(_queue, *_connectionInfo);
+            _queues[i] = new SQLOperationQueue();
+            _queues[i]->SetBatchLimits(_batchMaxStatements, _batchWindow);
+            T* t = new T(_queues[i], *_connectionInfo);
             res &= t->Open();
             if (res) // only check mysql version if connection is valid
                 WPFatal(mysql_get_server_version(t->GetHandle()) >= MIN_MYSQL_SERVER_VERSION, "SkyFire does not support MySQL versions below 5.1");
@@ -94,14 +105,24 @@ public:
         bool res = true;
         _connectionInfo = new MySQLConnectionInfo(infoString);
 
+        //! Enqueue() spreads the operations over the asynchronous connections, there has to be one
+        if (!async_threads)
+        {
+            SF_LOG_ERROR("sql.driver", "DatabasePool '%s' needs at least one asynchronous connection, opening one.", GetDatabaseName());
+            async_threads = 1;
+        }
+
         SF_LOG_INFO("sql.driver", "Opening DatabasePool '%s'. Asynchronous connections: %u, synchronous connections: %u.",
             GetDatabaseName(), async_threads, synch_threads);
 
         //! Open asynchronous connections (delayed operations)
         _connections[IDX_ASYNC].resize(async_threads);
+        _queues.resize(async_threads);
         for (uint8 i = 0; i < async_threads; ++i)
         {
-            T* t = new T(_queue, *_connectionInfo);
+            _queues[i] = new SQLOperationQueue();
+            _queues[i]->SetBatchLimits(_batchMaxStatements, _batchWindow);
+            T* t = new T(_queues[i], *_connectionInfo);
             res &= t->Open();
             if (res) // only check mysql version if connection is valid
                 WPFatal(mysql_get_server_version(t->GetHandle()) >= MIN_MYSQL_SERVER_VERSION, "Skyfire does not support MySQL versions below 5.1");
@@ -128,14 +149,22 @@ public:
         return res;
     }
 
+    //! Lets the async workers run up to maxStatements consecutive one-way statements in one transaction,
+    //! waiting at most window ms for more of them. Must be called before Open().
+    void SetBatchLimits(uint32 maxStatements, uint32 window)
+    {
+        _batchMaxStatements = maxStatements;
+        _batchWindow = window;
+    }
+
     void Close()
     {
         SF_LOG_INFO("sql.driver", "Closing down DatabasePool '%s'.", GetDatabaseName());
 
-        //! Shuts down delaythreads for this connection pool by underlying deactivate().
-        //! The next dequeue attempt in the worker thread tasks will result in an error,
-        //! ultimately ending the worker thread task.
-        _queue->queue()->close();
+        //! Shuts down delaythreads for this connection pool. Every worker runs what
+        //! is already queued for it and then ends its thread task.
+        for (size_t i = 0; i < _queues.size(); ++i)
+            _queues[i]->Close();
 
         for (uint8 i = 0; i < _connectionCount[IDX_ASYNC]; ++i)
         {
@@ -156,8 +185,10 @@ public:
         for (uint8 i = 0; i < _connectionCount[IDX_SYNCH]; ++i)
             _connections[IDX_SYNCH][i]->Close();
 
-        //! Deletes the ACE_Activation_Queue object and its underlying ACE_Message_Queue
-        delete _queue;
+        //! Deletes the queues of the asynchronous connections
+        for (size_t i = 0; i < _queues.size(); ++i)
+            delete _queues[i];
+        _queues.clear();
 
         SF_LOG_INFO("sql.driver", "All connections on DatabasePool '%s' closed.", GetDatabaseName());
         delete _connectionInfo;
@@ -203,6 +234,14 @@ public:
         Enqueue(task);
     }
 
+    //! Same as Execute(PreparedStatement*), operations with the same affinity (e.g. a guid or account id)
+    //! run on the same connection in the order they were enqueued.
+    void Execute(PreparedStatement* stmt, uint64 affinity)
+    {
+        PreparedStatementTask* task = new PreparedStatementTask(stmt);
+        Enqueue(task, affinity);
+    }
+
     /**
         Direct synchronous one-way statement methods.
     */
@@ -361,6 +400,15 @@ public:
         return res;
     }
 
+    //! Same as AsyncQuery(PreparedStatement*), ordered after everything enqueued with the same affinity.
+    PreparedQueryResultFuture AsyncQuery(PreparedStatement* stmt, uint64 affinity)
+    {
+        PreparedQueryResultFuture res;
+        PreparedStatementTask* task = new PreparedStatementTask(stmt, res);
+        Enqueue(task, affinity);
+        return res;
+    }
+
     //! Enqueues a vector of SQL operations (can be both adhoc and prepared) that will set the value of the QueryResultHolderFuture
     //! return object as soon as the query is executed.
     //! The return value is then processed in ProcessQueryCallback methods.
@@ -373,6 +421,15 @@ public:
         return res;     //! Fool compiler, has no use yet
     }
 
+    //! Same as DelayQueryHolder(SQLQueryHolder*), ordered after everything enqueued with the same affinity.
+    QueryResultHolderFuture DelayQueryHolder(SQLQueryHolder* holder, uint64 affinity)
+    {
+        QueryResultHolderFuture res;
+        SQLQueryHolderTask* task = new SQLQueryHolderTask(holder, res);
+        Enqueue(task, affinity);
+        return res;
+    }
+
     /**
         Transaction context methods.
     */
@@ -407,6 +464,13 @@ public:
         Enqueue(new TransactionTask(transaction));
     }
 
+    //! Same as CommitTransaction(SQLTransaction), operations with the same affinity (e.g. a guid or account id)
+    //! run on the same connection in the order they were enqueued.
+    void CommitTransaction(SQLTransaction transaction, uint64 affinity)
+    {
+        Enqueue(new TransactionTask(transaction), affinity);
+    }
+
     //! Directly executes a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
     //! were appended to the transaction will be respected during execution.
     void DirectCommitTransaction(SQLTransaction& transaction)
@@ -420,7 +484,7 @@ public:
 
         //! Handle MySQL Errno 1213 without extending deadlock to the core itself
         /// @todo More elegant way
-        if (con->GetLastError() == 1213)
+        if (con->GetLastError() == 1213 || con->IsTransactionLost())
         {
             uint8 loopBreaker = 5;
             for (uint8 i = 0; i < loopBreaker; ++i)
@@ -494,11 +558,19 @@ public:
             }
         }
 
-        //! Assuming all worker threads are free, every worker thread will receive 1 ping operation request
-        //! If one or more worker threads are busy, the ping operations will not be split evenly, but this doesn't matter
-        //! as the sole purpose is to prevent connections from idling.
-        for (size_t i = 0; i < _connections[IDX_ASYNC].size(); ++i)
-            Enqueue(new PingOperation);
+        //! Every worker thread receives 1 ping operation request on its own queue
+        for (size_t i = 0; i < _queues.size(); ++i)
+            _queues[i]->Enqueue(new PingOperation);
+    }
+
+    //! Depth and wait statistics summed over the queues of the asynchronous connections.
+    SQLOperationQueueStats GetQueueStats() const
+    {
+        SQLOperationQueueStats stats;
+        for (size_t i = 0; i < _queues.size(); ++i)
+            stats.Add(_queues[i]->GetStats());
+
+        return stats;
     }
 
 private:
@@ -510,9 +582,35 @@ private:
         return mysql_real_escape_string(_connections[IDX_SYNCH][0]->GetHandle(), to, from, length);
     }
 
+    //! Operations without affinity go to the connection with the fewest waiting operations.
     void Enqueue(SQLOperation* op)
     {
-        _queue->enqueue(op);
+        //! Ties are broken by a per thread rotation, so an idle pool still spreads the work
+        static thread_local uint32 rotation = 0;
+
+        size_t count = _queues.size();
+        ASSERT(count);
+        size_t start = rotation++ % count;
+        size_t best = start;
+        uint32 bestDepth = _queues[start]->GetDepth();
+        for (size_t i = 1; i < count && bestDepth; ++i)
+        {
+            size_t index = (start + i) % count;
+            uint32 depth = _queues[index]->GetDepth();
+            if (depth < bestDepth)
+            {
+                best = index;
+                bestDepth = depth;
+            }
+        }
+
+        _queues[best]->Enqueue(op);
+    }
+
+    void Enqueue(SQLOperation* op, uint64 affinity)
+    {
+        ASSERT(!_queues.empty());
+        _queues[affinity % _queues.size()]->Enqueue(op);
     }
 
     //! Gets a free connection in the synchronous connection pool.
@@ -547,10 +645,12 @@ private:
         IDX_SIZE
     };
 
-    ACE_Activation_Queue* _queue;             //! Queue shared by async worker threads.
+    std::vector<SQLOperationQueue*> _queues;  //! One queue per async worker thread.
     std::vector< std::vector<T*> >  _connections;
     uint32                          _connectionCount[2];       //! Counter of MySQL connections;
     MySQLConnectionInfo* _connectionInfo;
+    uint32                          _batchMaxStatements;       //! Batch limits handed to the queues on Open()
+    uint32                          _batchWindow;
 };
 
 #endif
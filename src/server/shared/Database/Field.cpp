@@ -19,36 +19,21 @@ Field::~Field()
     CleanUp();
 }
 
-void Field::SetByteValue(const void* newValue, const size_t newSize, enum_field_types newType, uint32 length)
+void Field::SetByteValue(const void* newValue, enum_field_types newType, uint32 length)
 {
-    if (data.value)
-        CleanUp();
-
     // This value stores raw bytes that have to be explicitly casted later
-    if (newValue)
-    {
-        data.value = new char[newSize];
-        memcpy(data.value, newValue, newSize);
-        data.length = length;
-    }
+    data.value = const_cast<void*>(newValue);
+    data.length = newValue ? length : 0;
     data.type = newType;
     data.raw = true;
 }
 
-void Field::SetStructuredValue(char* newValue, enum_field_types newType, uint32 length)
+void Field::SetStructuredValue(char const* newValue, enum_field_types newType, uint32 length)
 {
-    if (data.value)
-        CleanUp();
-
-    // This value stores somewhat structured data that needs function style casting
-    if (newValue)
-    {
-        data.value = new char[length + 1];
-        memcpy(data.value, newValue, length);
-        *(reinterpret_cast<char*>(data.value) + length) = '\0';
-        data.length = length;
-    }
-
+    // This value stores somewhat structured data that needs function style casting,
+    // libmysql terminates every value of a row with '\0'
+    data.value = const_cast<char*>(newValue);
+    data.length = newValue ? length : 0;
     data.type = newType;
     data.raw = false;
 }
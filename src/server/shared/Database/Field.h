@@ -270,7 +270,7 @@ protected:
     struct
     {
         uint32 length;          // Length (prepared strings only)
-        void* value;            // Actual data in memory
+        void* value;            // Actual data in memory, in the buffers of the result set
         enum_field_types type;  // Field type
         bool raw;               // Raw bytes? (Prepared statement or ad hoc)
     } data;
@@ -280,12 +280,12 @@ protected:
 #pragma pack(pop)
 #endif
 
-    void SetByteValue(void const* newValue, size_t const newSize, enum_field_types newType, uint32 length);
-    void SetStructuredValue(char* newValue, enum_field_types newType, uint32 length);
+    // the value is not copied, it stays owned by the result set
+    void SetByteValue(void const* newValue, enum_field_types newType, uint32 length);
+    void SetStructuredValue(char const* newValue, enum_field_types newType, uint32 length);
 
     void CleanUp()
     {
-        delete[]((char*)data.value);
         data.value = nullptr;
     }
 
@@ -6,6 +6,9 @@
 
 #include "Common.h"
 
+#include <algorithm>
+#include <bit>
+
 #ifdef _WIN32
 #include <winsock2.h>
 #endif
@@ -25,15 +28,19 @@
 MySQLConnection::MySQLConnection(MySQLConnectionInfo& connInfo) :
     m_reconnecting(false),
     m_prepareError(false),
+    m_inTransaction(false),
+    m_transactionLost(false),
     m_queue(NULL),
     m_worker(NULL),
     m_Mysql(NULL),
     m_connectionInfo(connInfo),
     m_connectionFlags(CONNECTION_SYNCH) { }
 
-MySQLConnection::MySQLConnection(ACE_Activation_Queue* queue, MySQLConnectionInfo& connInfo) :
+MySQLConnection::MySQLConnection(SQLOperationQueue* queue, MySQLConnectionInfo& connInfo) :
     m_reconnecting(false),
     m_prepareError(false),
+    m_inTransaction(false),
+    m_transactionLost(false),
     m_queue(queue),
     m_Mysql(NULL),
     m_connectionInfo(connInfo),
@@ -49,6 +56,8 @@ MySQLConnection::~MySQLConnection()
     for (size_t i = 0; i < m_stmts.size(); ++i)
         delete m_stmts[i];
 
+    ClearMultiRowStatements();
+
     mysql_close(m_Mysql);
 }
 
@@ -135,6 +144,7 @@ bool MySQLConnection::Open()
 
 bool MySQLConnection::PrepareStatements()
 {
+    ClearMultiRowStatements();
     DoPrepareStatements();
     return !m_prepareError;
 }
@@ -220,6 +230,138 @@ bool MySQLConnection::Execute(PreparedStatement* stmt)
     }
 }
 
+int32 MySQLConnection::ExecuteMultiRow(PreparedStatement* const* stmts, uint32 count)
+{
+    if (!m_Mysql || count < 2 || !stmts[0])
+        return 0;
+
+    uint32 index = stmts[0]->m_index;
+    MultiRowPattern& pattern = GetMultiRowPattern(index);
+    if (!pattern.Mergeable)
+        return 0;
+
+    // parameters are addressed by uint8
+    uint32 maxRows = 256 / pattern.ParamCount;
+    uint32 rows = 1;
+    while (rows < count && rows < maxRows && stmts[rows] && stmts[rows]->m_index == index && stmts[rows]->statement_data.size() == pattern.ParamCount)
+        ++rows;
+
+    // powers of two only, so that few variants get prepared per statement
+    rows = std::bit_floor(rows);
+    if (rows < 2 || stmts[0]->statement_data.size() != pattern.ParamCount)
+        return 0;
+
+    MySQLPreparedStatement*& m_mStmt = pattern.Statements[rows];
+    if (!m_mStmt)
+    {
+        std::string sql = pattern.Head + pattern.Row;
+        for (uint32 i = 1; i < rows; ++i)
+            sql += ", " + pattern.Row;
+
+        MYSQL_STMT* stmt = mysql_stmt_init(m_Mysql);
+        if (!stmt)
+            return 0;
+
+        if (mysql_stmt_prepare(stmt, sql.c_str(), sql.length()))
+        {
+            SF_LOG_ERROR("sql.sql", "Could not prepare %u rows of statement %u, it is no longer merged: %s", rows, index, mysql_stmt_error(stmt));
+            mysql_stmt_close(stmt);
+            pattern.Mergeable = false;
+            return 0;
+        }
+
+        m_mStmt = new MySQLPreparedStatement(stmt);
+    }
+
+    for (uint32 i = 0; i < rows; ++i)
+    {
+        m_mStmt->m_stmt = stmts[i];
+        stmts[i]->m_stmt = m_mStmt;
+        stmts[i]->BindParameters(uint8(i * pattern.ParamCount));
+    }
+
+    MYSQL_STMT* msql_STMT = m_mStmt->GetSTMT();
+    MYSQL_BIND* msql_BIND = m_mStmt->GetBind();
+
+    uint32 _s = getMSTime();
+
+    // no retry here, the caller executes the rows one by one instead
+#if MYSQL_VERSION_ID >= 80300
+    if (mysql_stmt_bind_named_param(msql_STMT, msql_BIND, m_mStmt->m_paramCount, nullptr) || mysql_stmt_execute(msql_STMT))
+#else
+    if (mysql_stmt_bind_param(msql_STMT, msql_BIND) || mysql_stmt_execute(msql_STMT))
+#endif
+    {
+        uint32 lErrno = mysql_errno(m_Mysql);
+        SF_LOG_DEBUG("sql.sql", "%u rows of statement %u failed as one statement: [%u] %s", rows, index, lErrno, mysql_stmt_error(msql_STMT));
+        m_mStmt->ClearParameters();
+
+        // reconnecting drops the merged statements, m_mStmt is gone afterwards
+        if (IsConnectionLost(lErrno))
+            _HandleMySQLErrno(lErrno);
+
+        return -1;
+    }
+
+    SF_LOG_DEBUG("sql.sql", "[%u ms] SQL(p) x%u: %s", getMSTimeDiff(_s, getMSTime()), rows, m_queries[index].first.c_str());
+
+    m_mStmt->ClearParameters();
+    return int32(rows);
+}
+
+MySQLConnection::MultiRowPattern& MySQLConnection::GetMultiRowPattern(uint32 index)
+{
+    std::map<uint32, MultiRowPattern>::iterator itr = m_multiRow.find(index);
+    if (itr != m_multiRow.end())
+        return itr->second;
+
+    MultiRowPattern& pattern = m_multiRow[index];
+
+    std::string const& sql = m_queries[index].first;
+    std::string upper = sql;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+
+    // INSERT/REPLACE ... VALUES (...) with nothing behind the row, ON DUPLICATE KEY UPDATE and INSERT ... SELECT stay single
+    size_t start = upper.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos || (upper.compare(start, 6, "INSERT") != 0 && upper.compare(start, 7, "REPLACE") != 0))
+        return pattern;
+
+    size_t values = upper.find("VALUES");
+    if (values == std::string::npos || upper.find("SELECT") != std::string::npos)
+        return pattern;
+
+    size_t open = upper.find_first_not_of(" \t\r\n", values + 6);
+    if (open == std::string::npos || upper[open] != '(')
+        return pattern;
+
+    size_t close = open;
+    for (int32 depth = 0; close < upper.size(); ++close)
+    {
+        if (upper[close] == '(')
+            ++depth;
+        else if (upper[close] == ')' && --depth == 0)
+            break;
+    }
+
+    if (close == upper.size() || upper.find_first_not_of(" \t\r\n;", close + 1) != std::string::npos)
+        return pattern;
+
+    pattern.Head = sql.substr(0, open);
+    pattern.Row = sql.substr(open, close - open + 1);
+    pattern.ParamCount = uint32(std::count(pattern.Row.begin(), pattern.Row.end(), '?'));
+    pattern.Mergeable = pattern.ParamCount && pattern.ParamCount <= 128 && std::count(sql.begin(), sql.end(), '?') == std::ptrdiff_t(pattern.ParamCount);
+    return pattern;
+}
+
+void MySQLConnection::ClearMultiRowStatements()
+{
+    for (std::map<uint32, MultiRowPattern>::iterator itr = m_multiRow.begin(); itr != m_multiRow.end(); ++itr)
+        for (std::map<uint32, MySQLPreparedStatement*>::iterator stmt = itr->second.Statements.begin(); stmt != itr->second.Statements.end(); ++stmt)
+            delete stmt->second;
+
+    m_multiRow.clear();
+}
+
 bool MySQLConnection::_Query(PreparedStatement* stmt, MYSQL_RES** pResult, uint64* pRowCount, uint32* pFieldCount)
 {
     if (!m_Mysql)
@@ -340,16 +482,20 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
 void MySQLConnection::BeginTransaction()
 {
     Execute("START TRANSACTION");
+    m_inTransaction = true;
+    m_transactionLost = false;
 }
 
 void MySQLConnection::RollbackTransaction()
 {
+    m_inTransaction = false;
     Execute("ROLLBACK");
 }
 
 void MySQLConnection::CommitTransaction()
 {
     Execute("COMMIT");
+    m_inTransaction = false;
 }
 
 bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
@@ -358,10 +504,16 @@ bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
     if (queries.empty())
         return false;
 
+    // rows of the same INSERT or REPLACE that follow each other are sent as one statement
+    std::vector<PreparedStatement*> stmts;
+    stmts.reserve(queries.size());
+    for (std::list<SQLElementData>::const_iterator itr = queries.begin(); itr != queries.end(); ++itr)
+        stmts.push_back(itr->type == SQL_ELEMENT_PREPARED ? itr->element.stmt : NULL);
+
     BeginTransaction();
 
-    std::list<SQLElementData>::const_iterator itr;
-    for (itr = queries.begin(); itr != queries.end(); ++itr)
+    std::list<SQLElementData>::const_iterator itr = queries.begin();
+    for (size_t i = 0; itr != queries.end(); ++i, ++itr)
     {
         SQLElementData const& data = *itr;
         switch (itr->type)
@@ -370,7 +522,16 @@ bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
             {
                 PreparedStatement* stmt = data.element.stmt;
                 ASSERT(stmt);
-                if (!Execute(stmt))
+
+                int32 rows = ExecuteMultiRow(&stmts[i], uint32(stmts.size() - i));
+                if (rows > 0)
+                {
+                    std::advance(itr, rows - 1);
+                    i += rows - 1;
+                    break;
+                }
+
+                if ((rows < 0 && (GetLastError() == ER_LOCK_DEADLOCK || m_transactionLost)) || !Execute(stmt))
                 {
                     SF_LOG_WARN("sql.sql", "Transaction aborted. %u queries not executed.", (uint32)queries.size());
                     RollbackTransaction();
@@ -399,7 +560,7 @@ bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
     // and not while iterating over every element.
 
     CommitTransaction();
-    return true;
+    return !m_transactionLost;
 }
 
 MySQLPreparedStatement* MySQLConnection::GetPreparedStatement(uint32 index)
@@ -470,6 +631,20 @@ PreparedResultSet* MySQLConnection::Query(PreparedStatement* stmt)
     return new PreparedResultSet(stmt->m_stmt->GetSTMT(), result, rowCount, fieldCount);
 }
 
+bool MySQLConnection::IsConnectionLost(uint32 errNo)
+{
+    switch (errNo)
+    {
+        case CR_SERVER_GONE_ERROR:
+        case CR_SERVER_LOST:
+        case CR_INVALID_CONN_HANDLE:
+        case CR_SERVER_LOST_EXTENDED:
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool MySQLConnection::_HandleMySQLErrno(uint32 errNo)
 {
     switch (errNo)
@@ -491,6 +666,16 @@ bool MySQLConnection::_HandleMySQLErrno(uint32 errNo)
                         (m_connectionFlags & CONNECTION_ASYNC) ? "asynchronous" : "synchronous");
 
                 m_reconnecting = false;
+
+                // the server rolled back the open transaction, running only the failed statement again would commit it alone
+                if (m_inTransaction)
+                {
+                    SF_LOG_WARN("sql.sql", "Connection lost inside a transaction, its statements were rolled back.");
+                    m_inTransaction = false;
+                    m_transactionLost = true;
+                    return false;
+                }
+
                 return true;
             }
 
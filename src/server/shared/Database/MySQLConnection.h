@@ -3,8 +3,6 @@
 * See LICENSE.md file for Copyright information
 */
 
-#include <ace/Activation_Queue.h>
-
 #include "DatabaseWorkerPool.h"
 #include "Transaction.h"
 #include "Util.h"
@@ -16,6 +14,7 @@ class DatabaseWorker;
 class PreparedStatement;
 class MySQLPreparedStatement;
 class PingOperation;
+class SQLOperationQueue;
 
 enum ConnectionFlags
 {
@@ -67,7 +66,7 @@ class MySQLConnection
 
 public:
     MySQLConnection(MySQLConnectionInfo& connInfo);                               //! Constructor for synchronous connections.
-    MySQLConnection(ACE_Activation_Queue* queue, MySQLConnectionInfo& connInfo);  //! Constructor for asynchronous connections.
+    MySQLConnection(SQLOperationQueue* queue, MySQLConnectionInfo& connInfo);     //! Constructor for asynchronous connections.
     virtual ~MySQLConnection();
 
     virtual bool Open();
@@ -76,6 +75,9 @@ public:
 public:
     bool Execute(const char* sql);
     bool Execute(PreparedStatement* stmt);
+    //! Executes the leading statements of stmts that are rows of the same INSERT or REPLACE as one multi-row statement.
+    //! Returns the number of statements executed, 0 if the first one can't be merged with the next and -1 on failure.
+    int32 ExecuteMultiRow(PreparedStatement* const* stmts, uint32 count);
     ResultSet* Query(const char* sql);
     PreparedResultSet* Query(PreparedStatement* stmt);
     bool _Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount);
@@ -90,6 +92,8 @@ public:
     void Ping() { mysql_ping(m_Mysql); }
 
     uint32 GetLastError() { return mysql_errno(m_Mysql); }
+    //! True if the connection was lost and reopened since the last BeginTransaction(), which rolled the transaction back.
+    bool IsTransactionLost() const { return m_transactionLost; }
 
 protected:
     bool LockIfReady()
@@ -117,12 +121,32 @@ protected:
     PreparedStatementMap                 m_queries;       //! Query storage
     bool                                 m_reconnecting;  //! Are we reconnecting?
     bool                                 m_prepareError;  //! Was there any error while preparing statements?
+    bool                                 m_inTransaction; //! Between BeginTransaction() and its commit or rollback
+    bool                                 m_transactionLost; //! Connection was reopened inside the last transaction
 
 private:
     bool _HandleMySQLErrno(uint32 errNo);
+    static bool IsConnectionLost(uint32 errNo);
+
+    //! Single row INSERT or REPLACE split into the part up to VALUES and the row tuple
+    struct MultiRowPattern
+    {
+        MultiRowPattern() : Mergeable(false), ParamCount(0) { }
+
+        bool Mergeable;
+        uint32 ParamCount;
+        std::string Head;
+        std::string Row;
+        std::map<uint32 /*rows*/, MySQLPreparedStatement*> Statements;
+    };
+
+    MultiRowPattern& GetMultiRowPattern(uint32 index);
+    void ClearMultiRowStatements();
+
+    std::map<uint32 /*index*/, MultiRowPattern> m_multiRow;
 
 private:
-    ACE_Activation_Queue* m_queue;                      //! Queue shared with other asynchronous connections.
+    SQLOperationQueue*    m_queue;                      //! Operations for this asynchronous connection.
     DatabaseWorker* m_worker;                     //! Core worker task.
     MYSQL* m_Mysql;                      //! MySQL Handle.
     MySQLConnectionInfo& m_connectionInfo;             //! Connection info (used for logging)
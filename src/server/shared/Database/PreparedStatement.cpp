@@ -13,7 +13,7 @@ PreparedStatement::PreparedStatement(uint32 index) :
 
 PreparedStatement::~PreparedStatement() { }
 
-void PreparedStatement::BindParameters()
+void PreparedStatement::BindParameters(uint8 offset /*= 0*/)
 {
     ASSERT(m_stmt);
 
@@ -23,51 +23,51 @@ void PreparedStatement::BindParameters()
         switch (statement_data[i].type)
         {
             case TYPE_BOOL:
-                m_stmt->setBool(i, statement_data[i].data.boolean);
+                m_stmt->setBool(offset + i, statement_data[i].data.boolean);
                 break;
             case TYPE_UI8:
-                m_stmt->setUInt8(i, statement_data[i].data.ui8);
+                m_stmt->setUInt8(offset + i, statement_data[i].data.ui8);
                 break;
             case TYPE_UI16:
-                m_stmt->setUInt16(i, statement_data[i].data.ui16);
+                m_stmt->setUInt16(offset + i, statement_data[i].data.ui16);
                 break;
             case TYPE_UI32:
-                m_stmt->setUInt32(i, statement_data[i].data.ui32);
+                m_stmt->setUInt32(offset + i, statement_data[i].data.ui32);
                 break;
             case TYPE_I8:
-                m_stmt->setInt8(i, statement_data[i].data.i8);
+                m_stmt->setInt8(offset + i, statement_data[i].data.i8);
                 break;
             case TYPE_I16:
-                m_stmt->setInt16(i, statement_data[i].data.i16);
+                m_stmt->setInt16(offset + i, statement_data[i].data.i16);
                 break;
             case TYPE_I32:
-                m_stmt->setInt32(i, statement_data[i].data.i32);
+                m_stmt->setInt32(offset + i, statement_data[i].data.i32);
                 break;
             case TYPE_UI64:
-                m_stmt->setUInt64(i, statement_data[i].data.ui64);
+                m_stmt->setUInt64(offset + i, statement_data[i].data.ui64);
                 break;
             case TYPE_I64:
-                m_stmt->setInt64(i, statement_data[i].data.i64);
+                m_stmt->setInt64(offset + i, statement_data[i].data.i64);
                 break;
             case TYPE_FLOAT:
-                m_stmt->setFloat(i, statement_data[i].data.f);
+                m_stmt->setFloat(offset + i, statement_data[i].data.f);
                 break;
             case TYPE_DOUBLE:
-                m_stmt->setDouble(i, statement_data[i].data.d);
+                m_stmt->setDouble(offset + i, statement_data[i].data.d);
                 break;
             case TYPE_STRING:
-                m_stmt->setBinary(i, statement_data[i].binary, true);
+                m_stmt->setBinary(offset + i, statement_data[i].binary, true);
                 break;
             case TYPE_BINARY:
-                m_stmt->setBinary(i, statement_data[i].binary, false);
+                m_stmt->setBinary(offset + i, statement_data[i].binary, false);
                 break;
             case TYPE_NULL:
-                m_stmt->setNull(i);
+                m_stmt->setNull(offset + i);
                 break;
         }
     }
 #ifdef _DEBUG
-    if (i < m_stmt->m_paramCount)
+    if (!offset && i < m_stmt->m_paramCount)
         SF_LOG_WARN("sql.sql", "[WARNING]: BindParameters() for statement %u did not bind all allocated parameters", m_index);
 #endif
 }
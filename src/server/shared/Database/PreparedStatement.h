@@ -91,7 +91,8 @@ public:
     void setNull(const uint8 index);
 
 protected:
-    void BindParameters();
+    //! offset is where the parameters start in a multi-row statement
+    void BindParameters(uint8 offset = 0);
 
     MySQLPreparedStatement* m_stmt;
     uint32 m_index;
@@ -158,6 +159,8 @@ public:
     ~PreparedStatementTask();
 
     bool Execute();
+    bool IsBatchable() const { return !m_has_result; }
+    PreparedStatement* GetBatchStatement() const { return m_has_result ? NULL : m_stmt; }
 
 protected:
     PreparedStatement* m_stmt;
@@ -17,6 +17,7 @@ ResultSet::ResultSet(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, ui
 }
 
 PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES* result, uint64 rowCount, uint32 fieldCount) :
+    m_fields(NULL),
     m_rowCount(rowCount),
     m_rowPosition(0),
     m_fieldCount(fieldCount),
@@ -50,6 +51,7 @@ PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES* result, uint64
         delete[] m_rBind;
         delete[] m_isNull;
         delete[] m_length;
+        m_rowCount = 0;
         return;
     }
 
@@ -80,45 +82,84 @@ PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES* result, uint64
         delete[] m_rBind;
         delete[] m_isNull;
         delete[] m_length;
+        m_rowCount = 0;
         return;
     }
 
     m_rowCount = mysql_stmt_num_rows(m_stmt);
 
-    m_rows.resize(uint32(m_rowCount));
+    //- Each fixed width column gets its place in the row, aligned to its size
+    std::vector<uint32> columnOffsets(m_fieldCount, 0);
+    uint32 rowSize = 0;
+    uint32 variableColumns = 0;
+    for (uint32 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
+    {
+        if (IsVariableWidth(m_rBind[fIndex].buffer_type))
+        {
+            ++variableColumns;
+            continue;
+        }
+
+        uint32 size = uint32(m_rBind[fIndex].buffer_length);
+        uint32 alignment = size >= 8 ? 8 : (size >= 4 ? 4 : (size >= 2 ? 2 : 1));
+        rowSize = (rowSize + alignment - 1) & ~(alignment - 1);
+        columnOffsets[fIndex] = rowSize;
+        rowSize += size;
+    }
+    rowSize = (rowSize + 7) & ~7;
+
+    m_fixedData.resize(size_t(rowSize) * size_t(m_rowCount));
+    m_fields = new Field[size_t(m_rowCount) * m_fieldCount];
+
+    // offset 0 is the empty string of NULL strings and blobs
+    m_stringData.push_back('\0');
+
+    // the string buffer grows while fetching, the fields only point into it once all rows are in
+    std::vector<std::pair<size_t, uint32>> strings;
+    strings.reserve(size_t(m_rowCount) * variableColumns);
+
     while (_NextRow())
     {
-        m_rows[uint32(m_rowPosition)] = new Field[m_fieldCount];
-        for (uint64 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
+        Field* row = &m_fields[size_t(m_rowPosition) * m_fieldCount];
+        uint8* fixedRow = m_fixedData.data() + size_t(m_rowPosition) * rowSize;
+        for (uint32 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
         {
-            if (!*m_rBind[fIndex].is_null)
-                m_rows[uint32(m_rowPosition)][fIndex].SetByteValue(m_rBind[fIndex].buffer,
-                    m_rBind[fIndex].buffer_length,
-                    m_rBind[fIndex].buffer_type,
-                    *m_rBind[fIndex].length);
-            else
-                switch (m_rBind[fIndex].buffer_type)
+            MYSQL_BIND const& bind = m_rBind[fIndex];
+            if (IsVariableWidth(bind.buffer_type))
+            {
+                size_t offset = 0;
+                uint32 length = 0;
+                if (!*bind.is_null)
                 {
-                    case MYSQL_TYPE_TINY_BLOB:
-                    case MYSQL_TYPE_MEDIUM_BLOB:
-                    case MYSQL_TYPE_LONG_BLOB:
-                    case MYSQL_TYPE_BLOB:
-                    case MYSQL_TYPE_STRING:
-                    case MYSQL_TYPE_VAR_STRING:
-                        m_rows[uint32(m_rowPosition)][fIndex].SetByteValue("",
-                            m_rBind[fIndex].buffer_length,
-                            m_rBind[fIndex].buffer_type,
-                            *m_rBind[fIndex].length);
-                        break;
-                    default:
-                        m_rows[uint32(m_rowPosition)][fIndex].SetByteValue(0,
-                            m_rBind[fIndex].buffer_length,
-                            m_rBind[fIndex].buffer_type,
-                            *m_rBind[fIndex].length);
+                    length = uint32(std::min<unsigned long>(*bind.length, bind.buffer_length));
+                    offset = m_stringData.size();
+                    m_stringData.insert(m_stringData.end(), static_cast<char const*>(bind.buffer), static_cast<char const*>(bind.buffer) + length);
+                    m_stringData.push_back('\0');
                 }
+
+                strings.push_back(std::make_pair(offset, length));
+            }
+            else if (!*bind.is_null)
+            {
+                memcpy(fixedRow + columnOffsets[fIndex], bind.buffer, bind.buffer_length);
+                row[fIndex].SetByteValue(fixedRow + columnOffsets[fIndex], bind.buffer_type, *bind.length);
+            }
+            else
+                row[fIndex].SetByteValue(NULL, bind.buffer_type, 0);
         }
         m_rowPosition++;
     }
+
+    //- The string buffer does not move any more
+    std::vector<std::pair<size_t, uint32>>::const_iterator string = strings.begin();
+    for (uint64 rIndex = 0; rIndex < m_rowPosition; ++rIndex)
+        for (uint32 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
+            if (IsVariableWidth(m_rBind[fIndex].buffer_type))
+            {
+                m_fields[size_t(rIndex) * m_fieldCount + fIndex].SetByteValue(&m_stringData[string->first], m_rBind[fIndex].buffer_type, string->second);
+                ++string;
+            }
+
     m_rowPosition = 0;
 
     /// All data is buffered, let go of mysql c api structures
@@ -132,8 +173,7 @@ ResultSet::~ResultSet()
 
 PreparedResultSet::~PreparedResultSet()
 {
-    for (uint32 i = 0; i < uint32(m_rowCount); ++i)
-        delete[] m_rows[i];
+    delete[] m_fields;
 }
 
 bool ResultSet::NextRow()
@@ -218,6 +258,24 @@ void PreparedResultSet::CleanUp()
     delete[] m_rBind;
 }
 
+bool PreparedResultSet::IsVariableWidth(enum_field_types type)
+{
+    switch (type)
+    {
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
 void PreparedResultSet::FreeBindBuffer()
 {
     for (uint32 i = 0; i < m_fieldCount; ++i)
@@ -48,6 +48,12 @@ private:
 
 typedef Skyfire::AutoPtr<ResultSet, ACE_Thread_Mutex> QueryResult;
 
+/*
+ * All rows are fetched when the statement was executed. Columns of a fixed
+ * width are kept inline in the rows of one buffer, strings and blobs one after
+ * the other in a second one and the fields of all rows in one array, the fields
+ * point into those buffers instead of each holding a copy of its value.
+ */
 class PreparedResultSet
 {
 public:
@@ -61,18 +67,20 @@ public:
     Field* Fetch() const
     {
         ASSERT(m_rowPosition < m_rowCount);
-        return m_rows[uint32(m_rowPosition)];
+        return &m_fields[size_t(m_rowPosition) * m_fieldCount];
     }
 
     const Field& operator [] (uint32 index) const
     {
         ASSERT(m_rowPosition < m_rowCount);
         ASSERT(index < m_fieldCount);
-        return m_rows[uint32(m_rowPosition)][index];
+        return m_fields[size_t(m_rowPosition) * m_fieldCount + index];
     }
 
 protected:
-    std::vector<Field*> m_rows;
+    Field* m_fields;                                        // m_rowCount rows of m_fieldCount fields
+    std::vector<uint8> m_fixedData;                         // the fixed width columns of every row
+    std::vector<char> m_stringData;                         // strings and blobs, each terminated by '\0'
     uint64 m_rowCount;
     uint64 m_rowPosition;
     uint32 m_fieldCount;
@@ -88,6 +96,7 @@ private:
     void FreeBindBuffer();
     void CleanUp();
     bool _NextRow();
+    static bool IsVariableWidth(enum_field_types type);
     PreparedResultSet(PreparedResultSet const& right) = delete;
     PreparedResultSet& operator=(PreparedResultSet const& right) = delete;
 };
@@ -11,6 +11,8 @@
 
 #include "QueryResult.h"
 
+#include <atomic>
+
 //- Forward declare (don't include header to prevent circular includes)
 class PreparedStatement;
 
@@ -46,8 +48,10 @@ class MySQLConnection;
 
 class SQLOperation : public ACE_Method_Request
 {
+    friend class SQLOperationQueue;
+
 public:
-    SQLOperation() : m_conn(NULL) { }
+    SQLOperation() : m_conn(NULL), m_queueNext(NULL), m_queuedAt(0) { }
     virtual int call()
     {
         Execute();
@@ -56,8 +60,16 @@ public:
     virtual bool Execute() = 0;
     virtual void SetConnection(MySQLConnection* con) { m_conn = con; }
 
+    //! One-way operation without a result, the worker may run consecutive ones in one transaction
+    virtual bool IsBatchable() const { return false; }
+    //! Statement of a batchable prepared operation, consecutive rows of one INSERT or REPLACE can be merged
+    virtual PreparedStatement* GetBatchStatement() const { return NULL; }
+
     MySQLConnection* m_conn;
 private:
+    std::atomic<SQLOperation*> m_queueNext;    //! Link in the SQLOperationQueue
+    uint64 m_queuedAt;                         //! Enqueue time in microseconds, for the queue wait statistics
+
     SQLOperation(SQLOperation const& right) = delete;
     SQLOperation& operator=(SQLOperation const& right) = delete;
 };
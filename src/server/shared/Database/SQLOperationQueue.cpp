@@ -0,0 +1,257 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include "SQLOperationQueue.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    uint64 GetQueueTime()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+SQLOperationQueueStats::SQLOperationQueueStats() : Depth(0), MaxDepth(0), Processed(0), Batches(0), BatchedStatements(0), BatchRoundTrips(0)
+{
+    for (uint32 i = 0; i < WAIT_BUCKETS; ++i)
+    {
+        Waits[i] = 0;
+        Flushes[i] = 0;
+    }
+}
+
+void SQLOperationQueueStats::Add(SQLOperationQueueStats const& right)
+{
+    Depth += right.Depth;
+    MaxDepth = std::max(MaxDepth, right.MaxDepth);
+    Processed += right.Processed;
+    Batches += right.Batches;
+    BatchedStatements += right.BatchedStatements;
+    BatchRoundTrips += right.BatchRoundTrips;
+    for (uint32 i = 0; i < WAIT_BUCKETS; ++i)
+    {
+        Waits[i] += right.Waits[i];
+        Flushes[i] += right.Flushes[i];
+    }
+}
+
+uint32 SQLOperationQueueStats::GetBucket(uint64 ms)
+{
+    return std::min<uint32>(std::bit_width(ms), WAIT_BUCKETS - 1);
+}
+
+uint32 SQLOperationQueueStats::GetPercentile(uint64 const* buckets, float fraction)
+{
+    uint64 total = 0;
+    for (uint32 i = 0; i < WAIT_BUCKETS; ++i)
+        total += buckets[i];
+
+    if (!total)
+        return 0;
+
+    uint64 wanted = std::max<uint64>(1, uint64(total * fraction));
+    uint64 seen = 0;
+    for (uint32 i = 0; i < WAIT_BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= wanted)
+            return 1u << i;
+    }
+
+    return 1u << (WAIT_BUCKETS - 1);
+}
+
+SQLOperationQueue::SQLOperationQueue() : _head(&_stub), _tail(&_stub), _closed(false), _timedWaiting(false), _batchMaxStatements(0), _batchWindow(0),
+    _depth(0), _maxDepth(0), _processed(0), _batches(0), _batchedStatements(0), _batchRoundTrips(0)
+{
+    for (uint32 i = 0; i < SQLOperationQueueStats::WAIT_BUCKETS; ++i)
+    {
+        _waits[i].store(0, std::memory_order_relaxed);
+        _flushes[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+SQLOperationQueue::~SQLOperationQueue()
+{
+    //! Whatever was enqueued after Close() never ran
+    while (SQLOperation* op = Pop())
+        if (op != &_shutdown)
+            delete op;
+}
+
+void SQLOperationQueue::Enqueue(SQLOperation* op)
+{
+    op->m_queuedAt = GetQueueTime();
+
+    //! Counted before it is linked, so the depth never drops below the number of linked operations
+    uint32 depth = _depth.fetch_add(1, std::memory_order_seq_cst);
+
+    uint32 maxDepth = _maxDepth.load(std::memory_order_relaxed);
+    while (depth + 1 > maxDepth && !_maxDepth.compare_exchange_weak(maxDepth, depth + 1, std::memory_order_relaxed))
+        ;
+
+    Push(op);
+
+    if (!depth)
+    {
+        _depth.notify_one();
+
+        //! Ordered against the worker's store of the flag and load of the depth, one of both sees the other
+        if (_timedWaiting.load(std::memory_order_seq_cst))
+        {
+            std::lock_guard<std::mutex> lock(_timedWaitLock);
+            _timedWaitCondition.notify_one();
+        }
+    }
+}
+
+SQLOperation* SQLOperationQueue::Dequeue()
+{
+    for (;;)
+    {
+        if (SQLOperation* op = TryDequeue())
+            return op;
+
+        if (_closed)
+            return NULL;
+
+        //! Counted but not linked yet: a producer is between its two steps
+        if (_depth.load(std::memory_order_acquire))
+            std::this_thread::yield();
+        else
+            _depth.wait(0, std::memory_order_acquire);
+    }
+}
+
+SQLOperation* SQLOperationQueue::Dequeue(uint32 timeout)
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    for (;;)
+    {
+        if (SQLOperation* op = TryDequeue())
+            return op;
+
+        if (_closed)
+            return NULL;
+
+        if (_depth.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_timedWaitLock);
+        _timedWaiting.store(true, std::memory_order_seq_cst);
+        bool timedOut = !_depth.load(std::memory_order_seq_cst) && _timedWaitCondition.wait_until(lock, end) == std::cv_status::timeout;
+        _timedWaiting.store(false, std::memory_order_relaxed);
+
+        if (timedOut)
+            return TryDequeue();
+    }
+}
+
+SQLOperation* SQLOperationQueue::TryDequeue()
+{
+    if (_closed)
+        return NULL;
+
+    SQLOperation* op = Pop();
+    if (!op)
+        return NULL;
+
+    _depth.fetch_sub(1, std::memory_order_relaxed);
+
+    if (op == &_shutdown)
+    {
+        _closed = true;
+        return NULL;
+    }
+
+    uint64 waitMs = (GetQueueTime() - op->m_queuedAt) / 1000;
+    _waits[SQLOperationQueueStats::GetBucket(waitMs)].fetch_add(1, std::memory_order_relaxed);
+    _processed.fetch_add(1, std::memory_order_relaxed);
+    return op;
+}
+
+void SQLOperationQueue::Close()
+{
+    Enqueue(&_shutdown);
+}
+
+void SQLOperationQueue::RecordBatch(uint32 statements, uint32 roundTrips, uint32 flushTime)
+{
+    _batches.fetch_add(1, std::memory_order_relaxed);
+    _batchedStatements.fetch_add(statements, std::memory_order_relaxed);
+    _batchRoundTrips.fetch_add(roundTrips, std::memory_order_relaxed);
+    _flushes[SQLOperationQueueStats::GetBucket(flushTime)].fetch_add(1, std::memory_order_relaxed);
+}
+
+SQLOperationQueueStats SQLOperationQueue::GetStats() const
+{
+    SQLOperationQueueStats stats;
+    stats.Depth = _depth.load(std::memory_order_relaxed);
+    stats.MaxDepth = _maxDepth.load(std::memory_order_relaxed);
+    stats.Processed = _processed.load(std::memory_order_relaxed);
+    stats.Batches = _batches.load(std::memory_order_relaxed);
+    stats.BatchedStatements = _batchedStatements.load(std::memory_order_relaxed);
+    stats.BatchRoundTrips = _batchRoundTrips.load(std::memory_order_relaxed);
+    for (uint32 i = 0; i < SQLOperationQueueStats::WAIT_BUCKETS; ++i)
+    {
+        stats.Waits[i] = _waits[i].load(std::memory_order_relaxed);
+        stats.Flushes[i] = _flushes[i].load(std::memory_order_relaxed);
+    }
+
+    return stats;
+}
+
+void SQLOperationQueue::Push(SQLOperation* op)
+{
+    op->m_queueNext.store(NULL, std::memory_order_relaxed);
+    SQLOperation* prev = _head.exchange(op, std::memory_order_acq_rel);
+    prev->m_queueNext.store(op, std::memory_order_release);
+}
+
+SQLOperation* SQLOperationQueue::Pop()
+{
+    SQLOperation* tail = _tail;
+    SQLOperation* next = tail->m_queueNext.load(std::memory_order_acquire);
+
+    if (tail == &_stub)
+    {
+        if (!next)
+            return NULL;
+
+        _tail = next;
+        tail = next;
+        next = next->m_queueNext.load(std::memory_order_acquire);
+    }
+
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    //! tail is not the last operation, the one behind it is not linked yet
+    if (tail != _head.load(std::memory_order_acquire))
+        return NULL;
+
+    //! tail is the last operation, put the stub behind it so it can be taken
+    Push(&_stub);
+
+    next = tail->m_queueNext.load(std::memory_order_acquire);
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    return NULL;
+}
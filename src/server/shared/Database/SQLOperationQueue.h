@@ -0,0 +1,119 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef _SQLOPERATIONQUEUE_H
+#define _SQLOPERATIONQUEUE_H
+
+#include "SQLOperation.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+struct SQLOperationQueueStats
+{
+    //! Bucket i counts waits below 2^i ms, the last bucket everything longer.
+    static uint32 const WAIT_BUCKETS = 12;
+
+    SQLOperationQueueStats();
+
+    void Add(SQLOperationQueueStats const& right);
+
+    //! Upper bound in ms of the bucket holding the given fraction (0..1] of all waits.
+    uint32 GetWaitPercentile(float fraction) const { return GetPercentile(Waits, fraction); }
+    //! Same for the time batches took from their first statement to the commit.
+    uint32 GetFlushPercentile(float fraction) const { return GetPercentile(Flushes, fraction); }
+
+    static uint32 GetBucket(uint64 ms);
+    static uint32 GetPercentile(uint64 const* buckets, float fraction);
+
+    uint32 Depth;                                       //! Operations waiting right now
+    uint32 MaxDepth;                                    //! Highest depth seen
+    uint64 Processed;                                   //! Operations handed to the worker
+    uint64 Waits[WAIT_BUCKETS];                         //! Time from Enqueue() to the worker taking it
+
+    uint64 Batches;                                     //! Runs of one-way statements executed together
+    uint64 BatchedStatements;                           //! Statements in those runs
+    uint64 BatchRoundTrips;                             //! Server round trips they took, transaction begin and commit included
+    uint64 Flushes[WAIT_BUCKETS];                       //! Execution time of the batches
+};
+
+/*! Queue of one asynchronous connection.
+
+    Any thread may Enqueue(), only the connection's DatabaseWorker calls Dequeue().
+    Producers link operations with one atomic exchange and never take a lock, the
+    worker sleeps on the depth counter while the queue is empty. Only a worker waiting
+    with a timeout is woken through the condition variable, producers lock nothing otherwise. */
+class SQLOperationQueue
+{
+public:
+    SQLOperationQueue();
+    ~SQLOperationQueue();
+
+    void Enqueue(SQLOperation* op);
+
+    //! Blocks until an operation is available. Returns NULL once Close() was reached.
+    SQLOperation* Dequeue();
+
+    //! Blocks at most timeout ms. Returns NULL if nothing arrived or Close() was reached.
+    SQLOperation* Dequeue(uint32 timeout);
+
+    //! Next operation if one is linked already, never blocks.
+    SQLOperation* TryDequeue();
+
+    //! True once the worker reached the Close() marker.
+    bool IsClosed() const { return _closed; }
+
+    //! Operations enqueued before still run, the worker stops after them.
+    void Close();
+
+    uint32 GetDepth() const { return _depth.load(std::memory_order_relaxed); }
+    SQLOperationQueueStats GetStats() const;
+
+    //! The worker groups up to maxStatements consecutive one-way statements into one transaction,
+    //! waiting at most window ms for more to arrive. 0 or 1 statements disables batching.
+    void SetBatchLimits(uint32 maxStatements, uint32 window) { _batchMaxStatements = maxStatements; _batchWindow = window; }
+    uint32 GetBatchMaxStatements() const { return _batchMaxStatements; }
+    uint32 GetBatchWindow() const { return _batchWindow; }
+
+    void RecordBatch(uint32 statements, uint32 roundTrips, uint32 flushTime);
+
+private:
+    class MarkerOperation : public SQLOperation
+    {
+        bool Execute() { return true; }
+    };
+
+    void Push(SQLOperation* op);
+    SQLOperation* Pop();
+
+    std::atomic<SQLOperation*> _head;                   //! Last linked operation, producers swap themselves in here
+    SQLOperation* _tail;                                //! Next operation to pop, only touched by the worker
+    MarkerOperation _stub;                              //! Keeps the list non empty
+    MarkerOperation _shutdown;
+    bool _closed;                                       //! Only touched by the worker
+
+    std::atomic<bool> _timedWaiting;                    //! Worker sleeps in Dequeue(timeout)
+    std::mutex _timedWaitLock;
+    std::condition_variable _timedWaitCondition;
+
+    uint32 _batchMaxStatements;
+    uint32 _batchWindow;
+
+    std::atomic<uint32> _depth;
+    std::atomic<uint32> _maxDepth;
+    std::atomic<uint64> _processed;
+    std::atomic<uint64> _waits[SQLOperationQueueStats::WAIT_BUCKETS];
+
+    std::atomic<uint64> _batches;
+    std::atomic<uint64> _batchedStatements;
+    std::atomic<uint64> _batchRoundTrips;
+    std::atomic<uint64> _flushes[SQLOperationQueueStats::WAIT_BUCKETS];
+
+    SQLOperationQueue(SQLOperationQueue const& right) = delete;
+    SQLOperationQueue& operator=(SQLOperationQueue const& right) = delete;
+};
+
+#endif
@@ -66,7 +66,7 @@ bool TransactionTask::Execute()
     if (m_conn->ExecuteTransaction(m_trans))
         return true;
 
-    if (m_conn->GetLastError() == 1213)
+    if (m_conn->GetLastError() == 1213 || m_conn->IsTransactionLost())
     {
         uint8 loopBreaker = 5;  // Handle MySQL Errno 1213 without extending deadlock to the core itself
         for (uint8 i = 0; i < loopBreaker; ++i)
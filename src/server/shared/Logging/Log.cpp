@@ -9,14 +9,13 @@
 #include "Common.h"
 #include "Config.h"
 #include "Log.h"
-#include "LogOperation.h"
 #include "Util.h"
 
 #include <cstdarg>
 #include <cstdio>
 #include <sstream>
 
-Log::Log() : worker(NULL)
+Log::Log() : worker(NULL), m_generation(0)
 {
     m_logsTimestamp = "_" + GetTimestampStr();
     LoadFromConfig();
@@ -247,11 +246,40 @@ void Log::ReadLoggersFromConfig()
     }
 }
 
-void Log::vlog(std::string const& filter, LogLevel level, char const* str, va_list argptr)
+uint64 Log::ResolveFilter(LogFilter& filter) const
 {
+    uint32 generation = m_generation.load(std::memory_order_acquire);
+    Logger const* logger = GetLoggerByType(filter.GetName());
+    LogLevel level = logger ? logger->getLogLevel() : LogLevel::LOG_LEVEL_DISABLED;
+
+    uint64 state = (uint64(generation) << 8) | uint64(level);
+    filter._logger.store(logger, std::memory_order_relaxed);
+    filter._state.store(state, std::memory_order_release);
+    return state;
+}
+
+void Log::vlog(LogFilter const& filter, LogLevel level, char const* str, va_list argptr)
+{
+    Logger const* logger = filter._logger.load(std::memory_order_relaxed);
+    if (worker)
+    {
+        worker->Enqueue(logger, filter.GetName(), level, str, argptr);
+        return;
+    }
+
+    // Keeps the capacity of its strings, so synchronous logging stops allocating once warmed up
+    static thread_local LogMessage msg(LogLevel::LOG_LEVEL_DISABLED, "", "");
+
     char text[MAX_QUERY_LEN];
     vsnprintf(text, MAX_QUERY_LEN, str, argptr);
-    write(new LogMessage(level, filter, text));
+
+    msg.level = level;
+    msg.type.assign(filter.GetName());
+    msg.text.assign(text);
+    msg.text.push_back('\n');
+    msg.param1.clear();
+    msg.mtime = time(NULL);
+    logger->write(msg);
 }
 
 void Log::write(LogMessage* msg) const
@@ -260,7 +288,7 @@ void Log::write(LogMessage* msg) const
     msg->text.append("\n");
 
     if (worker)
-        worker->enqueue(new LogOperation(logger, msg));
+        worker->Enqueue(logger, msg);
     else
     {
         logger->write(*msg);
@@ -294,6 +322,7 @@ bool Log::SetLogLevel(std::string const& name, const char* newLevelc, bool isLog
             return false;
 
         it->second.setLogLevel(newLevel);
+        ++m_generation;
     }
     else
     {
@@ -309,7 +338,7 @@ bool Log::SetLogLevel(std::string const& name, const char* newLevelc, bool isLog
 
 void Log::outCharDump(char const* str, uint32 accountId, uint32 guid, char const* name)
 {
-    if (!str || !ShouldLog("entities.player.dump", LogLevel::LOG_LEVEL_INFO))
+    if (!str || !SF_LOG_ENABLED("entities.player.dump", LogLevel::LOG_LEVEL_INFO))
         return;
 
     std::ostringstream ss;
@@ -327,7 +356,7 @@ void Log::outCharDump(char const* str, uint32 accountId, uint32 guid, char const
 
 void Log::outCommand(uint32 account, const char* str, ...)
 {
-    if (!str || !ShouldLog("commands.gm", LogLevel::LOG_LEVEL_INFO))
+    if (!str || !SF_LOG_ENABLED("commands.gm", LogLevel::LOG_LEVEL_INFO))
         return;
 
     va_list ap;
@@ -356,6 +385,7 @@ void Log::Close()
 {
     delete worker;
     worker = NULL;
+    ++m_generation;
     loggers.clear();
     for (AppenderMap::iterator it = appenders.begin(); it != appenders.end(); ++it)
     {
@@ -380,4 +410,5 @@ void Log::LoadFromConfig()
 
     ReadAppendersFromConfig();
     ReadLoggersFromConfig();
+    ++m_generation;
 }
@@ -13,10 +13,34 @@
 #include "LogWorker.h"
 
 #include <ace/Singleton.h>
+#include <atomic>
 #include <string>
 
 #define LOGGER_ROOT "root"
 
+/*! Logger resolved for one SF_LOG_* call site.
+
+    Walking the dotted filter hierarchy up to a configured logger builds strings
+    and hashes every level, so the result is cached here with the logger's level.
+    It stays valid until LoadFromConfig() or SetLogLevel() starts a new generation. */
+class LogFilter
+{
+    friend class Log;
+
+public:
+    constexpr explicit LogFilter(char const* name) : _name(name), _state(0), _logger(NULL) { }
+
+    char const* GetName() const { return _name; }
+
+private:
+    char const* _name;
+    std::atomic<uint64> _state;                         //! Generation in the high bits, LogLevel in the low byte
+    std::atomic<Logger const*> _logger;
+
+    LogFilter(LogFilter const& right) = delete;
+    LogFilter& operator=(LogFilter const& right) = delete;
+};
+
 class Log
 {
     friend class ACE_Singleton<Log, ACE_Thread_Mutex>;
@@ -31,9 +55,10 @@ public:
     void LoadFromConfig();
     void Close();
     bool ShouldLog(std::string const& type, LogLevel level) const;
+    bool ShouldLog(LogFilter& filter, LogLevel level) const;
     bool SetLogLevel(std::string const& name, char const* level, bool isLogger = true);
 
-    void outMessage(std::string const& f, LogLevel level, char const* str, ...) ATTR_PRINTF(4, 5);
+    void outMessage(LogFilter const& filter, LogLevel level, char const* str, ...) ATTR_PRINTF(4, 5);
 
     void outCommand(uint32 account, const char* str, ...) ATTR_PRINTF(3, 4);
     void outCharDump(char const* str, uint32 account_id, uint32 guid, char const* name);
@@ -42,10 +67,11 @@ public:
 
 private:
     static std::string GetTimestampStr();
-    void vlog(std::string const& f, LogLevel level, char const* str, va_list argptr);
+    void vlog(LogFilter const& filter, LogLevel level, char const* str, va_list argptr);
     void write(LogMessage* msg) const;
 
     Logger const* GetLoggerByType(std::string const& type) const;
+    uint64 ResolveFilter(LogFilter& filter) const;
     Appender* GetAppenderByName(std::string const& name);
     uint8 NextAppenderId();
     void CreateAppenderFromConfig(std::string const& name);
@@ -61,6 +87,7 @@ private:
     std::string m_logsTimestamp;
 
     LogWorker* worker;
+    std::atomic<uint32> m_generation;                   //! Cached LogFilter states of older generations are stale
 };
 
 inline Logger const* Log::GetLoggerByType(std::string const& type) const
@@ -82,10 +109,7 @@ inline Logger const* Log::GetLoggerByType(std::string const& type) const
 
 inline bool Log::ShouldLog(std::string const& type, LogLevel level) const
 {
-    // TODO: Use cache to store "Type.sub1.sub2": "Type" equivalence, should
-    // Speed up in cases where requesting "Type.sub1.sub2" but only configured
-    // Logger "Type"
-
+    // Resolves the hierarchy on every call, use SF_LOG_ENABLED where the filter is a literal
     Logger const* logger = GetLoggerByType(type);
     if (!logger)
         return false;
@@ -94,7 +118,17 @@ inline bool Log::ShouldLog(std::string const& type, LogLevel level) const
     return logLevel != LogLevel::LOG_LEVEL_DISABLED && logLevel <= level;
 }
 
-inline void Log::outMessage(std::string const& filter, LogLevel level, const char* str, ...)
+inline bool Log::ShouldLog(LogFilter& filter, LogLevel level) const
+{
+    uint64 state = filter._state.load(std::memory_order_acquire);
+    if (uint32(state >> 8) != m_generation.load(std::memory_order_relaxed))
+        state = ResolveFilter(filter);
+
+    LogLevel logLevel = LogLevel(state & 0xFF);
+    return logLevel != LogLevel::LOG_LEVEL_DISABLED && logLevel <= level;
+}
+
+inline void Log::outMessage(LogFilter const& filter, LogLevel level, const char* str, ...)
 {
     va_list ap;
     va_start(ap, str);
@@ -107,26 +141,33 @@ inline void Log::outMessage(std::string const& filter, LogLevel level, const cha
 #if COMPILER != COMPILER_MICROSOFT
 #define SF_LOG_MESSAGE_BODY(filterType__, level__, ...)                 \
         do {                                                            \
-            if (sLog->ShouldLog(filterType__, level__))                 \
-                sLog->outMessage(filterType__, level__, __VA_ARGS__);   \
+            static LogFilter sfLogFilter__("" filterType__);            \
+            if (sLog->ShouldLog(sfLogFilter__, level__))                \
+                sLog->outMessage(sfLogFilter__, level__, __VA_ARGS__);  \
         } while (0)
 #elif COMPILER != COMPILER_CLANG
 #define SF_LOG_MESSAGE_BODY(filterType__, level__, ...)                 \
         do {                                                            \
-            if (sLog->ShouldLog(filterType__, level__))                 \
-                sLog->outMessage(filterType__, level__, __VA_ARGS__);   \
+            static LogFilter sfLogFilter__("" filterType__);            \
+            if (sLog->ShouldLog(sfLogFilter__, level__))                \
+                sLog->outMessage(sfLogFilter__, level__, __VA_ARGS__);  \
         } while (0)
 #else
 #define SF_LOG_MESSAGE_BODY(filterType__, level__, ...)                 \
         __pragma(warning(push))                                         \
         __pragma(warning(disable:4127))                                 \
         do {                                                            \
-            if (sLog->ShouldLog(filterType__, level__))                 \
-                sLog->outMessage(filterType__, level__, __VA_ARGS__);   \
+            static LogFilter sfLogFilter__("" filterType__);            \
+            if (sLog->ShouldLog(sfLogFilter__, level__))                \
+                sLog->outMessage(sfLogFilter__, level__, __VA_ARGS__);  \
         } while (0)                                                     \
         __pragma(warning(pop))
 #endif
 
+// Level check for callers preparing expensive output themselves, filterType__ must be a literal
+#define SF_LOG_ENABLED(filterType__, level__)                                                           \
+    sLog->ShouldLog([]() -> LogFilter& { static LogFilter sfLogFilter__("" filterType__); return sfLogFilter__; }(), level__)
+
 #define SF_LOG_TRACE(filterType__, ...) \
     SF_LOG_MESSAGE_BODY(filterType__, LogLevel::LOG_LEVEL_TRACE, __VA_ARGS__)
 
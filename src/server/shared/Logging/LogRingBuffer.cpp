@@ -0,0 +1,109 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include "Errors.h"
+#include "LogRingBuffer.h"
+
+#include <algorithm>
+
+namespace
+{
+    struct LogRingBufferRegistry
+    {
+        std::mutex Lock;
+        std::vector<LogRingBuffer*> Buffers;
+    };
+
+    // Never destroyed, Log may still drain during static destruction
+    LogRingBufferRegistry& GetRegistry()
+    {
+        static LogRingBufferRegistry* registry = new LogRingBufferRegistry();
+        return *registry;
+    }
+}
+
+/// Marks the buffer of an exiting thread, the reader frees it after the last record.
+struct LogRingBufferOwner
+{
+    LogRingBufferOwner() : Buffer(NULL) { }
+
+    ~LogRingBufferOwner()
+    {
+        if (Buffer)
+            Buffer->_orphaned.store(true, std::memory_order_release);
+    }
+
+    LogRingBuffer* Buffer;
+};
+
+LogRingBuffer::LogRingBuffer() : _buffer(new char[BUFFER_SIZE]), _write(0), _head(0), _tail(0), _orphaned(false) { }
+
+LogRingBuffer::~LogRingBuffer()
+{
+    delete[] _buffer;
+}
+
+LogRingBuffer* LogRingBuffer::GetThreadBuffer()
+{
+    static thread_local LogRingBufferOwner owner;
+    if (!owner.Buffer)
+    {
+        owner.Buffer = new LogRingBuffer();
+
+        LogRingBufferRegistry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.Lock);
+        registry.Buffers.push_back(owner.Buffer);
+    }
+
+    return owner.Buffer;
+}
+
+void LogRingBuffer::GetBuffers(std::vector<LogRingBuffer*>& buffers)
+{
+    LogRingBufferRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.Lock);
+    buffers.assign(registry.Buffers.begin(), registry.Buffers.end());
+}
+
+void LogRingBuffer::CollectOrphans()
+{
+    LogRingBufferRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.Lock);
+    registry.Buffers.erase(std::remove_if(registry.Buffers.begin(), registry.Buffers.end(), [](LogRingBuffer* buffer)
+    {
+        if (!buffer->_orphaned.load(std::memory_order_acquire) || !buffer->IsEmpty())
+            return false;
+
+        delete buffer;
+        return true;
+    }), registry.Buffers.end());
+}
+
+LogRecord* LogRingBuffer::Reserve(uint32 size)
+{
+    ASSERT(size <= MAX_RECORD_SIZE);
+
+    uint64 head = _head.load(std::memory_order_relaxed);
+    uint32 offset = uint32(head % BUFFER_SIZE);
+    uint32 padding = offset + size > BUFFER_SIZE ? BUFFER_SIZE - offset : 0;
+    if (head + padding + size - _tail.load(std::memory_order_acquire) > BUFFER_SIZE)
+        return NULL;
+
+    // Tails shorter than a header are skipped by the reader without a marker
+    if (padding >= sizeof(LogRecord))
+    {
+        LogRecord* marker = reinterpret_cast<LogRecord*>(_buffer + offset);
+        marker->Size = padding;
+        marker->Level = LogLevel::LOG_LEVEL_DISABLED;
+    }
+
+    _write = head + padding;
+    return reinterpret_cast<LogRecord*>(_buffer + uint32(_write % BUFFER_SIZE));
+}
+
+void LogRingBuffer::Commit(uint32 size)
+{
+    _head.store(_write + size, std::memory_order_release);
+}
@@ -0,0 +1,110 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef LOGRINGBUFFER_H
+#define LOGRINGBUFFER_H
+
+#include "Appender.h"
+
+#include <atomic>
+#include <vector>
+
+class Logger;
+
+/*! Header of one record in a LogRingBuffer.
+
+    The filter name and the formatted text follow the header directly. Records
+    built by the caller (char dumps, GM commands) only carry the message pointer. */
+struct LogRecord
+{
+    uint32 Size;                                        //! Whole record including header and alignment
+    LogLevel Level;                                     //! LOG_LEVEL_DISABLED marks the padding before a wrap
+    uint32 TypeSize;
+    uint32 TextSize;
+    time_t Time;
+    Logger const* Owner;
+    LogMessage* Message;                                //! Owned by the record if set
+
+    char const* GetType() const { return reinterpret_cast<char const*>(this + 1); }
+    char const* GetText() const { return GetType() + TypeSize; }
+};
+
+/*! Single producer, single consumer byte ring of log records.
+
+    Every thread logging while Log.Async.Enable is set formats its messages into
+    its own buffer, LogWorker is the only reader. Positions only grow, the offset
+    into the buffer is the position modulo BUFFER_SIZE. */
+class LogRingBuffer
+{
+public:
+    enum
+    {
+        BUFFER_SIZE = 256 * 1024,
+        //! Records never exceed this, so a full buffer always drains before a writer can stall forever
+        MAX_RECORD_SIZE = BUFFER_SIZE / 4
+    };
+
+    static uint32 GetRecordSize(uint32 payload) { return (uint32(sizeof(LogRecord)) + payload + 7) & ~uint32(7); }
+
+    //! Buffer of the calling thread, created and registered on first use.
+    static LogRingBuffer* GetThreadBuffer();
+    //! Snapshot of all registered buffers, the pointers stay valid until CollectOrphans().
+    static void GetBuffers(std::vector<LogRingBuffer*>& buffers);
+    //! Frees the buffers of threads that exited once they are drained. Consumer only.
+    static void CollectOrphans();
+
+    //! Contiguous space for a record of up to size bytes, NULL while the reader is too far behind.
+    LogRecord* Reserve(uint32 size);
+    //! Publishes the record returned by the last Reserve(), size may be smaller than reserved.
+    void Commit(uint32 size);
+
+    //! Hands every published record to the callback in order. Returns false if there was none.
+    template<class Callback>
+    bool Drain(Callback&& callback)
+    {
+        uint64 tail = _tail.load(std::memory_order_relaxed);
+        uint64 head = _head.load(std::memory_order_acquire);
+        if (tail == head)
+            return false;
+
+        while (tail != head)
+        {
+            uint32 offset = uint32(tail % BUFFER_SIZE);
+            uint32 remaining = BUFFER_SIZE - offset;
+            if (remaining < sizeof(LogRecord))
+                tail += remaining;
+            else
+            {
+                LogRecord const* record = reinterpret_cast<LogRecord const*>(_buffer + offset);
+                if (record->Level != LogLevel::LOG_LEVEL_DISABLED)
+                    callback(*record);
+                tail += record->Size;
+            }
+
+            _tail.store(tail, std::memory_order_release);
+        }
+
+        return true;
+    }
+
+private:
+    LogRingBuffer();
+    ~LogRingBuffer();
+
+    bool IsEmpty() const { return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire); }
+
+    friend struct LogRingBufferOwner;
+
+    char* _buffer;
+    uint64 _write;                                      //! Start of the reserved record, only touched by the writer
+    std::atomic<uint64> _head;                          //! End of the published records
+    std::atomic<uint64> _tail;                          //! End of the records the reader is done with
+    std::atomic<bool> _orphaned;                        //! Writer thread exited
+
+    LogRingBuffer(LogRingBuffer const& right) = delete;
+    LogRingBuffer& operator=(LogRingBuffer const& right) = delete;
+};
+
+#endif
@@ -3,35 +3,142 @@
 * See LICENSE.md file for Copyright information
 */
 
+#include "Common.h"
+#include "Logger.h"
+#include "LogRingBuffer.h"
 #include "LogWorker.h"
 
-LogWorker::LogWorker()
-    : m_queue(HIGH_WATERMARK, LOW_WATERMARK)
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+LogWorker::LogWorker() : _published(0), _sleeping(false), _stopping(false), _message(LogLevel::LOG_LEVEL_DISABLED, "", "")
 {
     ACE_Task_Base::activate(THR_NEW_LWP | THR_JOINABLE | THR_INHERIT_SCHED, 1);
 }
 
 LogWorker::~LogWorker()
 {
-    m_queue.deactivate();
+    _stopping.store(true);
+    Notify();
     wait();
 }
 
-int LogWorker::enqueue(LogOperation* op)
+void LogWorker::Enqueue(Logger const* logger, char const* type, LogLevel level, char const* str, va_list argptr)
+{
+    uint32 typeSize = uint32(strlen(type));
+    uint32 reserved = LogRingBuffer::GetRecordSize(typeSize + MAX_QUERY_LEN);
+
+    LogRingBuffer* buffer = LogRingBuffer::GetThreadBuffer();
+    LogRecord* record;
+    while (!(record = buffer->Reserve(reserved)))
+    {
+        Notify();
+        std::this_thread::yield();
+    }
+
+    char* text = const_cast<char*>(record->GetType()) + typeSize;
+    memcpy(const_cast<char*>(record->GetType()), type, typeSize);
+
+    int length = vsnprintf(text, MAX_QUERY_LEN, str, argptr);
+    if (length < 0)
+        length = 0;
+    else if (length >= MAX_QUERY_LEN)
+        length = MAX_QUERY_LEN - 1;
+
+    record->Size = LogRingBuffer::GetRecordSize(typeSize + length);
+    record->Level = level;
+    record->TypeSize = typeSize;
+    record->TextSize = length;
+    record->Time = time(NULL);
+    record->Owner = logger;
+    record->Message = NULL;
+
+    buffer->Commit(record->Size);
+    Notify();
+}
+
+void LogWorker::Enqueue(Logger const* logger, LogMessage* msg)
+{
+    uint32 size = LogRingBuffer::GetRecordSize(0);
+
+    LogRingBuffer* buffer = LogRingBuffer::GetThreadBuffer();
+    LogRecord* record;
+    while (!(record = buffer->Reserve(size)))
+    {
+        Notify();
+        std::this_thread::yield();
+    }
+
+    record->Size = size;
+    record->Level = msg->level;
+    record->TypeSize = 0;
+    record->TextSize = 0;
+    record->Time = msg->mtime;
+    record->Owner = logger;
+    record->Message = msg;
+
+    buffer->Commit(size);
+    Notify();
+}
+
+void LogWorker::Notify()
+{
+    // Pairs with the seq_cst store of _sleeping in svc(), either the worker
+    // sees the new count or we see it going to sleep and wake it
+    _published.fetch_add(1);
+    if (_sleeping.load())
+        _published.notify_one();
+}
+
+bool LogWorker::DrainBuffers()
 {
-    return m_queue.enqueue(op);
+    std::vector<LogRingBuffer*> buffers;
+    LogRingBuffer::GetBuffers(buffers);
+
+    bool drained = false;
+    for (LogRingBuffer* buffer : buffers)
+    {
+        drained |= buffer->Drain([this](LogRecord const& record)
+        {
+            if (record.Message)
+            {
+                if (record.Owner)
+                    record.Owner->write(*record.Message);
+                delete record.Message;
+                return;
+            }
+
+            _message.level = record.Level;
+            _message.type.assign(record.GetType(), record.TypeSize);
+            _message.text.assign(record.GetText(), record.TextSize);
+            _message.text.push_back('\n');
+            _message.mtime = record.Time;
+            record.Owner->write(_message);
+        });
+    }
+
+    LogRingBuffer::CollectOrphans();
+    return drained;
 }
 
 int LogWorker::svc()
 {
     while (1)
     {
-        LogOperation* request;
-        if (m_queue.dequeue(request) == -1)
+        uint32 published = _published.load();
+        if (DrainBuffers())
+            continue;
+
+        // Everything enqueued before the destructor ran is written
+        if (_stopping.load())
             break;
 
-        request->call();
-        delete request;
+        _sleeping.store(true);
+        if (_published.load() == published)
+            _published.wait(published);
+        _sleeping.store(false);
     }
 
     return 0;
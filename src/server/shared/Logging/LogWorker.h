@@ -6,30 +6,39 @@
 #ifndef LOGWORKER_H
 #define LOGWORKER_H
 
-#include "LogOperation.h"
+#include "Appender.h"
 
-#include <ace/Activation_Queue.h>
 #include <ace/Task.h>
+#include <atomic>
+#include <cstdarg>
 
+class Logger;
+
+/*! Writes log messages of all threads to their appenders.
+
+    Producers format straight into a LogRingBuffer of their own thread, so an
+    enabled message costs one vsnprintf and no allocation or lock. The worker
+    drains the buffers of all threads and sleeps while all of them are empty. */
 class LogWorker : protected ACE_Task_Base
 {
 public:
     LogWorker();
     ~LogWorker();
 
-    typedef ACE_Message_Queue_Ex<LogOperation, ACE_MT_SYNCH> LogMessageQueueType;
-
-    enum
-    {
-        HIGH_WATERMARK = 8 * 1024 * 1024,
-        LOW_WATERMARK = 8 * 1024 * 1024
-    };
-
-    int enqueue(LogOperation* op);
+    void Enqueue(Logger const* logger, char const* type, LogLevel level, char const* str, va_list argptr);
+    //! For messages built by the caller, takes ownership of msg.
+    void Enqueue(Logger const* logger, LogMessage* msg);
 
 private:
     virtual int svc();
-    LogMessageQueueType m_queue;
+
+    bool DrainBuffers();
+    void Notify();
+
+    std::atomic<uint32> _published;                     //! Bumped after every record, the worker waits on it
+    std::atomic<bool> _sleeping;
+    std::atomic<bool> _stopping;
+    LogMessage _message;                                //! Reused for every record of the ring buffers
 };
 
 #endif
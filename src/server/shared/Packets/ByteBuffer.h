@@ -14,6 +14,7 @@
 #endif
 #endif
 
+#include "ByteBufferStorage.h"
 #include "ByteConverter.h"
 #include "Define.h"
 #include "Errors.h"
@@ -771,9 +772,22 @@ public:
     void hexlike() const;
 
 protected:
+    // keeps up to inlineSize bytes in inlineData, owned by the derived class
+    ByteBuffer(size_t reserve, uint8* inlineData, size_t inlineSize) : _rpos(0), _wpos(0), _bitpos(8), _curbitval(0),
+        _storage(inlineData, inlineSize)
+    {
+        _storage.reserve(reserve);
+    }
+
+    ByteBuffer(const ByteBuffer& buf, uint8* inlineData, size_t inlineSize) : _rpos(buf._rpos), _wpos(buf._wpos),
+        _bitpos(buf._bitpos), _curbitval(buf._curbitval), _storage(inlineData, inlineSize)
+    {
+        _storage = buf._storage;
+    }
+
     size_t _rpos, _wpos, _bitpos;
     uint8 _curbitval;
-    std::vector<uint8> _storage;
+    ByteBufferStorage _storage;
 };
 
 template <typename T>
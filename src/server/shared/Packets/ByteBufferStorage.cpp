@@ -0,0 +1,191 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#include "ByteBufferStorage.h"
+
+#include <atomic>
+#include <bit>
+#include <mutex>
+
+namespace
+{
+    size_t const BLOCK_CLASS_COUNT = std::countr_zero(ByteBufferPool::MAX_BLOCK_SIZE) - std::countr_zero(ByteBufferPool::MIN_BLOCK_SIZE) + 1;
+
+    std::atomic<uint64> sPoolHits(0);
+    std::atomic<uint64> sSharedHits(0);
+    std::atomic<uint64> sPoolMisses(0);
+    std::atomic<uint64> sInlineBuffers(0);
+
+    struct FreeBlocks
+    {
+        uint8* Blocks[ByteBufferPool::MAX_FREE_BLOCKS];
+        size_t Count;
+    };
+
+    struct ThreadBlockCache
+    {
+        ThreadBlockCache();
+        ~ThreadBlockCache();
+
+        FreeBlocks Classes[BLOCK_CLASS_COUNT];
+    };
+
+    // blocks handed over between threads, e.g. from the network thread back to the map threads
+    struct SharedBlockCache
+    {
+        SharedBlockCache();
+        ~SharedBlockCache();
+
+        bool Push(size_t blockClass, uint8* block);
+        uint8* Pop(size_t blockClass);
+
+        std::mutex Lock;
+        uint8* Blocks[BLOCK_CLASS_COUNT][ByteBufferPool::MAX_SHARED_BLOCKS];
+        size_t Count[BLOCK_CLASS_COUNT];
+    };
+
+    // buffers may still be released by other thread_local or static objects after the cache is gone
+    thread_local bool sCacheDestroyed = false;
+    thread_local ThreadBlockCache sCache;
+    bool sSharedCacheDestroyed = false;
+    SharedBlockCache sSharedCache;
+
+    ThreadBlockCache::ThreadBlockCache()
+    {
+        for (size_t i = 0; i < BLOCK_CLASS_COUNT; ++i)
+            Classes[i].Count = 0;
+    }
+
+    ThreadBlockCache::~ThreadBlockCache()
+    {
+        for (size_t i = 0; i < BLOCK_CLASS_COUNT; ++i)
+            while (Classes[i].Count)
+                delete[] Classes[i].Blocks[--Classes[i].Count];
+
+        sCacheDestroyed = true;
+    }
+
+    SharedBlockCache::SharedBlockCache()
+    {
+        for (size_t i = 0; i < BLOCK_CLASS_COUNT; ++i)
+            Count[i] = 0;
+    }
+
+    SharedBlockCache::~SharedBlockCache()
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        for (size_t i = 0; i < BLOCK_CLASS_COUNT; ++i)
+            while (Count[i])
+                delete[] Blocks[i][--Count[i]];
+
+        sSharedCacheDestroyed = true;
+    }
+
+    bool SharedBlockCache::Push(size_t blockClass, uint8* block)
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        if (sSharedCacheDestroyed || Count[blockClass] >= ByteBufferPool::MAX_SHARED_BLOCKS)
+            return false;
+
+        Blocks[blockClass][Count[blockClass]++] = block;
+        return true;
+    }
+
+    uint8* SharedBlockCache::Pop(size_t blockClass)
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        if (sSharedCacheDestroyed || !Count[blockClass])
+            return NULL;
+
+        return Blocks[blockClass][--Count[blockClass]];
+    }
+
+    size_t GetBlockClass(size_t size)
+    {
+        return std::countr_zero(size) - std::countr_zero(ByteBufferPool::MIN_BLOCK_SIZE);
+    }
+}
+
+uint8* ByteBufferPool::Allocate(size_t& size)
+{
+    if (size > MAX_BLOCK_SIZE)
+    {
+        sPoolMisses.fetch_add(1, std::memory_order_relaxed);
+        return new uint8[size];
+    }
+
+    size = size <= MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : std::bit_ceil(size);
+    size_t blockClass = GetBlockClass(size);
+
+    if (!sCacheDestroyed)
+    {
+        FreeBlocks& freeBlocks = sCache.Classes[blockClass];
+        if (freeBlocks.Count)
+        {
+            sPoolHits.fetch_add(1, std::memory_order_relaxed);
+            return freeBlocks.Blocks[--freeBlocks.Count];
+        }
+    }
+
+    if (uint8* block = sSharedCache.Pop(blockClass))
+    {
+        sSharedHits.fetch_add(1, std::memory_order_relaxed);
+        return block;
+    }
+
+    sPoolMisses.fetch_add(1, std::memory_order_relaxed);
+    return new uint8[size];
+}
+
+void ByteBufferPool::Release(uint8* block, size_t size)
+{
+    if (size <= MAX_BLOCK_SIZE)
+    {
+        size_t blockClass = GetBlockClass(size);
+        if (!sCacheDestroyed)
+        {
+            FreeBlocks& freeBlocks = sCache.Classes[blockClass];
+            if (freeBlocks.Count < MAX_FREE_BLOCKS)
+            {
+                freeBlocks.Blocks[freeBlocks.Count++] = block;
+                return;
+            }
+        }
+
+        // the releasing thread has enough, leave it for the threads that build packets
+        if (sSharedCache.Push(blockClass, block))
+            return;
+    }
+
+    delete[] block;
+}
+
+void ByteBufferPool::CountInline()
+{
+    sInlineBuffers.fetch_add(1, std::memory_order_relaxed);
+}
+
+ByteBufferPoolStats ByteBufferPool::GetStats()
+{
+    ByteBufferPoolStats stats;
+    stats.Hits = sPoolHits.load(std::memory_order_relaxed);
+    stats.Shared = sSharedHits.load(std::memory_order_relaxed);
+    stats.Misses = sPoolMisses.load(std::memory_order_relaxed);
+    stats.Inline = sInlineBuffers.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ByteBufferStorage::Grow(size_t size)
+{
+    uint8* block = ByteBufferPool::Allocate(size);
+    if (_size)
+        std::memcpy(block, _data, _size);
+
+    if (!IsInline())
+        ByteBufferPool::Release(_data, _capacity);
+
+    _data = block;
+    _capacity = size;
+}
@@ -0,0 +1,168 @@
+/*
+* This file is part of Project SkyFire https://www.projectskyfire.org.
+* See LICENSE.md file for Copyright information
+*/
+
+#ifndef SF_BYTEBUFFERSTORAGE_H
+#define SF_BYTEBUFFERSTORAGE_H
+
+#include "Define.h"
+
+#include <cstring>
+
+struct ByteBufferPoolStats
+{
+    uint64 Hits;                                            // heap blocks reused from a thread's free list
+    uint64 Shared;                                          // heap blocks taken back from the shared free list
+    uint64 Misses;                                          // heap blocks that had to be allocated
+    uint64 Inline;                                          // buffers that never left their inline storage
+};
+
+/*
+ * Heap blocks for ByteBuffer storage, recycled through per-thread free lists.
+ *
+ * Blocks are sized in powers of two from MIN_BLOCK_SIZE to MAX_BLOCK_SIZE,
+ * larger requests go straight to the heap. A block returns to the free list
+ * of the thread that releases it, each list is capped at MAX_FREE_BLOCKS.
+ * Packets built by map threads and freed by the network thread fill the
+ * network thread's lists, so the excess goes to a shared, locked list of up
+ * to MAX_SHARED_BLOCKS per size that threads draw from once their own list
+ * is empty; only what overflows that one is deleted.
+ */
+class ByteBufferPool
+{
+public:
+    static size_t const MIN_BLOCK_SIZE = 512;
+    static size_t const MAX_BLOCK_SIZE = 64 * 1024;
+    static size_t const MAX_FREE_BLOCKS = 64;
+    static size_t const MAX_SHARED_BLOCKS = 256;
+
+    // returns a block of at least size bytes, its real size in size
+    static uint8* Allocate(size_t& size);
+    static void Release(uint8* block, size_t size);
+
+    static void CountInline();
+    static ByteBufferPoolStats GetStats();
+};
+
+/*
+ * Byte storage of a ByteBuffer. Up to INLINE_SIZE bytes are kept inside the
+ * object so that packed guids never touch the heap; larger contents move to
+ * a block from ByteBufferPool. Every ByteBuffer carries the inline bytes,
+ * Object::m_PackGUID and field buffers included, so they stay small. An owner
+ * expecting more, like WorldPacket, may hand in a larger inline area of its
+ * own instead. Mirrors the subset of std::vector<uint8> ByteBuffer relies on,
+ * growth keeps the existing bytes and zero-fills.
+ */
+class ByteBufferStorage
+{
+public:
+    static size_t const INLINE_SIZE = 32;
+
+    ByteBufferStorage() : _data(_inline), _size(0), _capacity(INLINE_SIZE), _inlineData(_inline), _inlineSize(INLINE_SIZE) { }
+
+    // inlineData must outlive the storage and is never copied along with it
+    ByteBufferStorage(uint8* inlineData, size_t inlineSize) : _data(inlineData), _size(0), _capacity(inlineSize),
+        _inlineData(inlineData), _inlineSize(inlineSize) { }
+
+    ByteBufferStorage(ByteBufferStorage const& right) : _data(_inline), _size(0), _capacity(INLINE_SIZE),
+        _inlineData(_inline), _inlineSize(INLINE_SIZE)
+    {
+        *this = right;
+    }
+
+    ByteBufferStorage(ByteBufferStorage&& right) : _data(_inline), _size(0), _capacity(INLINE_SIZE),
+        _inlineData(_inline), _inlineSize(INLINE_SIZE)
+    {
+        *this = static_cast<ByteBufferStorage&&>(right);
+    }
+
+    ~ByteBufferStorage()
+    {
+        if (!IsInline())
+            ByteBufferPool::Release(_data, _capacity);
+        else if (_size)
+            ByteBufferPool::CountInline();
+    }
+
+    ByteBufferStorage& operator=(ByteBufferStorage const& right)
+    {
+        if (this == &right)
+            return *this;
+
+        _size = 0;
+        reserve(right._size);
+        if (right._size)
+            std::memcpy(_data, right._data, right._size);
+        _size = right._size;
+        return *this;
+    }
+
+    ByteBufferStorage& operator=(ByteBufferStorage&& right)
+    {
+        if (this == &right)
+            return *this;
+
+        if (right.IsInline())
+        {
+            *this = static_cast<ByteBufferStorage const&>(right);
+            right._size = 0;
+            return *this;
+        }
+
+        // take over the heap block, right falls back to its inline storage
+        if (!IsInline())
+            ByteBufferPool::Release(_data, _capacity);
+
+        _data = right._data;
+        _size = right._size;
+        _capacity = right._capacity;
+
+        right._data = right._inlineData;
+        right._size = 0;
+        right._capacity = right._inlineSize;
+        return *this;
+    }
+
+    uint8& operator[](size_t pos) { return _data[pos]; }
+    uint8 const& operator[](size_t pos) const { return _data[pos]; }
+
+    uint8* data() { return _data; }
+    uint8 const* data() const { return _data; }
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    void clear() { _size = 0; }
+
+    void reserve(size_t size)
+    {
+        if (size > _capacity)
+            Grow(size);
+    }
+
+    void resize(size_t size, uint8 value = 0)
+    {
+        if (size > _capacity)
+            Grow(size > _capacity * 2 ? size : _capacity * 2);
+
+        if (size > _size)
+            std::memset(_data + _size, value, size - _size);
+
+        _size = size;
+    }
+
+private:
+    bool IsInline() const { return _data == _inlineData; }
+    void Grow(size_t size);
+
+    uint8* _data;
+    size_t _size;
+    size_t _capacity;
+    uint8* _inlineData;
+    size_t _inlineSize;
+    uint8 _inline[INLINE_SIZE];
+};
+
+#endif
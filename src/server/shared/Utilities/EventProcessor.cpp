@@ -5,33 +5,254 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+EventProcessor::WheelLevel::WheelLevel()
+{
+    std::fill_n(slots, size_t(WHEEL_SLOTS), static_cast<BasicEvent*>(NULL));
+}
+
+EventProcessor::EventProcessor() : m_time(0), m_aborting(false), m_wheelTime(0), m_cascadeTime(~uint64(0)), m_late(NULL), m_near(NULL), m_nearTime(0), m_overflow(NULL)
+{
+    std::fill_n(m_occupied, size_t(WHEEL_LEVELS - 1), uint64(0));
+    std::fill_n(m_levels, size_t(WHEEL_LEVELS - 1), static_cast<WheelLevel*>(NULL));
+}
+
+EventProcessor::~EventProcessor()
+{
+    KillAllEvents(true);
+
+    for (uint32 i = 0; i < WHEEL_LEVELS - 1; ++i)
+        delete m_levels[i];
+}
+
+void EventProcessor::Append(BasicEvent*& tail, BasicEvent* Event)
+{
+    if (tail)
+    {
+        Event->m_next = tail->m_next;
+        tail->m_next = Event;
+    }
+    else
+        Event->m_next = Event;
+
+    tail = Event;
+}
+
+BasicEvent* EventProcessor::PopFront(BasicEvent*& tail)
+{
+    BasicEvent* head = tail->m_next;
+    if (head == tail)
+        tail = NULL;
+    else
+        tail->m_next = head->m_next;
+
+    head->m_next = NULL;
+    return head;
+}
+
+void EventProcessor::Insert(BasicEvent* Event)
+{
+    if (Event->m_execTime < m_wheelTime)
+    {
+        InsertSorted(m_late, Event);
+        return;
+    }
+
+    // highest bit that differs from the wheel position selects the level
+    uint64 diff = Event->m_execTime ^ m_wheelTime;
+    if (diff < WHEEL_SLOTS)
+    {
+        InsertNear(Event);
+        return;
+    }
+
+    uint32 level = uint32(std::bit_width(diff) - 1) / WHEEL_SLOT_BITS;
+    if (level >= WHEEL_LEVELS)
+    {
+        Append(m_overflow, Event);
+        m_cascadeTime = std::min(m_cascadeTime, ((m_wheelTime >> WHEEL_SPAN_BITS) + 1) << WHEEL_SPAN_BITS);
+        return;
+    }
+
+    WheelLevel*& wheel = m_levels[level - 1];
+    if (!wheel)
+        wheel = new WheelLevel();
+
+    uint32 shift = level * WHEEL_SLOT_BITS;
+    uint32 slot = uint32(Event->m_execTime >> shift) & (WHEEL_SLOTS - 1);
+    Append(wheel->slots[slot], Event);
+    m_occupied[level - 1] |= uint64(1) << slot;
+    m_cascadeTime = std::min(m_cascadeTime, Event->m_execTime & ~((uint64(1) << shift) - 1));
+}
+
+void EventProcessor::InsertSorted(BasicEvent*& tail, BasicEvent* Event)
+{
+    // usually added in time order, otherwise behind the last event due no later
+    if (!tail || tail->m_execTime <= Event->m_execTime)
+    {
+        Append(tail, Event);
+        return;
+    }
+
+    BasicEvent* prev = tail;
+    while (prev->m_next->m_execTime <= Event->m_execTime)
+        prev = prev->m_next;
+
+    Event->m_next = prev->m_next;
+    prev->m_next = Event;
+}
+
+void EventProcessor::InsertNear(BasicEvent* Event)
+{
+    if (!m_near || Event->m_execTime < m_nearTime)
+        m_nearTime = Event->m_execTime;
+
+    InsertSorted(m_near, Event);
+}
+
+void EventProcessor::Cascade(BasicEvent*& tail)
+{
+    BasicEvent* events = tail;
+    tail = NULL;
+
+    while (events)
+        Insert(PopFront(events));
+}
+
+uint64 EventProcessor::GetNextCascadeTime() const
+{
+    uint64 next = m_overflow ? ((m_wheelTime >> WHEEL_SPAN_BITS) + 1) << WHEEL_SPAN_BITS : ~uint64(0);
+
+    // occupied slots all lie ahead of the wheel position within the window of their level
+    for (uint32 level = 1; level < WHEEL_LEVELS; ++level)
+    {
+        if (!m_occupied[level - 1])
+            continue;
+
+        uint32 shift = level * WHEEL_SLOT_BITS;
+        uint64 window = m_wheelTime & ~((uint64(1) << (shift + WHEEL_SLOT_BITS)) - 1);
+        next = std::min(next, window | (uint64(std::countr_zero(m_occupied[level - 1])) << shift));
+    }
+
+    return next;
+}
+
+void EventProcessor::AdvanceTo(uint64 time)
+{
+    // jump from one non empty slot to the next, every slot reached moves its events down
+    while (m_cascadeTime <= time)
+    {
+        m_wheelTime = m_cascadeTime;
+
+        if (!(m_wheelTime & ((uint64(1) << WHEEL_SPAN_BITS) - 1)))
+            Cascade(m_overflow);
+
+        for (uint32 level = WHEEL_LEVELS - 1; level > 0; --level)
+        {
+            uint32 shift = level * WHEEL_SLOT_BITS;
+            if (m_wheelTime & ((uint64(1) << shift) - 1))
+                continue;
+
+            uint64 bit = uint64(1) << (uint32(m_wheelTime >> shift) & (WHEEL_SLOTS - 1));
+            if (!(m_occupied[level - 1] & bit))
+                continue;
+
+            m_occupied[level - 1] &= ~bit;
+            Cascade(m_levels[level - 1]->slots[std::countr_zero(bit)]);
+        }
+
+        m_cascadeTime = GetNextCascadeTime();
+
+        // stop at the start of the block, its events may be due already
+        if (m_near)
+            return;
+    }
+
+    m_wheelTime = time;
+}
+
+void EventProcessor::ExecuteEvent(BasicEvent* Event, uint32 p_time)
+{
+    if (!Event->to_Abort)
+    {
+        if (Event->Execute(m_time, p_time))
+        {
+            // completely destroy event if it is not re-added
+            delete Event;
+        }
+    }
+    else
+    {
+        Event->Abort(m_time);
+        delete Event;
+    }
+}
+
 void EventProcessor::Update(uint32 p_time)
 {
     // update time
     m_time += p_time;
 
-    // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    // main event loop, events may add or kill events, so everything is looked up again after each one
+    while (true)
     {
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        if (m_late)
+        {
+            ExecuteEvent(PopFront(m_late), p_time);
+            continue;
+        }
 
-        if (!Event->to_Abort)
+        if (m_wheelTime > m_time)
+            break;
+
+        if (m_near && m_nearTime <= m_time)
         {
-            if (Event->Execute(m_time, p_time))
-            {
-                // completely destroy event if it is not re-added
-                delete Event;
-            }
+            // events added for this time while it executes line up behind the ones due now
+            BasicEvent* Event = PopFront(m_near);
+            m_wheelTime = Event->m_execTime;
+            if (m_near)
+                m_nearTime = m_near->m_next->m_execTime;
+
+            ExecuteEvent(Event, p_time);
+            continue;
         }
-        else
+
+        // nothing due before m_time in the current block, move on
+        AdvanceTo(m_time + 1);
+    }
+}
+
+BasicEvent* EventProcessor::DetachAll()
+{
+    // link everything into one list, same time events keep their order
+    BasicEvent* events = m_late;
+    m_late = NULL;
+
+    while (m_near)
+        Append(events, PopFront(m_near));
+
+    for (uint32 i = 0; i < WHEEL_LEVELS - 1; ++i)
+    {
+        for (; m_occupied[i]; m_occupied[i] &= m_occupied[i] - 1)
         {
-            Event->Abort(m_time);
-            delete Event;
+            BasicEvent*& tail = m_levels[i]->slots[std::countr_zero(m_occupied[i])];
+            while (tail)
+                Append(events, PopFront(tail));
         }
     }
+
+    while (m_overflow)
+        Append(events, PopFront(m_overflow));
+
+    m_cascadeTime = ~uint64(0);
+    return events;
 }
 
 void EventProcessor::KillAllEvents(bool force)
@@ -39,33 +260,33 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
-    {
-        EventList::iterator i_old = i;
-        ++i;
+    // wheel slots are not sorted, abort in execution order like a plain sorted queue would
+    std::vector<BasicEvent*> events;
+    for (BasicEvent* detached = DetachAll(); detached;)
+        events.push_back(PopFront(detached));
 
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
-        {
-            delete i_old->second;
+    std::stable_sort(events.begin(), events.end(), [](BasicEvent const* left, BasicEvent const* right)
+    {
+        return left->m_execTime < right->m_execTime;
+    });
 
-            if (!force)                                      // need per-element cleanup
-                m_events.erase(i_old);
-        }
+    // first, abort all existing events
+    for (BasicEvent* Event : events)
+    {
+        Event->to_Abort = true;
+        Event->Abort(m_time);
+        if (force || Event->IsDeletable())
+            delete Event;
+        else
+            Insert(Event);                              // stays queued and gets aborted again when due
     }
-
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
 {
     if (set_addtime) Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    Insert(Event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
@@ -73,3 +294,264 @@ uint64 EventProcessor::CalculateTime(uint64 t_offset) const
     return(m_time + t_offset);
 }
 
+namespace
+{
+    // the queue EventProcessor kept before the timing wheel, the reference of EventProcessor::Benchmark
+    class MultimapEventProcessor
+    {
+    public:
+        MultimapEventProcessor() : m_time(0) { }
+        ~MultimapEventProcessor() { KillAllEvents(true); }
+
+        void Update(uint32 p_time)
+        {
+            m_time += p_time;
+
+            std::multimap<uint64, BasicEvent*>::iterator i;
+            while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+            {
+                BasicEvent* Event = i->second;
+                m_events.erase(i);
+
+                if (!Event->to_Abort)
+                {
+                    if (Event->Execute(m_time, p_time))
+                        delete Event;
+                }
+                else
+                {
+                    Event->Abort(m_time);
+                    delete Event;
+                }
+            }
+        }
+
+        void KillAllEvents(bool force)
+        {
+            for (std::multimap<uint64, BasicEvent*>::iterator i = m_events.begin(); i != m_events.end();)
+            {
+                std::multimap<uint64, BasicEvent*>::iterator i_old = i;
+                ++i;
+
+                i_old->second->to_Abort = true;
+                i_old->second->Abort(m_time);
+                if (force || i_old->second->IsDeletable())
+                {
+                    delete i_old->second;
+
+                    if (!force)
+                        m_events.erase(i_old);
+                }
+            }
+
+            if (force)
+                m_events.clear();
+        }
+
+        void AddEvent(BasicEvent* Event, uint64 e_time)
+        {
+            Event->m_addTime = m_time;
+            Event->m_execTime = e_time;
+            m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+        }
+
+        uint64 CalculateTime(uint64 t_offset) const { return m_time + t_offset; }
+
+    private:
+        uint64 m_time;
+        std::multimap<uint64, BasicEvent*> m_events;
+    };
+
+    uint32 const BENCHMARK_DURATION = 30 * 1000;
+    uint32 const BENCHMARK_UPDATE = 50;
+    uint32 const EQUIVALENCE_SCENARIOS = 200;
+    uint32 const EQUIVALENCE_STEPS = 500;
+
+    // a spell hit or a delayed cast
+    class ShortTimerEvent : public BasicEvent
+    {
+    public:
+        explicit ShortTimerEvent(uint64& executed) : _executed(executed) { }
+
+        bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+        {
+            ++_executed;
+            return true;
+        }
+
+    private:
+        uint64& _executed;
+    };
+
+    // an AI or respawn check that queues itself again
+    template<class Processor>
+    class LongTimerEvent : public BasicEvent
+    {
+    public:
+        LongTimerEvent(Processor& events, std::mt19937& generator, uint64& executed) : _events(events), _generator(generator), _executed(executed) { }
+
+        bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+        {
+            ++_executed;
+            _events.AddEvent(this, _events.CalculateTime(std::uniform_int_distribution<uint32>(5000, 120000)(_generator)));
+            return false;
+        }
+
+    private:
+        Processor& _events;
+        std::mt19937& _generator;
+        uint64& _executed;
+    };
+
+    template<class Processor>
+    uint64 RunBenchmark(uint32 units, uint64& executed)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        // the same seed for both queues, they see the same timers
+        std::mt19937 generator(units);
+        std::uniform_int_distribution<uint32> shortDelay(0, 1500);
+        std::uniform_int_distribution<uint32> longDelay(5000, 120000);
+        std::uniform_int_distribution<uint32> roll(0, 99);
+        executed = 0;
+
+        Clock::time_point start = Clock::now();
+        {
+            std::unique_ptr<Processor[]> processors(new Processor[units]);
+            for (uint32 i = 0; i < units; ++i)
+                for (uint32 n = 0; n < 2; ++n)
+                    processors[i].AddEvent(new LongTimerEvent<Processor>(processors[i], generator, executed), processors[i].CalculateTime(longDelay(generator)));
+
+            for (uint32 time = 0; time < BENCHMARK_DURATION; time += BENCHMARK_UPDATE)
+            {
+                for (uint32 i = 0; i < units; ++i)
+                {
+                    if (roll(generator) < 14)
+                        processors[i].AddEvent(new ShortTimerEvent(executed), processors[i].CalculateTime(shortDelay(generator)));
+
+                    processors[i].Update(BENCHMARK_UPDATE);
+                }
+            }
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    }
+
+    // every Execute, Abort and destructor call as event id, call and time
+    struct EventTrace
+    {
+        explicit EventTrace(uint32 seed) : Generator(seed), NextId(0) { }
+
+        void Record(uint32 id, uint32 call, uint64 time)
+        {
+            Calls.push_back(id);
+            Calls.push_back(call);
+            Calls.push_back(time);
+        }
+
+        std::mt19937 Generator;
+        std::vector<uint64> Calls;
+        uint32 NextId;
+    };
+
+    uint64 RandomOffset(std::mt19937& generator)
+    {
+        switch (std::uniform_int_distribution<uint32>(0, 19)(generator))
+        {
+            case 0:
+                return 0;                                   // due in the running update
+            case 1:
+                return std::uniform_int_distribution<uint64>(uint64(1) << 30, uint64(1) << 34)(generator); // beyond the wheel
+            case 2:
+            case 3:
+                return std::uniform_int_distribution<uint64>(5000, 300000)(generator);
+            default:
+                return std::uniform_int_distribution<uint64>(0, 1500)(generator);
+        }
+    }
+
+    template<class Processor>
+    class TracedEvent : public BasicEvent
+    {
+    public:
+        TracedEvent(Processor& events, EventTrace& trace) : _events(events), _trace(trace), _id(trace.NextId++)
+        {
+            _deletable = std::uniform_int_distribution<uint32>(0, 9)(trace.Generator) != 0;
+        }
+
+        ~TracedEvent() { _trace.Record(_id, 2, 0); }
+
+        bool Execute(uint64 e_time, uint32 /*p_time*/) override
+        {
+            _trace.Record(_id, 0, e_time);
+
+            uint32 action = std::uniform_int_distribution<uint32>(0, 9)(_trace.Generator);
+            if (action < 2)
+                _events.AddEvent(new TracedEvent(_events, _trace), _events.CalculateTime(RandomOffset(_trace.Generator)));
+
+            if (action >= 7)
+            {
+                _events.AddEvent(this, _events.CalculateTime(RandomOffset(_trace.Generator)));
+                return false;
+            }
+            return true;
+        }
+
+        bool IsDeletable() const override { return _deletable; }
+
+        void Abort(uint64 e_time) override { _trace.Record(_id, 1, e_time); }
+
+    private:
+        Processor& _events;
+        EventTrace& _trace;
+        uint32 _id;
+        bool _deletable;
+    };
+
+    template<class Processor>
+    void RunScenario(uint32 seed, std::vector<uint64>& calls)
+    {
+        EventTrace trace(seed);
+        {
+            Processor events;
+            std::uniform_int_distribution<uint32> roll(0, 99);
+            for (uint32 step = 0; step < EQUIVALENCE_STEPS; ++step)
+            {
+                uint32 action = roll(trace.Generator);
+                if (action < 50)
+                    events.AddEvent(new TracedEvent<Processor>(events, trace), events.CalculateTime(RandomOffset(trace.Generator)));
+                else if (action < 55)
+                {
+                    // for a time already passed
+                    uint64 now = events.CalculateTime(0);
+                    uint64 back = std::min<uint64>(now, roll(trace.Generator) * 10);
+                    events.AddEvent(new TracedEvent<Processor>(events, trace), now - back);
+                }
+                else if (action < 57)
+                    events.KillAllEvents(action == 55);
+                else if (action < 60)
+                    events.Update(std::uniform_int_distribution<uint32>(100000, 100000000)(trace.Generator));
+                else
+                    events.Update(roll(trace.Generator));
+            }
+        }
+        calls.swap(trace.Calls);
+    }
+}
+
+void EventProcessor::Benchmark(uint32 units, EventProcessorBenchmark& result)
+{
+    result.MultimapTime = RunBenchmark<MultimapEventProcessor>(units, result.MultimapExecuted);
+    result.WheelTime = RunBenchmark<EventProcessor>(units, result.WheelExecuted);
+
+    result.Scenarios = EQUIVALENCE_SCENARIOS;
+    result.Mismatches = 0;
+    for (uint32 seed = 1; seed <= EQUIVALENCE_SCENARIOS; ++seed)
+    {
+        std::vector<uint64> expected;
+        std::vector<uint64> calls;
+        RunScenario<MultimapEventProcessor>(seed, expected);
+        RunScenario<EventProcessor>(seed, calls);
+        if (calls != expected)
+            ++result.Mismatches;
+    }
+}
@@ -410,6 +410,10 @@ bool Master::_StartDB()
 
     synchThreads = uint8(sConfigMgr->GetIntDefault("WorldDatabase.SynchThreads", 1));
 
+    // every thread loading the world at startup queries on a connection of its own
+    uint8 loadThreads = uint8(std::min(std::max(sConfigMgr->GetIntDefault("Startup.LoadThreads", 4), 1), 32));
+    synchThreads = std::max(synchThreads, loadThreads);
+
     if (_noUseConfigDatabaseInfo == false)
     {
 
@@ -448,7 +452,10 @@ bool Master::_StartDB()
         return false;
     }
 
-    synchThreads = uint8(sConfigMgr->GetIntDefault("CharacterDatabase.SynchThreads", 2));
+    synchThreads = std::max(uint8(sConfigMgr->GetIntDefault("CharacterDatabase.SynchThreads", 2)), loadThreads);
+
+    CharacterDatabase.SetBatchLimits(sConfigMgr->GetIntDefault("CharacterDatabase.BatchStatements", 64),
+        sConfigMgr->GetIntDefault("CharacterDatabase.BatchWindow", 0));
 
     if (_noUseConfigDatabaseInfo == false)
     {